@@ -457,7 +457,7 @@ void print_help(char *argv[])
     printf("Usage: %s [REQ FLAGS] [OPT FLAGS]\n", argv[0]);
     printf("\n\tREQUIRED\n");
     printf("\t-t, --type\t\tChannel type: PT2PT or RMA\n");
-    printf("\t-c, --capacity\t\tChannel capacity: 0 for synchronous, 1 or greater for buffered channel\n");
+    printf("\t-c, --capacity\t\tChannel capacity: 0 for synchronous, 1 or greater for buffered, negative for unbounded channel\n");
     printf("\t-p, --producers\t\tNumber of producers; must be at least 1\n");
     printf("\t-r, --receivers\t\tNumber of consumers; must be least 1\n");
     printf("\t-n, --msg_num\t\tMaximum number of messages\n");
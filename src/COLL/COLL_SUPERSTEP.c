@@ -0,0 +1,317 @@
+/**
+ * @file COLL_SUPERSTEP.c
+ * @author Toni Hollfelder (Toni.Hollfelder@uni-bayreuth.de)
+ * @brief Implementation of COLL SUPERSTEP Channel
+ * @version 1.0
+ * @date 2021-05-27
+ * @copyright CC BY 4.0 (https://creativecommons.org/licenses/by/4.0/)
+ *
+ */
+
+#include "COLL_SUPERSTEP.h"
+
+MPI_Channel *channel_alloc_coll_superstep(MPI_Channel *ch)
+{
+    // Store internal channel type
+    ch->chan_type = ch->receiver_count > 1 ? MPMC : ch->sender_count > 1 ? MPSC : SPSC;
+
+    // Elements are staged until the next flush instead of using overflow segments; the capacity is the initial number
+    // of elements of each region
+    ch->unbounded = 0;
+    ch->stage_cap = ch->capacity > 0 ? ch->capacity : 1;
+    ch->batch_len = ch->batch_pos = 0;
+
+    // Start round robin with the first receiver
+    ch->idx_last_rank = 0;
+
+    // Sender stages elements in one region per receiver, receiver stores the number of elements of every sender
+    int peers = ch->is_receiver ? ch->sender_count : ch->receiver_count;
+    ch->stage = ch->is_receiver ? NULL : malloc((size_t) peers * ch->stage_cap * ch->data_size);
+    ch->stage_counts = calloc(peers, sizeof(*ch->stage_counts));
+    ch->stage_displs = malloc(peers * sizeof(*ch->stage_displs));
+    if (ch->is_receiver)
+        ch->stage_cap = 0;
+
+    if ((!ch->is_receiver && !ch->stage) || !ch->stage_counts || !ch->stage_displs)
+    {
+        ERROR("Error in malloc(): Memory for staging elements could not be allocated\n");
+        free(ch->stage);
+        free(ch->stage_counts);
+        free(ch->stage_displs);
+        free(ch->receiver_ranks);
+        free(ch->sender_ranks);
+        free(ch->weights);
+        free(ch->deficits);
+        channel_alloc_assert_success(ch->comm, 1);
+        free(ch);
+        return NULL;
+    }
+
+    // Elements are exchanged as contiguous blocks of data_size bytes
+    if (MPI_Type_contiguous((int) ch->data_size, MPI_BYTE, &ch->elem_type) != MPI_SUCCESS || 
+    MPI_Type_commit(&ch->elem_type) != MPI_SUCCESS)
+    {
+        ERROR("Error in MPI_Type_contiguous()\n");
+        free(ch->stage);
+        free(ch->stage_counts);
+        free(ch->stage_displs);
+        free(ch->receiver_ranks);
+        free(ch->sender_ranks);
+        free(ch->weights);
+        free(ch->deficits);
+        channel_alloc_assert_success(ch->comm, 1);
+        free(ch);
+        return NULL;
+    }
+
+    // Create backup in case of failing MPI_Dist_graph_create_adjacent
+    MPI_Comm comm = ch->comm;
+
+    // Create graph comm with an edge from every sender to every receiver and store it; it is used as unique
+    // communicator context within the channel like the shadow comm of the other channels
+    // Every edge carries traffic of unknown volume, so the graph is unweighted
+    // GCC takes the sentinel MPI_UNWEIGHTED of some MPI implementations for an array it reads from
+#if defined(__GNUC__) && !defined(__clang__) && __GNUC__ >= 11
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wstringop-overread"
+#endif
+    int graph_error = MPI_Dist_graph_create_adjacent(ch->comm, ch->is_receiver ? ch->sender_count : 0, 
+    ch->sender_ranks, MPI_UNWEIGHTED, ch->is_receiver ? 0 : ch->receiver_count, ch->receiver_ranks, MPI_UNWEIGHTED, 
+    ch->info, 0, &ch->comm);
+#if defined(__GNUC__) && !defined(__clang__) && __GNUC__ >= 11
+#pragma GCC diagnostic pop
+#endif
+
+    if (graph_error != MPI_SUCCESS)
+    {
+        ERROR("Error in MPI_Dist_graph_create_adjacent(): Fatal Error\n");
+        MPI_Type_free(&ch->elem_type);
+        free(ch->stage);
+        free(ch->stage_counts);
+        free(ch->stage_displs);
+        free(ch->receiver_ranks);
+        free(ch->sender_ranks);
+        free(ch->weights);
+        free(ch->deficits);
+        channel_alloc_assert_success(comm, 1);
+        free(ch);
+        return NULL;
+    }
+
+    // Final call to assure that every process was successfull
+    // Use initial communicator since graph communicater has a new context
+    if (channel_alloc_assert_success(comm, 0) != 1)
+    {
+        ERROR("Error in finalizing channel allocation: At least one process failed\n");
+        MPI_Type_free(&ch->elem_type);
+        MPI_Comm_free(&ch->comm);
+        free(ch->stage);
+        free(ch->stage_counts);
+        free(ch->stage_displs);
+        free(ch->receiver_ranks);
+        free(ch->sender_ranks);
+        free(ch->weights);
+        free(ch->deficits);
+        free(ch);
+        return NULL;
+    }
+
+    DEBUG("COLL SUPERSTEP finished allocation\n");
+
+    return ch;
+}
+
+// Doubles the regions of the staging buffer of a sender
+static int grow_coll_superstep(MPI_Channel *ch)
+{
+    int new_cap = 2 * ch->stage_cap;
+
+    char *stage = realloc(ch->stage, (size_t) ch->receiver_count * new_cap * ch->data_size);
+    if (!stage)
+    {
+        ERROR("Error in realloc(): Staging buffer could not be enlarged\n");
+        return -1;
+    }
+
+    // Move regions to their new displacement starting with the last one; a region only moves upwards so regions
+    // below it have not been moved yet
+    for (int i = ch->receiver_count - 1; i > 0; i--)
+        memmove(stage + (size_t) i * new_cap * ch->data_size, stage + (size_t) i * ch->stage_cap * ch->data_size, 
+        (size_t) ch->stage_counts[i] * ch->data_size);
+
+    ch->stage = stage;
+    ch->stage_cap = new_cap;
+
+    return 1;
+}
+
+int channel_send_coll_superstep(MPI_Channel *ch, void *data)
+{
+    // Receiver of the element
+    int dest = ch->idx_last_rank;
+
+    // Enlarge the regions if the region of the receiver is full
+    if (ch->stage_counts[dest] == ch->stage_cap && grow_coll_superstep(ch) == -1)
+        return -1;
+
+    // Append element to the region of the receiver
+    memcpy(ch->stage + ((size_t) dest * ch->stage_cap + ch->stage_counts[dest]) * ch->data_size, data, ch->data_size);
+    ch->stage_counts[dest]++;
+
+    // Next element is staged for the next receiver
+    ch->idx_last_rank = dest + 1 < ch->receiver_count ? dest + 1 : 0;
+
+    return 1;
+}
+
+int channel_receive_coll_superstep(MPI_Channel *ch, void *data)
+{
+    // Receiving cannot wait for elements since they are only delivered by a flush of every process
+    if (ch->batch_pos == ch->batch_len)
+    {
+        WARNING("Every element of the superstep has been received; call channel_flush_superstep() first\n");
+        return -1;
+    }
+
+    // Copy next element of the batch to data buffer
+    memcpy(data, ch->stage + (size_t) ch->batch_pos++ * ch->data_size, ch->data_size);
+
+    // Empty batch starts at the beginning again
+    if (ch->batch_pos == ch->batch_len)
+        ch->batch_pos = ch->batch_len = 0;
+
+    return 1;
+}
+
+int channel_peek_coll_superstep(MPI_Channel *ch)
+{
+    if (ch->is_receiver)
+        return ch->batch_len - ch->batch_pos;
+
+    // Count free slots of every region
+    int free_slots = 0;
+    for (int i = 0; i < ch->receiver_count; i++)
+        free_slots += ch->stage_cap - ch->stage_counts[i];
+
+    return free_slots;
+}
+
+int channel_flush_coll_superstep(MPI_Channel *ch)
+{
+    // Used to exchange the elements nonblocking
+    MPI_Request req;
+
+    // Number of elements per receiver; a receiver sends nothing
+    int *sendcounts = ch->is_receiver ? NULL : ch->stage_counts;
+
+    // Number of elements per sender; a sender receives nothing
+    int *recvcounts = ch->is_receiver ? ch->stage_counts : NULL;
+
+    // Exchange number of staged elements of every sender per receiver
+    if (MPI_Neighbor_alltoall(sendcounts, 1, MPI_INT, recvcounts, 1, MPI_INT, ch->comm) != MPI_SUCCESS)
+    {
+        ERROR("Error in MPI_Neighbor_alltoall()\n");
+        return -1;
+    }
+
+    // Number of elements sent or delivered
+    int total = 0;
+
+    if (ch->is_receiver)
+    {
+        // Delivered elements are appended to the elements which have not been received yet
+        int left = ch->batch_len - ch->batch_pos;
+        for (int i = 0; i < ch->sender_count; i++)
+        {
+            ch->stage_displs[i] = left + total;
+            total += ch->stage_counts[i];
+        }
+
+        // Enlarge the batch if needed
+        if (left + total > ch->stage_cap)
+        {
+            char *batch = realloc(ch->stage, (size_t) (left + total) * ch->data_size);
+            if (!batch)
+            {
+                ERROR("Error in realloc(): Batch could not be enlarged\n");
+                return -1;
+            }
+            ch->stage = batch;
+            ch->stage_cap = left + total;
+        }
+
+        // Move elements which have not been received yet to the beginning of the batch
+        memmove(ch->stage, ch->stage + (size_t) ch->batch_pos * ch->data_size, (size_t) left * ch->data_size);
+        ch->batch_pos = 0;
+        ch->batch_len = left + total;
+
+        // Receive staged elements of every sender
+        if (MPI_Ineighbor_alltoallv(NULL, NULL, NULL, ch->elem_type, ch->stage, ch->stage_counts, ch->stage_displs, 
+        ch->elem_type, ch->comm, &req) != MPI_SUCCESS)
+        {
+            ERROR("Error in MPI_Ineighbor_alltoallv()\n");
+            return -1;
+        }
+    }
+    else
+    {
+        // Every region is sent directly from the staging buffer
+        for (int i = 0; i < ch->receiver_count; i++)
+        {
+            ch->stage_displs[i] = i * ch->stage_cap;
+            total += ch->stage_counts[i];
+        }
+
+        // Send staged elements to every receiver
+        if (MPI_Ineighbor_alltoallv(ch->stage, ch->stage_counts, ch->stage_displs, ch->elem_type, NULL, NULL, NULL, 
+        ch->elem_type, ch->comm, &req) != MPI_SUCCESS)
+        {
+            ERROR("Error in MPI_Ineighbor_alltoallv()\n");
+            return -1;
+        }
+    }
+
+    // Wait for completion of the exchange
+    if (MPI_Wait(&req, MPI_STATUS_IGNORE) != MPI_SUCCESS)
+    {
+        ERROR("Error in MPI_Wait(): Exchange of staged elements could not be completed\n");
+        return -1;
+    }
+
+    // Every region of the sender is empty again
+    if (!ch->is_receiver)
+        memset(ch->stage_counts, 0, ch->receiver_count * sizeof(*ch->stage_counts));
+
+    return total;
+}
+
+int channel_free_coll_superstep(MPI_Channel *ch)
+{
+    // Staged elements are lost without another flush
+    if (!ch->is_receiver && channel_peek_coll_superstep(ch) != ch->receiver_count * ch->stage_cap)
+    {
+        WARNING("Staged elements have not been flushed and are discarded\n");
+    }
+
+    // Free allocated memory used for storing ranks, weights and staged elements
+    free(ch->receiver_ranks);
+    free(ch->sender_ranks);
+    free(ch->weights);
+    free(ch->deficits);
+    free(ch->stage);
+    free(ch->stage_counts);
+    free(ch->stage_displs);
+
+    // Frees element datatype
+    MPI_Type_free(&ch->elem_type);
+
+    // Frees graph communicator
+    // Should be nothrow since graph comm creation was successful
+    MPI_Comm_free(&ch->comm);
+
+    // Free the allocated memory ch points to
+    free(ch);
+    ch = NULL;
+
+    return 1;
+}
@@ -0,0 +1,85 @@
+/**
+ * @file COLL_SUPERSTEP.h
+ * @author Toni Hollfelder (Toni.Hollfelder@uni-bayreuth.de)
+ * @brief Header of COLL SUPERSTEP Channel
+ * @version 1.0
+ * @date 2021-05-27
+ * @copyright CC BY 4.0 (https://creativecommons.org/licenses/by/4.0/)
+ *
+ * This COLL SUPERSTEP channel implementation is meant for bulk-synchronous codes which send many elements per
+ * superstep. Instead of transferring every element on its own, channel_send_coll_superstep() only stages the element
+ * locally and channel_flush_coll_superstep() exchanges every staged element at once. The elements of a sender are
+ * distributed over the receivers by round robin.
+ *
+ * The channel communicator is a distributed graph topology with an edge from every sender to every receiver. A flush
+ * exchanges the number of staged elements per receiver with MPI_Neighbor_alltoall() and the elements themselves with
+ * MPI_Ineighbor_alltoallv(), so no acknowledgement messages, window operations or buffer capacity checks are needed.
+ *
+ * Layout of the staging buffer of a sender:
+ * Sender:      | REGION_0 | ... | REGION_N |     where REGION_i stores up to stage_cap elements for receiver i
+ * The regions are sent directly from the staging buffer and are doubled once a region is full.
+ *
+ * The receiver appends the elements delivered by a flush to the elements of its batch it has not yet received.
+ * Elements of a sender to a receiver keep their order; elements of different senders are ordered by sender rank.
+ */
+
+#ifndef COLL_SUPERSTEP_H
+#define COLL_SUPERSTEP_H
+
+#include "../MPI_Channel_Struct.h"
+
+/**
+ * @brief Updates the properties of a passed MPI_Channel of type COLL SUPERSTEP and returns it.
+ * @param[in, out] ch Pointer to a MPI_Channel allocated with channel_alloc().
+ * @return Returns a pointer to a valid MPI_Channel with updated properties if updating was successful and NULL otherwise
+ * @note Returns NULL if MPI related functions or allocation memory failure happend.
+ */
+MPI_Channel *channel_alloc_coll_superstep(MPI_Channel *ch);
+
+/**
+ * @brief Stages the numbers of bytes of a data element specified in channel_alloc() starting at the adress the void
+ * pointer holds for the next receiver. Calling channel_send_coll_superstep() never blocks.
+ * @param[in] ch Pointer to a MPI_Channel of type COLL SUPERSTEP
+ * @param[in] data Pointer to a memory adress of which size bytes will be staged from
+ * @return Returns 1 if staging was successful, -1 otherwise
+ * @note Returns -1 if the staging buffer could not be enlarged
+ */
+int channel_send_coll_superstep(MPI_Channel *ch, void *data);
+
+/**
+ * @brief Receives the next element of the batch delivered by the last flush. Calling channel_receive_coll_superstep()
+ * never blocks.
+ * @param[in] ch Pointer to a MPI_Channel of type COLL SUPERSTEP
+ * @param[in] data Pointer to a memory adress of which size bytes will be received to
+ * @return Returns 1 if receiving was successful, -1 otherwise
+ * @note Returns -1 if every element of the batch has already been received
+ */
+int channel_receive_coll_superstep(MPI_Channel *ch, void *data);
+
+/**
+ * @brief Peeks at the channel and signals how many elements can be staged (sender process calls) or received
+ * (receiver process calls).
+ * @param[in] ch Pointer to a MPI_Channel of type COLL SUPERSTEP
+ * @return Returns the number of elements which can be staged before the staging buffer grows if the sender process
+ * calls and the number of elements left in the batch if the receiver process calls
+ */
+int channel_peek_coll_superstep(MPI_Channel *ch);
+
+/**
+ * @brief Exchanges every staged element between the senders and receivers of the channel. Every process of the
+ * channel needs to call channel_flush_coll_superstep().
+ * @param[in] ch Pointer to a MPI_Channel of type COLL SUPERSTEP
+ * @return Returns the number of elements sent (sender process calls) or delivered (receiver process calls) and -1 if
+ * an error occured
+ * @note Returns -1 if internal problems with MPI related functions or memory allocation happend
+ */
+int channel_flush_coll_superstep(MPI_Channel *ch);
+
+/**
+ * @brief Deallocates the channel and all allocated members. Elements which have not been flushed are discarded.
+ * @param[in] ch Pointer to a MPI_Channel of type COLL SUPERSTEP
+ * @return Returns 1 since deallocation is always successfull
+ */
+int channel_free_coll_superstep(MPI_Channel *ch);
+
+#endif // COLL_SUPERSTEP_H
@@ -8,8 +8,11 @@
  * 
  */
 
+#include <pthread.h>
+#include <sched.h> /* sched_yield */
 #include <stdio.h>
 #include <string.h>
+#include <time.h> /* nanosleep */
 
 #include "MPI_Channel.h"
 #include "MPI_Channel_Struct.h"
@@ -22,26 +25,197 @@
 
 #include "PT2PT/MPSC/PT2PT_MPSC_SYNC.h"
 #include "PT2PT/MPSC/PT2PT_MPSC_BUF.h"
+#include "PT2PT/MPSC/PT2PT_MPSC_REDUCE.h"
 
 #include "PT2PT/MPMC/PT2PT_MPMC_SYNC.h"
+#include "PT2PT/MPMC/PT2PT_MPMC_SYNC_MATCH.h"
 #include "PT2PT/MPMC/PT2PT_MPMC_BUF.h"
+#include "PT2PT/MPMC/PT2PT_MPMC_BUF_PULL.h"
 
 #include "RMA/SPSC/RMA_SPSC_BUF.h"
 #include "RMA/SPSC/RMA_SPSC_SYNC.h"
 
 #include "RMA/MPSC/RMA_MPSC_BUF.h"
+#include "RMA/MPSC/RMA_MPSC_BUF_DRR.h"
 #include "RMA/MPSC/RMA_MPSC_SYNC.h"
+#include "RMA/MPSC/RMA_MPSC_REDUCE.h"
 
 #include "RMA/MPMC/RMA_MPMC_BUF.h"
 #include "RMA/MPMC/RMA_MPMC_SYNC.h"
 
+#include "COLL/COLL_SUPERSTEP.h"
+
+#include "THREADS/SPSC/THREADS_SPSC_BUF.h"
+#include "THREADS/MPSC/THREADS_MPSC_BUF.h"
+#include "THREADS/MPMC/THREADS_MPMC_BUF.h"
+
+// ****************************
+// PROGRESS THREAD
+// ****************************
+
+/**
+ * @brief States of a channel passed to channel_ifree(). Channels are drained, synchronized with a barrier and released
+ * in the order of the channel_ifree() calls; channels which could not be drained are not released.
+ */
+typedef enum MPI_Channel_teardown_state {
+    DRAIN, SYNC, RELEASE, FAILED
+} MPI_Channel_teardown_state;
+
+/**
+ * @brief Channel which is freed by the progress thread after channel_ifree().
+ */
+typedef struct MPI_Channel_teardown {
+    MPI_Channel                 *ch;        /** Freed channel */
+    MPI_Request                 request;    /** Generalized request completed once the channel has been freed */
+    MPI_Request                 barrier;    /** Barrier which completes once every process of the channel is drained */
+    MPI_Channel_teardown_state  state;      /** State of the deallocation */
+    int                         *error;     /** Error flag reported by the generalized request */
+} MPI_Channel_teardown;
+
+/**
+ * @brief Channels polled and freed by the progress thread of the process. The lists are guarded by lock; the progress
+ * thread returns once both lists are empty.
+ */
+static struct {
+    pthread_mutex_t         lock;           /** Held while the lists are accessed */
+    int                     running;        /** Flag which signals that the progress thread has been started */
+    MPI_Channel             **channels;     /** Polled channels */
+    int                     count;          /** Number of polled channels */
+    int                     size;           /** Number of channels the list can hold */
+    MPI_Channel_teardown    *teardowns;     /** Channels freed with channel_ifree() in the order of the calls */
+    int                     pending;        /** Number of channels which are freed */
+    int                     teardown_size;  /** Number of freed channels the list can hold */
+} progress = {.lock = PTHREAD_MUTEX_INITIALIZER};
+
 // ****************************
 // CHANNEL API
 // ****************************
 
 int channel_peek_unsupported();
+int channel_send_unbounded(MPI_Channel *ch, void *data);
+int channel_flush_unbounded(MPI_Channel *ch);
+int channel_drain_unbounded(MPI_Channel *ch);
+int channel_send_prio_lowest(MPI_Channel *ch, void *data);
+int channel_tryreceive_level(MPI_Channel *ch, void *data);
+int channel_receive_prio(MPI_Channel *ch, void *data);
+int channel_peek_prio(MPI_Channel *ch);
+int channel_free_prio(MPI_Channel *ch);
+MPI_Channel *channel_alloc_internal(size_t size, int capacity, int weight, int quota, MPI_Op op, MPI_Datatype datatype,
+MPI_Communication_type comm_type, MPI_Comm comm, int is_receiver, MPI_Info info);
+int channel_combine(MPI_Channel *ch, int (*fn)(MPI_Channel*, void*), void *data);
+int channel_send_local(MPI_Channel *ch, void *data);
+int channel_peek_local(MPI_Channel *ch, void *data);
+int channel_flush_superstep_local(MPI_Channel *ch, void *data);
+int channel_progress_start();
+void *channel_progress_run(void *arg);
+int channel_progress_remove(MPI_Channel *ch);
+void channel_progress_teardown();
+int channel_ifree_drain(MPI_Channel *ch);
+int channel_ifree_query(void *extra_state, MPI_Status *status);
+int channel_ifree_release(void *extra_state);
+int channel_ifree_cancel(void *extra_state, int complete);
 
 MPI_Channel *channel_alloc(size_t size, int capacity, MPI_Communication_type comm_type, MPI_Comm comm, int is_receiver)
+{
+    return channel_alloc_internal(size, capacity, 1, 0, MPI_OP_NULL, MPI_DATATYPE_NULL, comm_type, comm, is_receiver, 
+    MPI_INFO_NULL);
+}
+
+MPI_Channel *channel_alloc_weighted(size_t size, int capacity, int weight, int quota, MPI_Communication_type comm_type, 
+MPI_Comm comm, int is_receiver)
+{
+    return channel_alloc_internal(size, capacity, weight, quota, MPI_OP_NULL, MPI_DATATYPE_NULL, comm_type, comm, 
+    is_receiver, MPI_INFO_NULL);
+}
+
+MPI_Channel *channel_alloc_info(size_t size, int capacity, MPI_Communication_type comm_type, MPI_Comm comm, 
+int is_receiver, MPI_Info info)
+{
+    // Check if MPI has been initialized, nothrow
+    int flag;
+    MPI_Initialized(&flag);
+
+    if (!flag) {
+        ERROR("MPI has not been initialized\n");
+        return NULL;
+    }
+
+    // The channel keeps a copy of the hints until it is freed
+    MPI_Info hints = MPI_INFO_NULL;
+    if (info != MPI_INFO_NULL && MPI_Info_dup(info, &hints) != MPI_SUCCESS)
+    {
+        ERROR("Error in MPI_Info_dup(): Info object might be invalid\n");
+        hints = MPI_INFO_NULL;
+    }
+
+    MPI_Channel *ch = channel_alloc_internal(size, capacity, 1, 0, MPI_OP_NULL, MPI_DATATYPE_NULL, comm_type, comm, 
+    is_receiver, hints);
+
+    // Release the copy if the allocation failed
+    if (ch == NULL && hints != MPI_INFO_NULL)
+        MPI_Info_free(&hints);
+
+    return ch;
+}
+
+MPI_Channel *channel_alloc_reduce(int count, MPI_Datatype datatype, MPI_Op op, int capacity, 
+MPI_Communication_type comm_type, MPI_Comm comm, int is_receiver)
+{
+    // Check if MPI has been initialized, nothrow
+    int flag;
+    MPI_Initialized(&flag);
+
+    if (!flag) {
+        ERROR("MPI has not been initialized\n");
+        return NULL;
+    }
+
+    // Used to store if the parameters of the calling process are invalid
+    int invalid = 0;
+
+    // Size of a data element; the datatype needs to be valid on every process
+    int type_size = 0;
+    if (count < 1 || capacity < 1 || op == MPI_OP_NULL || datatype == MPI_DATATYPE_NULL || comm_type >= COLL ||
+    MPI_Type_size(datatype, &type_size) != MPI_SUCCESS || type_size == 0)
+    {
+        ERROR("Reduction channels need a positive count and capacity, an operation, a datatype and PT2PT or RMA\n");
+        invalid = 1;
+    }
+
+    // Elements are stored and accumulated count * type_size bytes apart, so the datatype needs to be contiguous
+    MPI_Aint lb, extent, true_lb, true_extent;
+    if (!invalid && (MPI_Type_get_extent(datatype, &lb, &extent) != MPI_SUCCESS || 
+    MPI_Type_get_true_extent(datatype, &true_lb, &true_extent) != MPI_SUCCESS || lb != 0 || true_lb != 0 || 
+    extent != type_size || true_extent != type_size))
+    {
+        ERROR("Reduction channels need a contiguous datatype\n");
+        invalid = 1;
+    }
+
+    // MPI_Accumulate() only supports predefined operations
+    if (comm_type == RMA && op != MPI_SUM && op != MPI_PROD && op != MPI_MAX && op != MPI_MIN && op != MPI_LAND && 
+    op != MPI_LOR && op != MPI_LXOR && op != MPI_BAND && op != MPI_BOR && op != MPI_BXOR && op != MPI_MAXLOC && 
+    op != MPI_MINLOC)
+    {
+        ERROR("RMA reduction channels only support predefined operations\n");
+        invalid = 1;
+    }
+
+    // Every process needs to agree on the validation before the allocation starts its own collective calls
+    if (channel_alloc_assert_success(comm, invalid) != 1)
+    {
+        ERROR("Invalid parameters for reduction channel: At least one process failed\n");
+        return NULL;
+    }
+
+    return channel_alloc_internal((size_t) count * type_size, capacity, 1, 0, op, datatype, comm_type, comm, 
+    is_receiver, MPI_INFO_NULL);
+}
+
+// Allocates every kind of channel; a reduction channel is requested by passing an operation other than MPI_OP_NULL
+// The channel takes ownership of the passed info object once the allocation was successful
+MPI_Channel *channel_alloc_internal(size_t size, int capacity, int weight, int quota, MPI_Op op, MPI_Datatype datatype,
+MPI_Communication_type comm_type, MPI_Comm comm, int is_receiver, MPI_Info info)
 {
     // Check if MPI has been initialized, nothrow
     int flag;
@@ -52,6 +226,14 @@ MPI_Channel *channel_alloc(size_t size, int capacity, MPI_Communication_type com
         return NULL;
     }
 
+    // Channels between threads do not span processes
+    if (comm_type == THREADS)
+    {
+        ERROR("Channels between threads need to be allocated with channel_alloc_threads()\n");
+        channel_alloc_assert_success(comm, 1);
+        return NULL;
+    }
+
     // Allocate memory for MPI_Channel
     MPI_Channel *ch;
     if ((ch = malloc(sizeof(*ch))) == NULL)
@@ -70,21 +252,23 @@ MPI_Channel *channel_alloc(size_t size, int capacity, MPI_Communication_type com
         return NULL;
     }
 
-    // Allocate memory for storing receiver and sender ranks
+    // Allocate memory for storing receiver and sender ranks and the weights of the senders
     ch->receiver_ranks = malloc(ch->comm_size * sizeof(*ch->receiver_ranks));
     ch->sender_ranks = malloc(ch->comm_size * sizeof(*ch->sender_ranks));
-    if (!ch->receiver_ranks || !ch->sender_ranks) 
+    ch->weights = malloc(ch->comm_size * sizeof(*ch->weights));
+    if (!ch->receiver_ranks || !ch->sender_ranks || !ch->weights) 
     {
         ERROR("Error in malloc(): Memory for storing receiver/sender ranks could not be allocated\n");
         free(ch->receiver_ranks);
         free(ch->sender_ranks);
+        free(ch->weights);
         free(ch);
         channel_alloc_assert_success(comm, 1);
         return NULL;
     }
 
-    // Will be used to do the next two MPI calls nonblocking
-    MPI_Request reqs[2];
+    // Will be used to do the next four MPI calls nonblocking
+    MPI_Request reqs[4];
 
     // Every process needs to know which process is sender or receiver
     if (MPI_Iallgather(&is_receiver, 1, MPI_INT, ch->receiver_ranks, 1, MPI_INT, comm, reqs) != MPI_SUCCESS)
@@ -92,25 +276,83 @@ MPI_Channel *channel_alloc(size_t size, int capacity, MPI_Communication_type com
         ERROR("Error in MPI_Allgather()\n");
         free(ch->receiver_ranks);
         free(ch->sender_ranks);
+        free(ch->weights);
         free(ch);
         channel_alloc_assert_success(comm, 1);
         return NULL;
     }
 
-    // Assert that every process has the same data size and capacity; to do this we reduce size and capacity with a
-    // bitwise AND operation
-    int s_size_cap_arr[2] = {(int) size, capacity}, r_size_cap_arr[2];
-    if (MPI_Iallreduce(&s_size_cap_arr, &r_size_cap_arr, 2, MPI_INT, MPI_BAND, comm, reqs+1) != MPI_SUCCESS) 
+    // Store hints; elements of different senders keep their order unless mpi_channel_fifo is false, credits are 
+    // returned with messages unless mpi_channel_credits is rma, MPMC SYNC processes are paired by a matchmaker if
+    // mpi_channel_sync is matchmaker and MPMC BUF receivers demand elements if mpi_channel_distribution is pull
+    ch->info = info;
+    ch->fifo = 1;
+    ch->rma_credits = 0;
+    ch->matchmaker = 0;
+    ch->pull = 0;
+    if (info != MPI_INFO_NULL)
+    {
+        char value[16];
+        if (MPI_Info_get(info, "mpi_channel_fifo", sizeof(value) - 1, value, &flag) == MPI_SUCCESS && flag && 
+        strcmp(value, "false") == 0)
+            ch->fifo = 0;
+        if (MPI_Info_get(info, "mpi_channel_credits", sizeof(value) - 1, value, &flag) == MPI_SUCCESS && flag && 
+        strcmp(value, "rma") == 0)
+            ch->rma_credits = 1;
+        if (MPI_Info_get(info, "mpi_channel_sync", sizeof(value) - 1, value, &flag) == MPI_SUCCESS && flag && 
+        strcmp(value, "matchmaker") == 0)
+            ch->matchmaker = 1;
+        if (MPI_Info_get(info, "mpi_channel_distribution", sizeof(value) - 1, value, &flag) == MPI_SUCCESS && flag && 
+        strcmp(value, "pull") == 0)
+            ch->pull = 1;
+    }
+
+    // The hints choose the implementation, so every process needs to pass the same ones
+    int hint_bits = (!ch->fifo) | ch->rma_credits << 1 | ch->matchmaker << 2 | ch->pull << 3;
+
+    // Assert that every process has the same data size, capacity and hints; to do this we reduce them and their
+    // complements with a bitwise AND operation, every bit is set in exactly one of both results if all processes agree
+    int s_size_cap_arr[6] = {(int) size, capacity, hint_bits, ~(int) size, ~capacity, ~hint_bits}, r_size_cap_arr[6];
+    if (MPI_Iallreduce(&s_size_cap_arr, &r_size_cap_arr, 6, MPI_INT, MPI_BAND, comm, reqs+1) != MPI_SUCCESS) 
     {
         ERROR("Error in MPI_Allreduce()\n");
         free(ch->receiver_ranks);
         free(ch->sender_ranks);
+        free(ch->weights);
         free(ch);
         MPI_Wait(reqs, MPI_STATUS_IGNORE);  /* Wait for completion of previous nonblocking call */
         channel_alloc_assert_success(comm, 1);
         return NULL;
     }
 
+    // Every process needs to know the weight of each sender to choose the same implementation
+    if (MPI_Iallgather(&weight, 1, MPI_INT, ch->weights, 1, MPI_INT, comm, reqs+2) != MPI_SUCCESS)
+    {
+        ERROR("Error in MPI_Allgather()\n");
+        free(ch->receiver_ranks);
+        free(ch->sender_ranks);
+        free(ch->weights);
+        free(ch);
+        MPI_Waitall(2, reqs, MPI_STATUSES_IGNORE);  /* Wait for completion of previous nonblocking calls */
+        channel_alloc_assert_success(comm, 1);
+        return NULL;
+    }
+
+    // Receivers hold credits back only as long as every sender can still send, so they need the smallest quota
+    int abs_capacity = capacity < 0 ? -capacity : capacity;
+    int s_quota = !is_receiver && quota > 0 && quota < abs_capacity ? quota : abs_capacity;
+    if (MPI_Iallreduce(&s_quota, &ch->min_quota, 1, MPI_INT, MPI_MIN, comm, reqs+3) != MPI_SUCCESS)
+    {
+        ERROR("Error in MPI_Allreduce()\n");
+        free(ch->receiver_ranks);
+        free(ch->sender_ranks);
+        free(ch->weights);
+        free(ch);
+        MPI_Waitall(3, reqs, MPI_STATUSES_IGNORE);  /* Wait for completion of previous nonblocking calls */
+        channel_alloc_assert_success(comm, 1);
+        return NULL;
+    }
+
     // Do local stuff here until the nonblocking operations have finished
     // Update is_receiver flag
     ch->is_receiver = is_receiver;
@@ -124,8 +366,40 @@ MPI_Channel *channel_alloc(size_t size, int capacity, MPI_Communication_type com
     // Store size of data
     ch->data_size = size;
 
-    // Store capacity of channel
-    ch->capacity = capacity;
+    // Store capacity of channel; a negative capacity requests an unbounded channel which stages elements in overflow
+    // segments of the absolute capacity instead of blocking
+    ch->unbounded = capacity < 0;
+    ch->capacity = ch->unbounded ? -capacity : capacity;
+
+    // No element is staged yet
+    ch->staged_items = 0;
+    ch->seg_head = ch->seg_tail = ch->seg_spare = NULL;
+    ch->spill = NULL;
+    ch->spill_limit = 0;
+    ch->ptr_channel_trysend = NULL;
+    ch->ptr_channel_tryreceive = NULL;
+    ch->ptr_channel_drain = NULL;
+
+    // Channels are used by a single thread unless channel_set_thread_safe() is called
+    ch->ts = NULL;
+    ch->progress = 0;
+    ch->ring = NULL;
+
+    // Channel without priority levels
+    ch->levels = 1;
+    ch->level_ch = NULL;
+
+    // Elements of a reduction channel consist of size / type size elements of the datatype
+    ch->reduce_op = op;
+    ch->reduce_type = datatype;
+    ch->reduce_count = 0;
+    if (op != MPI_OP_NULL)
+    {
+        int type_size;
+        MPI_Type_size(datatype, &type_size);
+        ch->reduce_count = (int) size / type_size;
+    }
+    ch->epoch = ch->consumed = 0;
 
     // Store comm
     ch->comm = comm;
@@ -133,28 +407,53 @@ MPI_Channel *channel_alloc(size_t size, int capacity, MPI_Communication_type com
     // Store comm type
     ch->comm_type = comm_type;
 
+    // Limit the number of outstanding elements of a sender to the quota; without quota it is the capacity
+    ch->quota = quota > 0 && quota < ch->capacity ? quota : ch->capacity;
+
     // Wait for completion of nonblocking operations; should be nothrow
-    MPI_Waitall(2, reqs, MPI_STATUSES_IGNORE);
+    MPI_Waitall(4, reqs, MPI_STATUSES_IGNORE);
 
-    // Check for coinciding parameters size and capacity
-    if ((r_size_cap_arr[0] != (int) size) || (r_size_cap_arr[1] != capacity)) 
+    // Check for coinciding parameters size, capacity and hints; every process comes to the same result
+    if ((r_size_cap_arr[0] | r_size_cap_arr[3]) != ~0 || (r_size_cap_arr[1] | r_size_cap_arr[4]) != ~0 || 
+    (r_size_cap_arr[2] | r_size_cap_arr[5]) != ~0) 
     {
-        ERROR("Every process needs the same data size and capacity as parameters\n");
+        ERROR("Every process needs the same data size, capacity and channel hints as parameters\n");
         free(ch->receiver_ranks);
         free(ch->sender_ranks);
+        free(ch->weights);
         free(ch);
         channel_alloc_assert_success(comm, 1);
         return NULL;         
     }
 
     // Update array of receiver and sender ranks; receiver_ranks was also used as recvbuf in the previous function call
-    int recv = 0, send = 0;
+    // The weights of the senders are compacted in the same order as the sender ranks
+    int recv = 0, send = 0, weighted = 0;
     for (int i = 0; i < ch->comm_size; i++)
     {
         if (ch->receiver_ranks[i] != 0)
             ch->receiver_ranks[recv++] = i;
         else
-            ch->sender_ranks[send++] = i;
+        {
+            ch->sender_ranks[send] = i;
+            ch->weights[send] = ch->weights[i];
+            weighted |= ch->weights[send++] != 1;
+        }
+    }
+
+    // Check for valid weights; every process checks the same weights
+    for (int i = 0; i < send; i++)
+    {
+        if (ch->weights[i] < 1)
+        {
+            ERROR("Weights of senders need to be positive\n");
+            free(ch->receiver_ranks);
+            free(ch->sender_ranks);
+            free(ch->weights);
+            free(ch);
+            channel_alloc_assert_success(comm, 1);
+            return NULL;
+        }
     }
 
     // Update sender and receiver count
@@ -169,16 +468,107 @@ MPI_Channel *channel_alloc(size_t size, int capacity, MPI_Communication_type com
         ERROR("Error in realloc(): Memory for receiver and sender ranks could not be reallocated\n");
         free(ch->receiver_ranks);
         free(ch->sender_ranks);
+        free(ch->weights);
         free(ch);
         channel_alloc_assert_success(comm, 1);
         return NULL;
     }
 
+    // RMA MPSC BUF channels without FIFO order use the circular buffer of each sender like weighted channels
+    if (!ch->fifo && comm_type == RMA && op == MPI_OP_NULL)
+        weighted = 1;
+
+    // Only the receiver of a MPSC channel schedules senders by weight; it needs a deficit counter for each sender
+    ch->deficits = NULL;
+    if (weighted && ch->is_receiver && ch->receiver_count == 1 && ch->sender_count > 1 && (comm_type == PT2PT || 
+    capacity != 0))
+    {
+        // Shrink the weights of every process to the senders; the old memory is kept and released if realloc() fails
+        int *weights = realloc(ch->weights, ch->sender_count * sizeof(*ch->weights));
+        if (weights)
+            ch->weights = weights;
+        ch->deficits = calloc(ch->sender_count, sizeof(*ch->deficits));
+        if (!weights || !ch->deficits)
+        {
+            ERROR("Error in realloc(): Memory for weights and deficits of senders could not be allocated\n");
+            free(ch->receiver_ranks);
+            free(ch->sender_ranks);
+            free(ch->weights);
+            free(ch->deficits);
+            free(ch);
+            channel_alloc_assert_success(comm, 1);
+            return NULL;
+        }
+    }
+    else
+    {
+        free(ch->weights);
+        ch->weights = NULL;
+    }
+
     /*
     * The number of sender and receiver and the used communication type determines the channel implementation.
     * Function pointers instead of switch-case or if constructs are used for faster and easier function calling.
     */
 
+    // Superstep channels exchange every staged element at once and do not depend on the channel type
+    if (comm_type == COLL)
+    {
+        if (ch->receiver_count < 1 || ch->sender_count < 1)
+        {
+            ERROR("Superstep channels need at least one receiver and one sender\n");
+            free(ch->receiver_ranks);
+            free(ch->sender_ranks);
+            free(ch->weights);
+            free(ch->deficits);
+            free(ch);
+            channel_alloc_assert_success(comm, 1);
+            return NULL;
+        }
+
+        // COLL SUPERSTEP
+        ch->ptr_channel_send = &channel_send_coll_superstep;
+        ch->ptr_channel_receive = &channel_receive_coll_superstep;
+        ch->ptr_channel_peek = &channel_peek_coll_superstep;
+        ch->ptr_channel_free = &channel_free_coll_superstep;
+        return channel_alloc_coll_superstep(ch);
+    }
+
+    // Reduction channels combine the elements of every sender at a single receiver
+    if (op != MPI_OP_NULL)
+    {
+        if (ch->receiver_count != 1 || ch->sender_count < 1)
+        {
+            ERROR("Reduction channels need a single receiver and at least one sender\n");
+            free(ch->receiver_ranks);
+            free(ch->sender_ranks);
+            free(ch->weights);
+            free(ch->deficits);
+            free(ch);
+            channel_alloc_assert_success(comm, 1);
+            return NULL;
+        }
+
+        if (comm_type == PT2PT)
+        {
+            // PT2PT MPSC REDUCE
+            ch->ptr_channel_send = &channel_send_pt2pt_mpsc_reduce;
+            ch->ptr_channel_receive = &channel_receive_pt2pt_mpsc_reduce;
+            ch->ptr_channel_peek = &channel_peek_pt2pt_mpsc_reduce;
+            ch->ptr_channel_free = &channel_free_pt2pt_mpsc_reduce;
+            return channel_alloc_pt2pt_mpsc_reduce(ch);
+        }
+        else
+        {
+            // RMA MPSC REDUCE
+            ch->ptr_channel_send = &channel_send_rma_mpsc_reduce;
+            ch->ptr_channel_receive = &channel_receive_rma_mpsc_reduce;
+            ch->ptr_channel_peek = &channel_peek_rma_mpsc_reduce;
+            ch->ptr_channel_free = &channel_free_rma_mpsc_reduce;
+            return channel_alloc_rma_mpsc_reduce(ch);
+        }
+    }
+
     // SPSC or MPSC
     if (ch->receiver_count == 1)
     {
@@ -188,10 +578,12 @@ MPI_Channel *channel_alloc(size_t size, int capacity, MPI_Communication_type com
             // PT2PT SPSC
             if (comm_type == PT2PT)
             {
-                if (capacity > 0)
+                if (capacity != 0)
                 {
                     // PT2PT SPSC BUF
                     ch->ptr_channel_send = &channel_send_pt2pt_spsc_buf;
+                    ch->ptr_channel_trysend = &channel_trysend_pt2pt_spsc_buf;
+                    ch->ptr_channel_drain = &channel_drain_pt2pt_spsc_buf;
                     ch->ptr_channel_receive = &channel_receive_pt2pt_spsc_buf;
                     ch->ptr_channel_peek = &channel_peek_pt2pt_spsc_buf;
                     ch->ptr_channel_free = &channel_free_pt2pt_spsc_buf;                    
@@ -202,7 +594,7 @@ MPI_Channel *channel_alloc(size_t size, int capacity, MPI_Communication_type com
                     // PT2PT SPSC SYNC
                     ch->ptr_channel_send = &channel_send_pt2pt_spsc_sync;
                     ch->ptr_channel_receive = &channel_receive_pt2pt_spsc_sync;
-                    ch->ptr_channel_peek = &channel_peek_unsupported;
+                    ch->ptr_channel_peek = &channel_peek_pt2pt_spsc_sync;
                     ch->ptr_channel_free = &channel_free_pt2pt_spsc_sync;
                     return channel_alloc_pt2pt_spsc_sync(ch);
                 }
@@ -210,10 +602,11 @@ MPI_Channel *channel_alloc(size_t size, int capacity, MPI_Communication_type com
             // RMA SPSC
             else
             {
-                if (capacity > 0)
+                if (capacity != 0)
                 {
                     // RMA SPSC BUF
                     ch->ptr_channel_send = &channel_send_rma_spsc_buf;
+                    ch->ptr_channel_trysend = &channel_trysend_rma_spsc_buf;
                     ch->ptr_channel_receive = &channel_receive_rma_spsc_buf;
                     ch->ptr_channel_peek = &channel_peek_rma_spsc_buf;
                     ch->ptr_channel_free = &channel_free_rma_spsc_buf;                    
@@ -236,10 +629,12 @@ MPI_Channel *channel_alloc(size_t size, int capacity, MPI_Communication_type com
             // PT2PT MPSC
             if (comm_type == PT2PT)
             {
-                if (capacity > 0)
+                if (capacity != 0)
                 {
                     // PT2PT MPSC BUF
                     ch->ptr_channel_send = &channel_send_pt2pt_mpsc_buf;
+                    ch->ptr_channel_trysend = &channel_trysend_pt2pt_mpsc_buf;
+                    ch->ptr_channel_drain = &channel_drain_pt2pt_mpsc_buf;
                     ch->ptr_channel_receive = &channel_receive_pt2pt_mpsc_buf;
                     ch->ptr_channel_peek = &channel_peek_pt2pt_mpsc_buf;
                     ch->ptr_channel_free = &channel_free_pt2pt_mpsc_buf;    
@@ -250,7 +645,7 @@ MPI_Channel *channel_alloc(size_t size, int capacity, MPI_Communication_type com
                     // PT2PT MPSC SYNC
                     ch->ptr_channel_send = &channel_send_pt2pt_mpsc_sync;
                     ch->ptr_channel_receive = &channel_receive_pt2pt_mpsc_sync;
-                    ch->ptr_channel_peek = &channel_peek_unsupported;
+                    ch->ptr_channel_peek = &channel_peek_pt2pt_mpsc_sync;
                     ch->ptr_channel_free = &channel_free_pt2pt_mpsc_sync;   
                     return channel_alloc_pt2pt_mpsc_sync(ch);
                 }
@@ -258,10 +653,21 @@ MPI_Channel *channel_alloc(size_t size, int capacity, MPI_Communication_type com
             // RMA MPSC
             else
             {
-                if (capacity > 0)
+                if (capacity != 0 && weighted)
+                {
+                    // RMA MPSC BUF with deficit round robin scheduling of senders
+                    ch->ptr_channel_send = &channel_send_rma_mpsc_buf_drr;
+                    ch->ptr_channel_trysend = &channel_trysend_rma_mpsc_buf_drr;
+                    ch->ptr_channel_receive = &channel_receive_rma_mpsc_buf_drr;
+                    ch->ptr_channel_peek = &channel_peek_rma_mpsc_buf_drr;
+                    ch->ptr_channel_free = &channel_free_rma_mpsc_buf_drr;
+                    return channel_alloc_rma_mpsc_buf_drr(ch);
+                }
+                else if (capacity != 0)
                 {
                     // RMA MPSC BUF
                     ch->ptr_channel_send = &channel_send_rma_mpsc_buf;
+                    ch->ptr_channel_trysend = &channel_trysend_rma_mpsc_buf;
                     ch->ptr_channel_receive = &channel_receive_rma_mpsc_buf;
                     ch->ptr_channel_peek = &channel_peek_rma_mpsc_buf;
                     ch->ptr_channel_free = &channel_free_rma_mpsc_buf;                     
@@ -272,7 +678,7 @@ MPI_Channel *channel_alloc(size_t size, int capacity, MPI_Communication_type com
                     // RMA MPSC SYNC
                     ch->ptr_channel_send = &channel_send_rma_mpsc_sync;
                     ch->ptr_channel_receive = &channel_receive_rma_mpsc_sync;
-                    ch->ptr_channel_peek = &channel_peek_unsupported;
+                    ch->ptr_channel_peek = &channel_peek_rma_mpsc_sync;
                     ch->ptr_channel_free = &channel_free_rma_mpsc_sync;                          
                     return channel_alloc_rma_mpsc_sync(ch);
                 }
@@ -286,21 +692,42 @@ MPI_Channel *channel_alloc(size_t size, int capacity, MPI_Communication_type com
         // PT2PT MPMC
         if (comm_type == PT2PT)
         {
-            if (capacity > 0)
+            if (capacity != 0 && ch->pull)
+            {
+                // PT2PT MPMC BUF with receivers demanding elements from the senders
+                ch->ptr_channel_send = &channel_send_pt2pt_mpmc_buf_pull;
+                ch->ptr_channel_trysend = &channel_trysend_pt2pt_mpmc_buf_pull;
+                ch->ptr_channel_receive = &channel_receive_pt2pt_mpmc_buf_pull;
+                ch->ptr_channel_peek = &channel_peek_pt2pt_mpmc_buf_pull;
+                ch->ptr_channel_free = &channel_free_pt2pt_mpmc_buf_pull;
+                return channel_alloc_pt2pt_mpmc_buf_pull(ch);
+            }
+            else if (capacity != 0)
             {
                 // PT2PT MPMC BUF
                 ch->ptr_channel_send = &channel_send_pt2pt_mpmc_buf;
+                ch->ptr_channel_trysend = &channel_trysend_pt2pt_mpmc_buf;
+                ch->ptr_channel_drain = &channel_drain_pt2pt_mpmc_buf;
                 ch->ptr_channel_receive = &channel_receive_pt2pt_mpmc_buf;
                 ch->ptr_channel_peek = &channel_peek_pt2pt_mpmc_buf;
                 ch->ptr_channel_free = &channel_free_pt2pt_mpmc_buf;                  
                 return channel_alloc_pt2pt_mpmc_buf(ch);
             }
+            else if (ch->matchmaker)
+            {
+                // PT2PT MPMC SYNC with a matchmaker pairing senders and receivers
+                ch->ptr_channel_send = &channel_send_pt2pt_mpmc_sync_match;
+                ch->ptr_channel_receive = &channel_receive_pt2pt_mpmc_sync_match;
+                ch->ptr_channel_peek = &channel_peek_pt2pt_mpmc_sync_match;
+                ch->ptr_channel_free = &channel_free_pt2pt_mpmc_sync_match;
+                return channel_alloc_pt2pt_mpmc_sync_match(ch);
+            }
             else
             {
                 // PT2PT MPMC SYNC
                 ch->ptr_channel_send = &channel_send_pt2pt_mpmc_sync;
                 ch->ptr_channel_receive = &channel_receive_pt2pt_mpmc_sync;
-                ch->ptr_channel_peek = &channel_peek_unsupported;
+                ch->ptr_channel_peek = &channel_peek_pt2pt_mpmc_sync;
                 ch->ptr_channel_free = &channel_free_pt2pt_mpmc_sync;                 
                 return channel_alloc_pt2pt_mpmc_sync(ch);
             }
@@ -308,11 +735,13 @@ MPI_Channel *channel_alloc(size_t size, int capacity, MPI_Communication_type com
         // RMA MPMC
         else
         {
-            if (capacity > 0)
+            if (capacity != 0)
             {
                 // RMA MPMC BUF
                 ch->ptr_channel_send = &channel_send_rma_mpmc_buf;
+                ch->ptr_channel_trysend = &channel_trysend_rma_mpmc_buf;
                 ch->ptr_channel_receive = &channel_receive_rma_mpmc_buf;
+                ch->ptr_channel_tryreceive = &channel_tryreceive_rma_mpmc_buf;
                 ch->ptr_channel_peek = &channel_peek_rma_mpmc_buf;
                 ch->ptr_channel_free = &channel_free_rma_mpmc_buf;  
                 return channel_alloc_rma_mpmc_buf(ch);
@@ -322,7 +751,7 @@ MPI_Channel *channel_alloc(size_t size, int capacity, MPI_Communication_type com
                 // RMA MPMC SYNC
                 ch->ptr_channel_send = &channel_send_rma_mpmc_sync;
                 ch->ptr_channel_receive = &channel_receive_rma_mpmc_sync;
-                ch->ptr_channel_peek = &channel_peek_unsupported;
+                ch->ptr_channel_peek = &channel_peek_rma_mpmc_sync;
                 ch->ptr_channel_free = &channel_free_rma_mpmc_sync;  
                 return channel_alloc_rma_mpmc_sync(ch);
             }
@@ -330,6 +759,238 @@ MPI_Channel *channel_alloc(size_t size, int capacity, MPI_Communication_type com
     }
 }
 
+MPI_Channel *channel_alloc_threads(size_t size, int capacity, int senders, int receivers)
+{
+    // Assert valid parameters
+    if (size == 0 || capacity < 1 || senders < 1 || receivers < 1)
+    {
+        ERROR("Channels between threads need a positive size, capacity and number of senders and receivers\n");
+        return NULL;
+    }
+
+    // Allocate memory for MPI_Channel
+    MPI_Channel *ch;
+    if ((ch = malloc(sizeof(*ch))) == NULL)
+    {
+        ERROR("Error in malloc(): Memory for MPI_Channel could not be allocated\n");
+        return NULL;
+    }
+
+    // Every thread uses the same channel; the channel does not span processes
+    ch->data_size = size;
+    ch->capacity = capacity;
+    ch->my_rank = 0;
+    ch->is_receiver = 0;
+    ch->receiver_ranks = ch->sender_ranks = NULL;
+    ch->receiver_count = receivers;
+    ch->sender_count = senders;
+    ch->comm_type = THREADS;
+    ch->comm = MPI_COMM_SELF;
+    ch->comm_size = 1;
+
+    // Features of channels between processes are not used
+    ch->unbounded = 0;
+    ch->staged_items = 0;
+    ch->seg_head = ch->seg_tail = ch->seg_spare = NULL;
+    ch->spill = NULL;
+    ch->spill_limit = 0;
+    ch->weights = ch->deficits = NULL;
+    ch->info = MPI_INFO_NULL;
+    ch->fifo = 1;
+    ch->rma_credits = 0;
+    ch->matchmaker = 0;
+    ch->pull = 0;
+    ch->ts = NULL;
+    ch->progress = 0;
+    ch->ring = NULL;
+    ch->quota = capacity;
+    ch->reduce_op = MPI_OP_NULL;
+    ch->reduce_type = MPI_DATATYPE_NULL;
+    ch->levels = 1;
+    ch->level_ch = NULL;
+    ch->ptr_channel_trysend = NULL;
+    ch->ptr_channel_tryreceive = NULL;
+    ch->ptr_channel_drain = NULL;
+
+    // SPSC
+    if (senders == 1 && receivers == 1)
+    {
+        // THREADS SPSC BUF
+        ch->ptr_channel_send = &channel_send_threads_spsc_buf;
+        ch->ptr_channel_receive = &channel_receive_threads_spsc_buf;
+        ch->ptr_channel_peek = &channel_peek_threads_spsc_buf;
+        ch->ptr_channel_free = &channel_free_threads_spsc_buf;
+        return channel_alloc_threads_spsc_buf(ch);
+    }
+    // MPSC
+    else if (receivers == 1)
+    {
+        // THREADS MPSC BUF
+        ch->ptr_channel_send = &channel_send_threads_mpsc_buf;
+        ch->ptr_channel_receive = &channel_receive_threads_mpsc_buf;
+        ch->ptr_channel_peek = &channel_peek_threads_mpsc_buf;
+        ch->ptr_channel_free = &channel_free_threads_mpsc_buf;
+        return channel_alloc_threads_mpsc_buf(ch);
+    }
+    // MPMC; a single sender uses the MPMC ring as well
+    else
+    {
+        // THREADS MPMC BUF
+        ch->ptr_channel_send = &channel_send_threads_mpmc_buf;
+        ch->ptr_channel_receive = &channel_receive_threads_mpmc_buf;
+        ch->ptr_channel_peek = &channel_peek_threads_mpmc_buf;
+        ch->ptr_channel_free = &channel_free_threads_mpmc_buf;
+        return channel_alloc_threads_mpmc_buf(ch);
+    }
+}
+
+MPI_Channel *channel_alloc_prio(size_t size, int capacity, int levels, MPI_Communication_type comm_type, MPI_Comm comm, 
+int is_receiver)
+{
+    // Check if MPI has been initialized, nothrow
+    int flag;
+    MPI_Initialized(&flag);
+
+    if (!flag) {
+        ERROR("MPI has not been initialized\n");
+        return NULL;
+    }
+
+    // Used to store if the parameters of the calling process are invalid
+    int invalid = 0;
+
+    // Channels between threads are allocated with channel_alloc_threads()
+    if (comm_type == THREADS)
+    {
+        ERROR("Channels between threads cannot have priority levels\n");
+        invalid = 1;
+    }
+
+    // Assert that the channel is buffered
+    if (levels > 1 && capacity == 0)
+    {
+        ERROR("Synchronous channels cannot have priority levels\n");
+        invalid = 1;
+    }
+
+    // Receivers of superstep channels cannot wait for elements of higher levels
+    if (levels > 1 && comm_type == COLL)
+    {
+        ERROR("Superstep channels cannot have priority levels\n");
+        invalid = 1;
+    }
+
+    // Assert that every process has the same number of levels and valid parameters before any level is allocated; the
+    // maximum of levels and -levels is reduced so every process takes the same branch below
+    int s_levels_arr[3] = {levels, -levels, invalid}, r_levels_arr[3];
+    if (MPI_Allreduce(s_levels_arr, r_levels_arr, 3, MPI_INT, MPI_MAX, comm) != MPI_SUCCESS)
+    {
+        ERROR("Error in MPI_Allreduce(): Communicator might be invalid\n");
+        return NULL;
+    }
+
+    if (r_levels_arr[0] != -r_levels_arr[1])
+    {
+        ERROR("Every process needs the same number of priority levels as parameter\n");
+        return NULL;
+    }
+
+    if (r_levels_arr[2])
+    {
+        ERROR("Invalid parameters for priority channel: At least one process failed\n");
+        return NULL;
+    }
+
+    // Assert valid number of levels
+    if (levels < 1 || levels > MPI_CHANNEL_MAX_PRIO_LEVELS)
+    {
+        ERROR("Number of priority levels needs to be between 1 and %d\n", MPI_CHANNEL_MAX_PRIO_LEVELS);
+        return NULL;
+    }
+
+    // A single level is a channel without priority levels
+    if (levels == 1)
+        return channel_alloc(size, capacity, comm_type, comm, is_receiver);
+
+    // Allocate memory for MPI_Channel and the channels of each level
+    MPI_Channel *ch;
+    if ((ch = malloc(sizeof(*ch))) == NULL || (ch->level_ch = malloc(levels * sizeof(*ch->level_ch))) == NULL)
+    {
+        ERROR("Error in malloc(): Memory for MPI_Channel could not be allocated\n");
+        free(ch);
+        channel_alloc_assert_success(comm, 1);
+        return NULL;
+    }
+
+    if (channel_alloc_assert_success(comm, 0) != 1)
+    {
+        ERROR("Error in finalizing channel allocation: At least one process failed\n");
+        free(ch->level_ch);
+        free(ch);
+        return NULL;
+    }
+
+    // Allocate a channel for each level; channel_alloc() fails on every process at the same level
+    for (int i = 0; i < levels; i++)
+    {
+        if ((ch->level_ch[i] = channel_alloc(size, capacity, comm_type, comm, is_receiver)) == NULL)
+        {
+            ERROR("Error in channel_alloc(): Priority level %d could not be allocated\n", i);
+            while (i-- > 0)
+                channel_free(ch->level_ch[i]);
+            free(ch->level_ch);
+            free(ch);
+            return NULL;
+        }
+    }
+
+    // Properties are the same for every level
+    MPI_Channel *base = ch->level_ch[0];
+    ch->data_size = base->data_size;
+    ch->capacity = capacity;
+    ch->my_rank = base->my_rank;
+    ch->is_receiver = base->is_receiver;
+    ch->receiver_ranks = ch->sender_ranks = NULL;
+    ch->receiver_count = base->receiver_count;
+    ch->sender_count = base->sender_count;
+    ch->chan_type = base->chan_type;
+    ch->comm_type = base->comm_type;
+    ch->comm = base->comm;
+    ch->comm_size = base->comm_size;
+
+    // Elements are staged by the channels of each level
+    ch->unbounded = 0;
+    ch->staged_items = 0;
+    ch->seg_head = ch->seg_tail = ch->seg_spare = NULL;
+    ch->spill = NULL;
+    ch->spill_limit = 0;
+    ch->weights = ch->deficits = NULL;
+    ch->info = MPI_INFO_NULL;
+    ch->fifo = 1;
+    ch->rma_credits = 0;
+    ch->matchmaker = 0;
+    ch->pull = 0;
+    ch->ts = NULL;
+    ch->progress = 0;
+    ch->ring = NULL;
+    ch->quota = ch->capacity;
+    ch->reduce_op = MPI_OP_NULL;
+    ch->reduce_type = MPI_DATATYPE_NULL;
+
+    ch->levels = levels;
+    ch->ptr_channel_send = &channel_send_prio_lowest;
+    ch->ptr_channel_trysend = NULL;
+    ch->ptr_channel_receive = &channel_receive_prio;
+    ch->ptr_channel_tryreceive = NULL;
+    ch->ptr_channel_drain = NULL;
+    ch->ptr_channel_peek = &channel_peek_prio;
+    ch->ptr_channel_free = &channel_free_prio;
+
+    DEBUG("Channel with %d priority levels finished allocation\n", levels);
+
+    return ch;
+}
+
 int channel_send(MPI_Channel *ch, void *data)
 {
     // Assert that channel is not NULL
@@ -346,17 +1007,38 @@ int channel_send(MPI_Channel *ch, void *data)
         return -1;
     }
 
-    // Assert that calling process is not a receiver
-    if (ch->is_receiver) 
+    // Assert that calling process is not a receiver; every thread can send to channels between threads
+    if (ch->is_receiver && ch->comm_type != THREADS) 
     {
         WARNING("Receiver process cannot call channel_send()");
         return -1;
     }
-    else 
+
+    // Threads of thread-safe channels hand the element over to the combining thread
+    if (ch->ts != NULL)
+        return channel_combine(ch, &channel_send_local, data);
+
+    return channel_send_local(ch, data);
+}
+
+int channel_send_prio(MPI_Channel *ch, void *data, int level)
+{
+    // Assert that channel is not NULL
+    if (ch == NULL)
+    {
+        WARNING("Channel is NULL\n");
+        return -1;
+    }
+
+    // Assert that level is valid
+    if (level < 0 || level >= ch->levels)
     {
-        // Call function stored at function pointer
-        return (*ch->ptr_channel_send)(ch, data);
+        WARNING("Priority level %d is out of range\n", level);
+        return -1;
     }
+
+    // Send element to the channel of the level; channel_send() does the remaining checks
+    return channel_send(ch->levels > 1 ? ch->level_ch[level] : ch, data);
 }
 
 int channel_receive(MPI_Channel *ch, void *data)
@@ -375,17 +1057,19 @@ int channel_receive(MPI_Channel *ch, void *data)
         return -1;
     }
 
-    // Assert that calling process is not a sender
-    if (!ch->is_receiver) 
+    // Assert that calling process is not a sender; every thread can receive from channels between threads
+    if (!ch->is_receiver && ch->comm_type != THREADS) 
     {
         WARNING("Sender process cannot call channel_receive()");
         return -1;
     }
-    else 
-    {
-        // Call function stored at function pointer
-        return (*ch->ptr_channel_receive)(ch, data);
-    }
+
+    // Threads of thread-safe channels let the combining thread receive the element
+    if (ch->ts != NULL)
+        return channel_combine(ch, ch->ptr_channel_receive, data);
+
+    // Call function stored at function pointer
+    return (*ch->ptr_channel_receive)(ch, data);
 }
 
 int channel_peek(MPI_Channel *ch)
@@ -397,12 +1081,14 @@ int channel_peek(MPI_Channel *ch)
         return -1;
     }
 
-    // Synchronous channels do not support channel_peek()
-    // Call function stored at function pointer
-    return (*ch->ptr_channel_peek)(ch);
+    // Threads of thread-safe channels let the combining thread peek at the channel
+    if (ch->ts != NULL)
+        return channel_combine(ch, &channel_peek_local, NULL);
+
+    return channel_peek_local(ch, NULL);
 }
 
-int channel_free(MPI_Channel *ch)
+int channel_flush_superstep(MPI_Channel *ch)
 {
     // Assert that channel is not NULL
     if (ch == NULL)
@@ -411,9 +1097,288 @@ int channel_free(MPI_Channel *ch)
         return -1;
     }
 
-    // Call function stored at function pointer
-    return (*ch->ptr_channel_free)(ch);
-}
+    // Assert that the channel is a superstep channel
+    if (ch->comm_type != COLL)
+    {
+        WARNING("Only channels with communication type COLL can be flushed\n");
+        return -1;
+    }
+
+    // Threads of thread-safe channels let the combining thread flush the channel
+    if (ch->ts != NULL)
+        return channel_combine(ch, &channel_flush_superstep_local, NULL);
+
+    return channel_flush_coll_superstep(ch);
+}
+
+int channel_free(MPI_Channel *ch)
+{
+    // Assert that channel is not NULL
+    if (ch == NULL)
+    {
+        WARNING("Channel is NULL\n");
+        return -1;
+    }
+
+    // The progress thread must not poll the channel anymore
+    if (ch->progress && channel_progress_remove(ch) == -1)
+        return -1;
+
+    // Senders of unbounded and spilling channels need to hand over every staged element before the channel can be freed
+    if ((ch->unbounded || ch->spill != NULL) && !ch->is_receiver && channel_drain_unbounded(ch) == -1)
+        return -1;
+
+    // Release hints and the state of thread-safe channels
+    if (ch->info != MPI_INFO_NULL)
+        MPI_Info_free(&ch->info);
+    free(ch->ts);
+    ch->ts = NULL;
+
+    // Call function stored at function pointer
+    return (*ch->ptr_channel_free)(ch);
+}
+
+int channel_ifree(MPI_Channel *ch, MPI_Request *request)
+{
+    // Assert that channel and request are not NULL
+    if (ch == NULL || request == NULL)
+    {
+        WARNING("Channel or request is NULL\n");
+        return -1;
+    }
+
+    // Error flag is reported by the generalized request and freed with it
+    int *error = malloc(sizeof(*error));
+
+    if (error == NULL)
+    {
+        ERROR("Error in malloc(): Memory for error flag could not be allocated\n");
+        return -1;
+    }
+
+    *error = 0;
+
+    if (MPI_Grequest_start(&channel_ifree_query, &channel_ifree_release, &channel_ifree_cancel, error, request) 
+    != MPI_SUCCESS)
+    {
+        ERROR("Error in MPI_Grequest_start()\n");
+        free(error);
+        return -1;
+    }
+
+    // The progress thread can only call MPI with MPI_THREAD_MULTIPLE; channels between threads are freed locally
+    int provided;
+    if (ch->comm_type == THREADS || MPI_Query_thread(&provided) != MPI_SUCCESS || provided != MPI_THREAD_MULTIPLE)
+    {
+        *error = channel_free(ch) != 1;
+        MPI_Grequest_complete(*request);
+        return *error ? -1 : 1;
+    }
+
+    // The progress thread frees the channel instead of polling it
+    if (ch->progress && channel_progress_remove(ch) == -1)
+    {
+        *error = 1;
+        MPI_Grequest_complete(*request);
+        return -1;
+    }
+
+    pthread_mutex_lock(&progress.lock);
+
+    // Grow list of freed channels
+    if (progress.pending == progress.teardown_size)
+    {
+        int size = progress.teardown_size ? 2 * progress.teardown_size : 8;
+        MPI_Channel_teardown *teardowns = realloc(progress.teardowns, size * sizeof(*teardowns));
+
+        if (teardowns == NULL)
+        {
+            ERROR("Error in realloc(): Memory for freed channels could not be allocated\n");
+            pthread_mutex_unlock(&progress.lock);
+            *error = 1;
+            MPI_Grequest_complete(*request);
+            return -1;
+        }
+
+        progress.teardowns = teardowns;
+        progress.teardown_size = size;
+    }
+
+    progress.teardowns[progress.pending++] = (MPI_Channel_teardown) {ch, *request, MPI_REQUEST_NULL, DRAIN, error};
+
+    // Start progress thread unless channels are already polled
+    if (channel_progress_start() != 1)
+    {
+        progress.pending--;
+        pthread_mutex_unlock(&progress.lock);
+        *error = 1;
+        MPI_Grequest_complete(*request);
+        return -1;
+    }
+
+    pthread_mutex_unlock(&progress.lock);
+
+    return 1;
+}
+
+int channel_set_spill(MPI_Channel *ch, const char *dir, int mem_limit)
+{
+    // Assert that channel is not NULL
+    if (ch == NULL)
+    {
+        WARNING("Channel is NULL\n");
+        return -1;
+    }
+
+    // Assert that directory is not NULL
+    if (dir == NULL)
+    {
+        WARNING("Directory cannot be NULL\n");
+        return -1;
+    }
+
+    // Assert that calling process is not a receiver
+    if (ch->is_receiver)
+    {
+        WARNING("Receiver process cannot call channel_set_spill()\n");
+        return -1;
+    }
+
+    // Every priority level spills to a log file of its own
+    if (ch->levels > 1)
+    {
+        for (int i = 0; i < ch->levels; i++)
+            if (channel_set_spill(ch->level_ch[i], dir, mem_limit) != 1)
+                return -1;
+
+        return 1;
+    }
+
+    // Only buffered channels can hand over staged elements without blocking
+    if (ch->ptr_channel_trysend == NULL)
+    {
+        WARNING("Synchronous channels cannot spill elements\n");
+        return -1;
+    }
+
+    // Assert that no log file is in use
+    if (ch->spill != NULL)
+    {
+        WARNING("Channel already spills elements\n");
+        return -1;
+    }
+
+    if (spill_open(ch, dir) != 1)
+    {
+        ERROR("Error in spill_open(): Log file could not be created\n");
+        return -1;
+    }
+
+    ch->spill_limit = mem_limit < 0 ? 0 : mem_limit;
+
+    return 1;
+}
+
+int channel_set_thread_safe(MPI_Channel *ch)
+{
+    // Assert that channel is not NULL
+    if (ch == NULL)
+    {
+        WARNING("Channel is NULL\n");
+        return -1;
+    }
+
+    // Channels between threads are thread-safe by themselves
+    if (ch->comm_type == THREADS)
+        return 1;
+
+    // Threads can only call MPI concurrently with MPI_THREAD_MULTIPLE
+    int provided;
+    if (MPI_Query_thread(&provided) != MPI_SUCCESS || provided != MPI_THREAD_MULTIPLE)
+    {
+        WARNING("Thread-safe channels need MPI to be initialized with MPI_THREAD_MULTIPLE\n");
+        return -1;
+    }
+
+    // Channel is already thread-safe
+    if (ch->ts != NULL)
+        return 1;
+
+    // Senders send to the channels of each level directly
+    if (ch->levels > 1)
+    {
+        for (int i = 0; i < ch->levels; i++)
+            if (channel_set_thread_safe(ch->level_ch[i]) != 1)
+                return -1;
+    }
+
+    if ((ch->ts = malloc(sizeof(*ch->ts))) == NULL)
+    {
+        ERROR("Error in malloc(): Memory for thread-safe channel could not be allocated\n");
+        return -1;
+    }
+
+    atomic_init(&ch->ts->top, NULL);
+    atomic_flag_clear(&ch->ts->combining);
+
+    return 1;
+}
+
+int channel_set_progress(MPI_Channel *ch)
+{
+    // Assert that channel is not NULL
+    if (ch == NULL)
+    {
+        WARNING("Channel is NULL\n");
+        return -1;
+    }
+
+    // Channel is already polled; channels between threads do not depend on MPI progress
+    if (ch->progress || ch->comm_type == THREADS)
+        return 1;
+
+    // The progress thread uses the channel concurrently to the threads of the application
+    if (channel_set_thread_safe(ch) != 1)
+    {
+        ERROR("Error in channel_set_thread_safe()\n");
+        return -1;
+    }
+
+    pthread_mutex_lock(&progress.lock);
+
+    // Grow list of polled channels
+    if (progress.count == progress.size)
+    {
+        int size = progress.size ? 2 * progress.size : 8;
+        MPI_Channel **channels = realloc(progress.channels, size * sizeof(*channels));
+
+        if (channels == NULL)
+        {
+            ERROR("Error in realloc(): Memory for polled channels could not be allocated\n");
+            pthread_mutex_unlock(&progress.lock);
+            return -1;
+        }
+
+        progress.channels = channels;
+        progress.size = size;
+    }
+
+    progress.channels[progress.count++] = ch;
+    ch->progress = 1;
+
+    // Start progress thread with the first channel
+    if (channel_progress_start() != 1)
+    {
+        progress.count--;
+        ch->progress = 0;
+        pthread_mutex_unlock(&progress.lock);
+        return -1;
+    }
+
+    pthread_mutex_unlock(&progress.lock);
+
+    return 1;
+}
 
 // ****************************
 // CHANNELS UTIL FUNCTIONS 
@@ -440,7 +1405,7 @@ int channel_capacity(MPI_Channel *ch)
         return -1;
     }
 
-    return ch->capacity;
+    return ch->unbounded ? -ch->capacity : ch->capacity;
 }
 
 int channel_type(MPI_Channel *ch)
@@ -526,4 +1491,485 @@ int channel_receiver_num(MPI_Channel *ch)
 // Dummy function used for channels which do not support peeking
 int channel_peek_unsupported() {
     return -1;
-}
\ No newline at end of file
+}
+
+// Executes an operation of a thread-safe channel. The calling thread publishes the operation and waits until it has been
+// executed; whichever thread gets the combining flag executes every published operation in publication order
+int channel_combine(MPI_Channel *ch, int (*fn)(MPI_Channel*, void*), void *data)
+{
+    MPI_Channel_op op = {.next = NULL, .fn = fn, .data = data, .result = -1};
+    atomic_init(&op.done, 0);
+
+    // Publish operation on the lock-free stack
+    op.next = atomic_load_explicit(&ch->ts->top, memory_order_relaxed);
+    while (!atomic_compare_exchange_weak_explicit(&ch->ts->top, &op.next, &op, memory_order_release, 
+    memory_order_relaxed))
+        ;
+
+    while (!atomic_load_explicit(&op.done, memory_order_acquire))
+    {
+        // Another thread is combining and will execute the operation unless it has taken its batch already; give the
+        // combining thread the core in case of more threads than cores
+        if (atomic_flag_test_and_set_explicit(&ch->ts->combining, memory_order_acquire))
+        {
+            sched_yield();
+            continue;
+        }
+
+        // Take every published operation at once until the own operation has been executed
+        MPI_Channel_op *list;
+        while (!atomic_load_explicit(&op.done, memory_order_relaxed) && 
+        (list = atomic_exchange_explicit(&ch->ts->top, NULL, memory_order_acquire)) != NULL)
+        {
+            // Reverse the stack to execute operations in publication order
+            MPI_Channel_op *batch = NULL, *next;
+            while (list != NULL)
+            {
+                next = list->next;
+                list->next = batch;
+                batch = list;
+                list = next;
+            }
+
+            // Execute the batch back to back; the successor is read first since the thread of a finished operation 
+            // returns and releases its operation
+            while (batch != NULL)
+            {
+                next = batch->next;
+                batch->result = (*batch->fn)(ch, batch->data);
+                atomic_store_explicit(&batch->done, 1, memory_order_release);
+                batch = next;
+            }
+        }
+
+        atomic_flag_clear_explicit(&ch->ts->combining, memory_order_release);
+    }
+
+    return op.result;
+}
+
+// Sends an element; unbounded and spilling channels stage elements instead of blocking
+int channel_send_local(MPI_Channel *ch, void *data)
+{
+    if (ch->unbounded || ch->spill != NULL)
+        return channel_send_unbounded(ch, data);
+
+    // Call function stored at function pointer
+    return (*ch->ptr_channel_send)(ch, data);
+}
+
+// Peeks at the channel; data is unused
+int channel_peek_local(MPI_Channel *ch, void *data)
+{
+    (void) data;
+
+    // Senders of unbounded and spilling channels hand over staged elements first
+    if ((ch->unbounded || ch->spill != NULL) && !ch->is_receiver)
+    {
+        if (channel_flush_unbounded(ch) == -1)
+            return -1;
+
+        // If the channel buffer is full the next element will be staged in an overflow segment
+        int free_slots = (*ch->ptr_channel_peek)(ch);
+        return free_slots == 0 ? ch->capacity : free_slots;
+    }
+
+    // Call function stored at function pointer
+    return (*ch->ptr_channel_peek)(ch);
+}
+
+// Flushes a superstep channel; data is unused
+int channel_flush_superstep_local(MPI_Channel *ch, void *data)
+{
+    (void) data;
+
+    return channel_flush_coll_superstep(ch);
+}
+
+// Polls every channel of the progress thread until the thread is stopped
+void *channel_progress_run(void *arg)
+{
+    (void) arg;
+    struct timespec interval = {0, MPI_CHANNEL_PROGRESS_INTERVAL * 1000L};
+
+    pthread_mutex_lock(&progress.lock);
+
+    // Progress thread returns once no channel is polled or freed anymore
+    while (progress.count > 0 || progress.pending > 0)
+    {
+        for (int i = 0; i < progress.count; i++)
+        {
+            MPI_Channel *ch = progress.channels[i];
+
+            // Skip channels a thread of the application uses at the moment
+            if (atomic_flag_test_and_set_explicit(&ch->ts->combining, memory_order_acquire))
+                continue;
+
+            // Peeking consumes acknowledgements, hands over staged elements and enters MPI; levels are peeked at one by
+            // one since senders use them directly, a level which is in use is skipped instead of waiting for it
+            if (ch->levels > 1)
+            {
+                for (int level = 0; level < ch->levels; level++)
+                {
+                    MPI_Channel *level_ch = ch->level_ch[level];
+
+                    if (atomic_flag_test_and_set_explicit(&level_ch->ts->combining, memory_order_acquire))
+                        continue;
+
+                    channel_peek_local(level_ch, NULL);
+
+                    atomic_flag_clear_explicit(&level_ch->ts->combining, memory_order_release);
+                }
+            }
+            else
+                channel_peek_local(ch, NULL);
+
+            atomic_flag_clear_explicit(&ch->ts->combining, memory_order_release);
+        }
+
+        // Advance the deallocation of channels passed to channel_ifree()
+        channel_progress_teardown();
+
+        // Channels can be added and removed while the progress thread sleeps
+        pthread_mutex_unlock(&progress.lock);
+        nanosleep(&interval, NULL);
+        pthread_mutex_lock(&progress.lock);
+    }
+
+    // Release the lists; the next channel starts a new progress thread
+    progress.running = 0;
+    free(progress.channels);
+    progress.channels = NULL;
+    progress.size = 0;
+    free(progress.teardowns);
+    progress.teardowns = NULL;
+    progress.teardown_size = 0;
+
+    pthread_mutex_unlock(&progress.lock);
+
+    return NULL;
+}
+
+// Removes a channel from the progress thread; the progress thread returns after the last channel
+int channel_progress_remove(MPI_Channel *ch)
+{
+    // The progress thread does not poll while the list is locked
+    pthread_mutex_lock(&progress.lock);
+
+    for (int i = 0; i < progress.count; i++)
+    {
+        if (progress.channels[i] == ch)
+        {
+            progress.channels[i] = progress.channels[--progress.count];
+            break;
+        }
+    }
+
+    ch->progress = 0;
+
+    pthread_mutex_unlock(&progress.lock);
+
+    return 1;
+}
+
+// Starts the detached progress thread unless it is running; progress.lock needs to be held
+int channel_progress_start()
+{
+    pthread_attr_t attr;
+    pthread_t thread;
+
+    if (progress.running)
+        return 1;
+
+    // Progress thread is never joined since it returns on its own once both lists are empty
+    if (pthread_attr_init(&attr) != 0 || pthread_attr_setdetachstate(&attr, PTHREAD_CREATE_DETACHED) != 0 || 
+    pthread_create(&thread, &attr, &channel_progress_run, NULL) != 0)
+    {
+        ERROR("Error in pthread_create(): Progress thread could not be started\n");
+        pthread_attr_destroy(&attr);
+        return -1;
+    }
+
+    pthread_attr_destroy(&attr);
+    progress.running = 1;
+
+    return 1;
+}
+
+// Advances the deallocation of every channel passed to channel_ifree(); progress.lock needs to be held
+void channel_progress_teardown()
+{
+    for (int i = 0; i < progress.pending; i++)
+    {
+        MPI_Channel_teardown *t = &progress.teardowns[i];
+
+        // Hand over staged elements and consume acknowledgement messages; afterwards wait for the other processes
+        if (t->state == DRAIN)
+        {
+            int drained = channel_ifree_drain(t->ch);
+
+            if (drained == 1 && MPI_Ibarrier(t->ch->comm, &t->barrier) != MPI_SUCCESS)
+            {
+                ERROR("Error in MPI_Ibarrier()\n");
+                drained = -1;
+            }
+
+            if (drained != 0)
+                t->state = drained == 1 ? SYNC : FAILED;
+        }
+
+        // Every process of the channel has been drained once the barrier completes
+        if (t->state == SYNC)
+        {
+            int flag = 0;
+
+            if (MPI_Test(&t->barrier, &flag, MPI_STATUS_IGNORE) != MPI_SUCCESS)
+            {
+                ERROR("Error in MPI_Test()\n");
+                t->state = FAILED;
+            }
+            else if (flag)
+                t->state = RELEASE;
+        }
+    }
+
+    // Release channels in the order of the channel_ifree() calls like channel_free() would; the collective 
+    // deallocation does not wait long since every process of the channel has been drained
+    while (progress.pending > 0 && progress.teardowns[0].state >= RELEASE)
+    {
+        MPI_Channel_teardown *t = &progress.teardowns[0];
+
+        if (t->state == FAILED || channel_free(t->ch) != 1)
+            *t->error = 1;
+
+        MPI_Grequest_complete(t->request);
+
+        memmove(t, t + 1, --progress.pending * sizeof(*t));
+    }
+}
+
+// Drains a channel without blocking; returns 1 once no element is staged and every message has been acknowledged
+int channel_ifree_drain(MPI_Channel *ch)
+{
+    int drained = 1;
+
+    // Priority levels are separate channels
+    if (ch->levels > 1)
+    {
+        for (int level = 0; level < ch->levels; level++)
+        {
+            int level_drained = channel_ifree_drain(ch->level_ch[level]);
+
+            if (level_drained == -1)
+                return -1;
+
+            drained &= level_drained;
+        }
+
+        return drained;
+    }
+
+    // Hand over as many staged elements as the channel buffer can take
+    if ((ch->unbounded || ch->spill != NULL) && !ch->is_receiver)
+    {
+        int staged = channel_flush_unbounded(ch);
+
+        if (staged == -1)
+            return -1;
+
+        drained = staged == 0;
+    }
+
+    // Consume acknowledgement messages of buffered PT2PT channels
+    if (ch->ptr_channel_drain != NULL)
+    {
+        int acknowledged = (*ch->ptr_channel_drain)(ch);
+
+        if (acknowledged == -1)
+            return -1;
+
+        drained &= acknowledged;
+    }
+
+    return drained;
+}
+
+// Fills the status of the generalized request of channel_ifree(); extra_state points to the error flag
+int channel_ifree_query(void *extra_state, MPI_Status *status)
+{
+    MPI_Status_set_elements(status, MPI_BYTE, 0);
+    MPI_Status_set_cancelled(status, 0);
+    status->MPI_SOURCE = MPI_UNDEFINED;
+    status->MPI_TAG = MPI_UNDEFINED;
+    status->MPI_ERROR = *(int *) extra_state ? MPI_ERR_OTHER : MPI_SUCCESS;
+
+    return status->MPI_ERROR;
+}
+
+// Frees the error flag of the generalized request of channel_ifree()
+int channel_ifree_release(void *extra_state)
+{
+    free(extra_state);
+
+    return MPI_SUCCESS;
+}
+
+// The deallocation of a channel cannot be cancelled
+int channel_ifree_cancel(void *extra_state, int complete)
+{
+    (void) extra_state;
+    (void) complete;
+
+    return MPI_SUCCESS;
+}
+
+// Sends an element of an unbounded channel; staged elements are handed over first to preserve the order of elements
+int channel_send_unbounded(MPI_Channel *ch, void *data)
+{
+    // Hand over as many staged elements as the channel buffer can take
+    int staged = channel_flush_unbounded(ch);
+
+    if (staged == -1)
+        return -1;
+
+    // Element can only bypass the overflow segments if no element is staged
+    if (staged == 0)
+    {
+        int sent = (*ch->ptr_channel_trysend)(ch, data);
+
+        // Element has been sent or an error occured
+        if (sent != 0)
+            return sent;
+    }
+
+    // Channel buffer is full; stage element in overflow segment
+    if (segment_push(ch, data) != 1)
+    {
+        ERROR("Error in segment_push(): Element could not be staged\n");
+        return -1;
+    }
+
+    return 1;
+}
+
+// Hands over staged elements until the channel buffer is full; returns the number of elements still staged
+int channel_flush_unbounded(MPI_Channel *ch)
+{
+    void *elem;
+
+    while ((elem = segment_front(ch)) != NULL)
+    {
+        int sent = (*ch->ptr_channel_trysend)(ch, elem);
+
+        // Channel buffer is full or an error occured
+        if (sent != 1)
+            return sent == 0 ? ch->staged_items : -1;
+
+        if (segment_pop(ch) != 1)
+            return -1;
+    }
+
+    return 0;
+}
+
+// Hands over every staged element with blocking sends and releases the overflow segments and the log file
+int channel_drain_unbounded(MPI_Channel *ch)
+{
+    void *elem;
+
+    while ((elem = segment_front(ch)) != NULL)
+    {
+        if ((*ch->ptr_channel_send)(ch, elem) != 1)
+        {
+            ERROR("Error in channel_send(): Staged element could not be sent\n");
+            return -1;
+        }
+
+        if (segment_pop(ch) != 1)
+            return -1;
+    }
+
+    segment_free_all(ch);
+
+    return 1;
+}
+
+// Sends an element of a channel with priority levels to the lowest level
+int channel_send_prio_lowest(MPI_Channel *ch, void *data)
+{
+    return channel_send(ch->level_ch[0], data);
+}
+
+// Receives an element from a level without blocking; returns 1 if an element has been received and 0 if the level is 
+// empty
+int channel_tryreceive_level(MPI_Channel *ch, void *data)
+{
+    // Elements of RMA MPMC channels could be taken by another receiver between peeking and receiving
+    if (ch->ptr_channel_tryreceive != NULL)
+        return (*ch->ptr_channel_tryreceive)(ch, data);
+
+    // Every other receiver is the only one which can receive an element it has peeked at
+    int available = (*ch->ptr_channel_peek)(ch);
+
+    if (available <= 0)
+        return available;
+
+    return (*ch->ptr_channel_receive)(ch, data);
+}
+
+// Receives an element from the highest non-empty level; polls every level until an element can be received
+int channel_receive_prio(MPI_Channel *ch, void *data)
+{
+    int received;
+
+    while (1)
+    {
+        for (int level = ch->levels - 1; level >= 0; level--)
+        {
+            if ((received = channel_tryreceive_level(ch->level_ch[level], data)) != 0)
+                return received;
+        }
+
+        // No level holds an element yet; give the core to other processes in case of more processes than cores
+        sched_yield();
+    }
+}
+
+// Peeks at every level; returns the sum for receivers and the minimum for senders
+int channel_peek_prio(MPI_Channel *ch)
+{
+    int result = ch->is_receiver ? 0 : -1;
+
+    for (int level = 0; level < ch->levels; level++)
+    {
+        int peeked = channel_peek(ch->level_ch[level]);
+
+        if (peeked == -1)
+            return -1;
+
+        if (ch->is_receiver)
+            result += peeked;
+        else if (result == -1 || peeked < result)
+            result = peeked;
+    }
+
+    return result;
+}
+
+// Frees the channel of every level
+int channel_free_prio(MPI_Channel *ch)
+{
+    int error = 1;
+
+    for (int level = 0; level < ch->levels; level++)
+    {
+        if (channel_free(ch->level_ch[level]) != 1)
+            error = -1;
+    }
+
+    free(ch->level_ch);
+    free(ch);
+    ch = NULL;
+
+    return error;
+}
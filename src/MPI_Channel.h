@@ -38,14 +38,17 @@
  * In general, runtime experiments for MPICH and OpenMPI on clusters running on one and on different nodes have shown 
  * the following observations: PT2PT > RMA, SPSC > MPSC > MPMC, BUF > SYNC where ">" states a better runtime.
  * 
- * As an important side note: To make this channel implementation as portable as MPI itself, no threading library was 
- * used. This means that this implementation uses neither threads nor is it allowed to be run with multiple threads.
+ * As an important side note: A channel is only allowed to be used by multiple threads after channel_set_thread_safe() 
+ * has been called. The implementation starts no threads on its own; only channel_set_progress() and channel_ifree() 
+ * start an opt-in progress thread with POSIX threads which polls channels in the background. The library therefore 
+ * needs to be linked with -lpthread, and channels polled by the progress thread need MPI to be initialized with 
+ * MPI_THREAD_MULTIPLE, as do thread-safe channels. Other applications can keep any thread level of MPI.
  * 
  * To get error, warning or debug messages the corresponding flags can be set to either 1 or 0 in MPI_Channel_Struct.h
  * 
- * One of the main goals of this channel implementation is to preserve high portability going without a thread library
- * and to provide a channel implementation which is highly fair and starvation-free and gives the highest progress 
- * conditions possible taking efficiency into consideration (wait-free, etc.).
+ * One of the main goals of this channel implementation is to preserve high portability and to provide a channel 
+ * implementation which is highly fair and starvation-free and gives the highest progress conditions possible taking 
+ * efficiency into consideration (wait-free, etc.).
  * 
  */
 
@@ -55,6 +58,12 @@
 #include <stdbool.h>
 #include "mpi.h"
 
+// Maximum number of priority levels a channel can be allocated with
+#define MPI_CHANNEL_MAX_PRIO_LEVELS 8
+
+// Interval in microseconds in which the progress thread polls its channels
+#define MPI_CHANNEL_PROGRESS_INTERVAL 100
+
 // ****************************
 // CHANNELS STRUCTS AND ENUMS
 // ****************************
@@ -68,7 +77,9 @@ typedef enum MPI_Chan_type MPI_Channel_type;
  */
 typedef enum MPI_Comm_type {
     PT2PT,  /** Two sided communication */
-    RMA     /** One sided communication */
+    RMA,    /** One sided communication */
+    COLL,   /** Collective communication once per superstep */
+    THREADS /** Lock-free rings between the threads of a process */
 } MPI_Communication_type;
 #endif // MPI_COMM_TYPE
 
@@ -82,9 +93,11 @@ typedef struct MPI_Channel MPI_Channel;
  * @brief Allocates and returns a fully constructed MPI_Channel with passed parameter as channel properties
  * 
  * @param size The size of each data element the channel is supposed to transfer
- * @param capacity The capacity which determines if the channel is buffered (size > 0) and therefore asynchronous or 
- * unbuffered (size <= 0) and therefore synchronous
- * @param comm_type Determines the underlying communication of the channel. Can be either PT2PT or RMA.
+ * @param capacity The capacity which determines if the channel is buffered (size > 0) and therefore asynchronous, 
+ * unbuffered (size == 0) and therefore synchronous or unbounded (size < 0). Unbounded channels are buffered channels 
+ * with a capacity of -size whose senders never block: elements which do not fit into the channel buffer are staged in
+ * overflow segments of -size elements at the sender process
+ * @param comm_type Determines the underlying communication of the channel. Can be either PT2PT, RMA or COLL.
  * See the channel description for further details
  * @param comm The communicator of a group of processes. Every process of the communicator needs to call this 
  * function or else a deadlock will happen
@@ -107,9 +120,157 @@ typedef struct MPI_Channel MPI_Channel;
  * 
  * @note For each communication and channel type an own implementation is used. Therefore using different channel and
  * communication types can result in different runtimes
+ * 
+ * @note Channels with communication type COLL are superstep channels for bulk-synchronous codes: channel_send() only 
+ * stages the element for the next receiver (round robin) and channel_flush_superstep() delivers every staged element 
+ * at once. Receivers can only receive elements delivered by a flush. The capacity is the initial number of elements 
+ * staged per receiver; the staging buffer grows as needed
+ * 
+ * @note Staged elements of unbounded channels are handed over to the channel by the next channel_send(), 
+ * channel_peek() or channel_free() call of the sender process. Drained overflow segments are released except for one
+ * which is kept for the next burst.
 */
 MPI_Channel* channel_alloc(size_t size, int capacity, MPI_Communication_type comm_type, MPI_Comm comm, int is_receiver);
 
+/**
+ * @brief Allocates and returns a MPI_Channel like channel_alloc() whose receiver schedules the senders of a MPSC 
+ * channel by deficit round robin. Once the turn of a sender starts it gets its weight as deficit and the receiver 
+ * receives up to weight elements of this sender before it moves on to the next sender. A sender without pending 
+ * elements loses the rest of its turn.
+ * 
+ * @param size The size of each data element the channel is supposed to transfer
+ * @param capacity The capacity of the channel, see channel_alloc()
+ * @param weight The weight of the calling sender; needs to be positive. Ignored for receiver processes
+ * @param quota The maximum number of elements of the calling sender which are buffered in the channel at a time or 0
+ * for no quota. A quota larger than the capacity has no effect. Ignored for receiver processes
+ * @param comm_type Determines the underlying communication of the channel. Can be either PT2PT or RMA
+ * @param comm The communicator of a group of processes. Every process of the communicator needs to call this 
+ * function or else a deadlock will happen
+ * @param is_receiver This flag determines if the calling process is a receiver (is_receiver >= 1) or sender 
+ * (is_receiver <=0)
+ * 
+ * @return Returns a pointer to a MPI_Channel if allocation was successfull, NULL otherwise
+ * 
+ * @note Weights are honoured by the PT2PT MPSC channels and the RMA MPSC BUF channel, quotas by the MPSC BUF 
+ * channels. If the senders of a RMA MPSC BUF channel have different weights every sender gets a circular buffer of its
+ * own at the receiver process instead of the M&S queue.
+ * 
+ * @note channel_alloc() is equivalent to a call with weight 1 and no quota
+*/
+MPI_Channel* channel_alloc_weighted(size_t size, int capacity, int weight, int quota, 
+MPI_Communication_type comm_type, MPI_Comm comm, int is_receiver);
+
+/**
+ * @brief Allocates and returns a MPI_Channel like channel_alloc() which takes hints about its usage from an info object.
+ * The hints allow the channel implementation and MPI to choose faster paths
+ * 
+ * @param size The size of each data element the channel is supposed to transfer
+ * @param capacity The capacity of the channel, see channel_alloc()
+ * @param comm_type Determines the underlying communication of the channel. Can be either PT2PT, RMA or COLL
+ * @param comm The communicator of a group of processes. Every process of the communicator needs to call this 
+ * function with the same mpi_channel_ hints, otherwise the allocation fails on every process
+ * @param is_receiver This flag determines if the calling process is a receiver (is_receiver >= 1) or sender 
+ * (is_receiver <=0)
+ * @param info The hints or MPI_INFO_NULL. The info object is duplicated and can be freed after the call
+ * 
+ * @return Returns a pointer to a MPI_Channel if allocation was successfull, NULL otherwise
+ * 
+ * @note The following keys are honoured by the channel implementations:
+ *  - mpi_channel_fifo ("true" or "false", default "true"): "false" states that the elements of different senders of a
+ *    MPSC BUF channel do not need to be received in fair order. The PT2PT receiver receives the elements in arrival 
+ *    order instead of serving the senders round robin, every RMA sender gets a circular buffer of its own at the 
+ *    receiver process instead of the M&S queue
+ *  - mpi_channel_credits ("messages" or "rma", default "messages"): "rma" lets the receivers of PT2PT BUF channels 
+ *    return consumed elements with MPI_Accumulate() into a consumed counter in a small window of each sender instead 
+ *    of credit messages. Elements are still sent two-sided; the sender reads its credits locally without matching any
+ *    message. channel_free() becomes collective
+ *  - mpi_channel_sync ("requests" or "matchmaker", default "requests"): "matchmaker" lets the first receiver of a 
+ *    PT2PT MPMC SYNC channel pair waiting senders and receivers in arrival order instead of every sender sending send
+ *    requests and cancel messages to every receiver. Every pair costs at most three control messages, but the first
+ *    receiver has to keep calling channel functions while the channel is used
+ *  - mpi_channel_distribution ("push" or "pull", default "push"): "pull" lets every receiver of a PT2PT MPMC BUF 
+ *    channel post demands for capacity elements into a queue in the window of the first receiver; senders serve the 
+ *    oldest demand instead of choosing a receiver. Fast receivers take more elements. channel_free() becomes collective
+ * 
+ * @note The info object is also passed to MPI_Comm_dup_with_info() for the shadow comm of the channel and to 
+ * MPI_Win_create() of RMA channels, so MPI hints like accumulate_ordering or accumulate_ops reach MPI. Such hints are 
+ * assertions about every access of the channel implementation and need to hold for the implementation in use
+*/
+MPI_Channel* channel_alloc_info(size_t size, int capacity, MPI_Communication_type comm_type, MPI_Comm comm, 
+int is_receiver, MPI_Info info);
+
+/**
+ * @brief Allocates and returns a MPI_Channel of communication type THREADS between the threads of the calling process.
+ * The channel is a lock-free ring in the memory of the process which is implemented with C11 atomics: a ring with a 
+ * head and a tail index for a single sender and receiver thread (SPSC) and a ring with a sequence number per slot 
+ * (Vyukov) for multiple sender threads (MPSC) or multiple sender and receiver threads (MPMC). Every thread uses the 
+ * returned channel with channel_send(), channel_receive() and channel_peek()
+ * 
+ * @param size The size of each data element the channel is supposed to transfer
+ * @param capacity The capacity of the channel; needs to be positive
+ * @param senders The number of threads which send elements; needs to be positive
+ * @param receivers The number of threads which receive elements; needs to be positive
+ * 
+ * @return Returns a pointer to a MPI_Channel if allocation was successfull, NULL otherwise
+ * 
+ * @note This function is not collective and does not need MPI to be initialized. channel_send() blocks while the ring
+ * is full and channel_receive() while it is empty; channel_peek() returns the number of elements which can be received
+ * for every thread, see channel_peek(). More sender or receiver threads than passed lead to undefined behaviour
+*/
+MPI_Channel* channel_alloc_threads(size_t size, int capacity, int senders, int receivers);
+
+/**
+ * @brief Allocates and returns a buffered MPI_Channel with the passed number of priority levels. Each level is a 
+ * channel of its own with the passed capacity, i.e. a queue of its own for RMA and a message context of its own for 
+ * PT2PT. Elements are sent to a level with channel_send_prio(); receivers always receive from the highest non-empty 
+ * level so latency-critical elements are not stuck behind a deep queue of bulk elements
+ * 
+ * @param size The size of each data element the channel is supposed to transfer
+ * @param capacity The capacity of each priority level; needs to be nonzero. A negative capacity allocates unbounded 
+ * priority levels
+ * @param levels The number of priority levels between 1 and MPI_CHANNEL_MAX_PRIO_LEVELS; level 0 is the lowest level
+ * @param comm_type Determines the underlying communication of the channel. Can be either PT2PT or RMA
+ * @param comm The communicator of a group of processes. Every process of the communicator needs to call this 
+ * function with the same size, capacity and levels or else NULL is returned
+ * @param is_receiver This flag determines if the calling process is a receiver (is_receiver >= 1) or sender 
+ * (is_receiver <=0)
+ * 
+ * @return Returns a pointer to a MPI_Channel if allocation was successfull, NULL otherwise
+ * 
+ * @note A call with one priority level is equivalent to channel_alloc(). Synchronous channels cannot have priority 
+ * levels.
+ * 
+ * @note Within a level elements keep their order; elements of different levels are not ordered. Lower levels might 
+ * starve as long as higher levels receive elements.
+*/
+MPI_Channel* channel_alloc_prio(size_t size, int capacity, int levels, MPI_Communication_type comm_type, MPI_Comm comm,
+int is_receiver);
+
+/**
+ * @brief Allocates and returns a MPI_Channel which combines the elements of its senders. The channel proceeds in 
+ * epochs: every sender contributes exactly one element per epoch with channel_send() and the receiver receives the
+ * element combined with the passed operation over every sender with channel_receive(). For RMA the senders accumulate
+ * their elements directly into the window of the receiver instead of enqueueing them
+ * 
+ * @param count The number of elements of the datatype in each data element
+ * @param datatype The datatype of the elements; needs to be contiguous with a lower bound of 0 and an extent equal to 
+ * its size, otherwise the allocation fails on every process
+ * @param op The operation combining the elements. For RMA it needs to be a predefined operation of MPI 
+ * @param capacity The number of epochs a sender can be ahead of the receiver; needs to be positive
+ * @param comm_type Determines the underlying communication of the channel. Can be either PT2PT or RMA
+ * @param comm The communicator of a group of processes. Every process of the communicator needs to call this 
+ * function with the same count, datatype, op and capacity or else the behaviour is undefined
+ * @param is_receiver This flag determines if the calling process is a receiver (is_receiver >= 1) or sender 
+ * (is_receiver <=0)
+ * 
+ * @return Returns a pointer to a MPI_Channel if allocation was successfull, NULL otherwise
+ * 
+ * @note Reduction channels need exactly one receiver. channel_peek() returns the number of epochs the sender can 
+ * contribute to and the number of complete epochs at the receiver (at most 1 for PT2PT)
+*/
+MPI_Channel* channel_alloc_reduce(int count, MPI_Datatype datatype, MPI_Op op, int capacity, 
+MPI_Communication_type comm_type, MPI_Comm comm, int is_receiver);
+
 /** 
  * @brief Sends the numbers of bytes of a data element specified in channel_alloc() starting at the adress the void 
  * pointer holds into the channel. If the capacity of the channel is 1 or smaller a call to channel_send() will block
@@ -127,6 +288,21 @@ MPI_Channel* channel_alloc(size_t size, int capacity, MPI_Communication_type com
 */
 int channel_send(MPI_Channel *ch, void *data);
 
+/** 
+ * @brief Sends an element into the passed priority level of the channel. Apart from the level it behaves like 
+ * channel_send(), which sends to level 0
+ * 
+ * @param[in] ch Pointer to a MPI_Channel allocated with channel_alloc() or channel_alloc_prio()              
+ * @param[in] data Pointer to a memory adress of which size bytes will be sent from
+ * @param[in] level Priority level between 0 and the number of levels - 1; higher levels are received first
+ * 
+ * @return Returns 1 if sending was successful and -1 if an error occures
+ * 
+ * @note The reasons for errors are either internal problems with MPI related functions or wrong usage of this function
+ * (e.g. passing a NULL pointer or an invalid level)
+*/
+int channel_send_prio(MPI_Channel *ch, void *data, int level);
+
 /**
  * @brief Receives the numbers of bytes of a data element specified in channel_alloc() from the channel and stores them
  * starting at the adress the void pointer holds. Analogous to channel_send() a call of this function will block if the
@@ -158,8 +334,23 @@ int channel_receive(MPI_Channel *ch, void *data);
  * @return Returns a positive number if elements can be sent or received and -1 if an error occures. See channel_peek()
  * description for further details on the return value.
  * 
- * @warning This function will only work for asychronous/buffered channels! For synchronous/unbuffered channels
- * channel_peek() will always return 1!
+ * @note For synchronous/unbuffered channels channel_peek() returns 1 if a matching partner is waiting and 0 otherwise.
+ * Receiver processes of PT2PT channels probe for a pending send, receiver processes of RMA channels check for a
+ * registered sender. Sender processes only get a real answer for RMA MPMC channels, where receivers register at the
+ * first receiver, and 1 otherwise since receivers of the other channels do not announce themselves. RMA SPSC SYNC 
+ * channels rely on MPI_Win_fence() and do not support channel_peek(), it returns -1.
+ * 
+ * @note If the sender process of an unbounded channel calls channel_peek() staged elements are handed over to the 
+ * channel first. Since sending never blocks, the number of free slots of the channel buffer or, if the channel buffer 
+ * is full, the size of an overflow segment is returned.
+ * 
+ * @note For channels with priority levels the receiver process gets the sum over every level and the sender process
+ * the minimum over every level, i.e. the number of elements which can be sent to any level without blocking.
+ * 
+ * @note Channels of communication type THREADS are shared by every thread of the process and do not know whether the
+ * calling thread sends or receives. channel_peek() returns the number of elements a receiver thread can take without 
+ * blocking for every thread; MPSC and MPMC rings only count elements whose sender has published them. A sender thread 
+ * can send at most the capacity minus the returned number of elements without blocking.
  * 
  * @warning If PT2PT is used as communication type a call to channel_peek() after a call to channel_send() or 
  * channel_receive() with the same channel might still lead to an unchanged return value. This is due to the fact that
@@ -171,6 +362,22 @@ int channel_receive(MPI_Channel *ch, void *data);
 */
 int channel_peek(MPI_Channel *ch);
 
+/**
+ * @brief Exchanges every staged element of a superstep channel (communication type COLL) between its senders and 
+ * receivers with a single neighborhood collective. Afterwards the receiver processes receive the delivered elements 
+ * with channel_receive() until channel_peek() returns 0
+ * 
+ * @param[in] ch Pointer to a MPI_Channel allocated with communication type COLL
+ * 
+ * @return Returns the number of elements sent (sender process calls) or delivered (receiver process calls) and -1 if 
+ * an error occures
+ * 
+ * @warning Every process of the channel needs to call channel_flush_superstep() or else a deadlock will happen
+ * 
+ * @note Elements a receiver has not received before the flush are kept in front of the delivered elements
+*/
+int channel_flush_superstep(MPI_Channel *ch);
+
 /** 
  * @brief Deallocates the passed MPI_Channel and frees all resources used for channel communication. Depending on the
  * used communication and channel type a call of channel_free() might fail: only freeing PT2PT BUF channels might lead
@@ -180,11 +387,95 @@ int channel_peek(MPI_Channel *ch);
  * 
  * @return Returns 1 if deallocation was succesfull and -1 if an error occures
  * 
- * @note The reasons for errors are the usage of MPI's buffered send mode and the appending and shrinking of the 
- * buffer.
+ * @note The reasons for errors are messages in transit which cannot be completed and, for PT2PT MPMC SYNC channels, 
+ * the shrinking of the buffer of MPI's buffered send mode.
+ * 
+ * @note The sender process of an unbounded channel blocks until every staged element has been sent.
 */
 int channel_free(MPI_Channel *ch);
 
+/** 
+ * @brief Starts the deallocation of the passed MPI_Channel and returns immediately. The progress thread of the calling
+ * process hands over staged elements, consumes outstanding acknowledgement messages and frees the channel once every 
+ * process of the channel has started its deallocation, so the collective release of the channel does not wait for 
+ * slower processes
+ * 
+ * @param[in, out] ch Pointer to a MPI_Channel allocated with channel_alloc()
+ * @param[out] request Generalized request which completes once the channel has been freed
+ * 
+ * @return Returns 1 if the deallocation has been started and -1 if an error occures
+ * 
+ * @warning The channel must not be used after channel_ifree() has been called. Every process of the channel needs to 
+ * call channel_ifree() or channel_free(), and channels need to be freed in the same order on every process
+ * 
+ * @note The request is completed with MPI_ERR_OTHER if the deallocation failed and can be waited for or tested with 
+ * MPI_Wait() and MPI_Test() together with other requests
+ * 
+ * @note The progress thread needs MPI to be initialized with MPI_THREAD_MULTIPLE. Otherwise and for channels with 
+ * communication type THREADS the channel is freed by channel_ifree() itself and the returned request is already 
+ * completed
+*/
+int channel_ifree(MPI_Channel *ch, MPI_Request *request);
+
+/**
+ * @brief Lets the sender process of a buffered channel spill elements to a log file if the channel buffer is full. 
+ * Up to mem_limit elements are staged in memory, further elements are appended to an unlinked log file in the passed
+ * directory which is mapped chunkwise and read back in order. A bounded channel does not block on channel_send() 
+ * afterwards.
+ * 
+ * @param[in, out] ch Pointer to a MPI_Channel allocated with channel_alloc()
+ * @param[in] dir Directory the log file is created in, e.g. a node-local scratch directory
+ * @param[in] mem_limit Number of elements staged in memory before elements are spilled to the log file
+ * 
+ * @return Returns 1 if the log file has been created and -1 if an error occures
+ * 
+ * @note The reasons for errors are either a failed creation of the log file or wrong usage of this function (e.g. 
+ * calling it as receiver process or on a synchronous channel)
+ * 
+ * @note The log file is truncated whenever it is drained and released by channel_free()
+*/
+int channel_set_spill(MPI_Channel *ch, const char *dir, int mem_limit);
+
+/**
+ * @brief Allows multiple threads of the calling process to call channel_send(), channel_send_prio(), channel_receive(),
+ * channel_peek() and channel_flush_superstep() on the passed channel concurrently. Each thread publishes its call on a
+ * lock-free stack of the channel; the thread which finds no other thread executing calls executes every published call
+ * back to back in publication order, so calls of different threads never race on the state of the channel and no 
+ * thread is handed the channel per element
+ * 
+ * @param[in, out] ch Pointer to a MPI_Channel allocated with channel_alloc()
+ * 
+ * @return Returns 1 if the channel is thread-safe and -1 if an error occures
+ * 
+ * @note MPI needs to be initialized with MPI_THREAD_MULTIPLE. This function needs to be called before the channel is
+ * used by multiple threads, channel_set_spill() and channel_free() are not thread-safe
+ * 
+ * @note A thread whose call blocks (e.g. channel_send() on a full channel) delays the calls of the other threads of 
+ * the process until it returns
+ *
+ * @note Combining only serializes the calls; every element of a batch is still transferred with MPI operations of its
+ * own, so consecutive sends of different threads to the same receiver are not merged into one message
+*/
+int channel_set_thread_safe(MPI_Channel *ch);
+
+/**
+ * @brief Lets a background thread of the calling process poll the passed channel every MPI_CHANNEL_PROGRESS_INTERVAL 
+ * microseconds while the application computes. Buffered PT2PT senders consume acknowledgement messages, so credits 
+ * are waiting at the next channel_send(), unbounded senders hand over staged elements and RMA channels enter MPI, so 
+ * pending RMA operations of other processes progress
+ * 
+ * @param[in, out] ch Pointer to a MPI_Channel allocated with channel_alloc()
+ * 
+ * @return Returns 1 if the channel is polled by the progress thread and -1 if an error occures
+ * 
+ * @note The channel is made thread-safe with channel_set_thread_safe(), so MPI needs to be initialized with 
+ * MPI_THREAD_MULTIPLE. The progress thread is started with the first channel and stops once the last channel has 
+ * been freed
+ * 
+ * @note The progress thread skips a channel while a thread of the application uses it
+*/
+int channel_set_progress(MPI_Channel *ch);
+
 // ****************************
 // CHANNELS UTIL FUNCTIONS 
 // ****************************
@@ -200,7 +491,8 @@ size_t channel_elem_size(MPI_Channel *ch);
 /**
  * @brief Checks if the passed channel is buffered or not
  * @param[in, out] ch Pointer to a MPI_Channel allocated with channel_alloc()              
- * @return Returns the capacity of the channel if it's buffered, 0 otherwise 
+ * @return Returns the capacity of the channel if it's buffered, the negative segment size if it's unbounded, 0 
+ * otherwise 
  * @note This function cannot fail and is therefore marked as NOTHROW
  */
 int channel_capacity(MPI_Channel *ch);
@@ -216,7 +508,7 @@ int channel_type(MPI_Channel *ch);
 /**
  * @brief Checks which communication type is used
  * @param[in, out] ch Pointer to a MPI_Channel allocated with channel_alloc()              
- * @return Returns 0 for PT2PT and 1 for RMA
+ * @return Returns the communication type of the channel, i.e. 0 for PT2PT, 1 for RMA, 2 for COLL and 3 for THREADS
  * @note This function cannot fail and is therefore marked as NOTHROW
  */
 int channel_comm_type(MPI_Channel *ch);
@@ -9,11 +9,24 @@
  * 
  */
 
+// Needed for fallocate() which releases the consumed chunks of the log file
+#define _GNU_SOURCE
+
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
 
 #include "MPI_Channel_Struct.h"
 
+// Approximate size of a mapped chunk of the log file in byte
+#define SPILL_CHUNK_SIZE (4 << 20)
+
+static int spill_push(MPI_Channel *ch, void *data);
+static int spill_pop(MPI_Channel *ch);
+
 int append_buffer(int to_append)
 {
     // Get the size and address of the old buffer
@@ -210,4 +223,836 @@ int shrink_buffer(int to_shrink)
         WARNING("Old buffer has been attached again\n");
         return -1;
     }
+}
+
+int send_slots_alloc(MPI_Channel *ch, int count, size_t slot_size)
+{
+    ch->send_slot_count = count;
+    ch->send_slot_size = slot_size;
+    ch->send_next = 0;
+    ch->send_persistent = 0;
+    ch->send_slots = malloc(count * slot_size + 1);
+    ch->send_requests = malloc(count * sizeof(*ch->send_requests));
+    ch->send_indices = malloc(count * sizeof(*ch->send_indices));
+    ch->send_busy = calloc(count, sizeof(*ch->send_busy));
+
+    if (ch->send_slots == NULL || ch->send_requests == NULL || ch->send_indices == NULL || ch->send_busy == NULL)
+    {
+        ERROR("Error in malloc(): Memory for send slots could not be allocated\n");
+        free(ch->send_slots);
+        free(ch->send_requests);
+        free(ch->send_indices);
+        free(ch->send_busy);
+        return -1;
+    }
+
+    // Every slot is free
+    for (int i = 0; i < count; i++)
+        ch->send_requests[i] = MPI_REQUEST_NULL;
+
+    return 1;
+}
+
+int send_slots_persist(MPI_Channel *ch, size_t size, int dest)
+{
+    for (int i = 0; i < ch->send_slot_count; i++)
+    {
+        if (MPI_Send_init(size > 0 ? ch->send_slots + i * ch->send_slot_size : NULL, (int) size, MPI_BYTE, dest, 0, ch->comm, 
+        &ch->send_requests[i]) != MPI_SUCCESS)
+        {
+            ERROR("Error in MPI_Send_init()\n");
+
+            // Release the persistent requests created so far
+            while (i-- > 0)
+                MPI_Request_free(&ch->send_requests[i]);
+
+            return -1;
+        }
+    }
+
+    ch->send_persistent = 1;
+
+    return 1;
+}
+
+int send_slots_isend(MPI_Channel *ch, void *data, size_t size, int dest)
+{
+    int slot = ch->send_next;
+
+    // Reclaim every completed slot if the next slot of the ring is still in transit
+    if (ch->send_busy[slot])
+    {
+        int outcount;
+
+        if (MPI_Testsome(ch->send_slot_count, ch->send_requests, &outcount, ch->send_indices, MPI_STATUSES_IGNORE) 
+        != MPI_SUCCESS)
+        {
+            ERROR("Error in MPI_Testsome()\n");
+            return -1;
+        }
+
+        // Every slot is in transit; wait until one of them completes
+        if (outcount == 0 && MPI_Waitsome(ch->send_slot_count, ch->send_requests, &outcount, ch->send_indices, 
+        MPI_STATUSES_IGNORE) != MPI_SUCCESS)
+        {
+            ERROR("Error in MPI_Waitsome()\n");
+            return -1;
+        }
+
+        for (int i = 0; i < outcount; i++)
+            ch->send_busy[ch->send_indices[i]] = 0;
+
+        // Continue the ring after the first reclaimed slot unless the next slot completed as well
+        if (ch->send_busy[slot])
+            slot = ch->send_indices[0];
+    }
+
+    // Copy element into the slot, so the caller can reuse its buffer
+    char *buf = ch->send_slots + slot * ch->send_slot_size;
+    if (size > 0)
+        memcpy(buf, data, size);
+
+    // Persistent requests are already bound to their slot and destination
+    if (ch->send_persistent)
+    {
+        if (MPI_Start(&ch->send_requests[slot]) != MPI_SUCCESS)
+        {
+            ERROR("Error in MPI_Start()\n");
+            return -1;
+        }
+    }
+    else if (MPI_Isend(size > 0 ? buf : NULL, (int) size, MPI_BYTE, dest, 0, ch->comm, &ch->send_requests[slot]) 
+    != MPI_SUCCESS)
+    {
+        ERROR("Error in MPI_Isend()\n");
+        return -1;
+    }
+
+    ch->send_busy[slot] = 1;
+    ch->send_next = (slot + 1) % ch->send_slot_count;
+
+    return 1;
+}
+
+int send_slots_free(MPI_Channel *ch)
+{
+    int error = 1;
+
+    // Messages in transit have to complete before their slots are released
+    if (MPI_Waitall(ch->send_slot_count, ch->send_requests, MPI_STATUSES_IGNORE) != MPI_SUCCESS)
+    {
+        ERROR("Error in MPI_Waitall(): Messages in transit could not be completed\n");
+        error = -1;
+    }
+
+    // Persistent requests stay allocated after completion
+    if (ch->send_persistent)
+    {
+        for (int i = 0; i < ch->send_slot_count; i++)
+            MPI_Request_free(&ch->send_requests[i]);
+    }
+
+    free(ch->send_slots);
+    free(ch->send_requests);
+    free(ch->send_indices);
+    free(ch->send_busy);
+    ch->send_slots = NULL;
+    ch->send_requests = NULL;
+    ch->send_indices = NULL;
+    ch->send_busy = NULL;
+
+    return error;
+}
+
+int credits_return(MPI_Channel *ch, int sender)
+{
+    int arrived;
+
+    // Count the consumed element
+    ch->credits[sender]++;
+
+    // Keep accumulating until the batch is complete
+    if (ch->credits[sender] < ch->credit_batch)
+    {
+        // The sender might wait for the credit if its next element has not arrived yet
+        if ((arrived = recv_slots_ready(ch, sender)) == -1)
+        {
+            ERROR("Error in recv_slots_ready()\n");
+            return -1;
+        }
+
+        // The sender might also wait if every element it can have at the receiver has arrived or is held back; only
+        // hold the credit back while the sender still has room to send
+        if (arrived > 0 && arrived + ch->credits[sender] < ch->credit_limits[sender])
+            return 1;
+    }
+
+    // Return every consumed element of the sender in one credit
+    if (credits_send(ch, ch->sender_ranks[sender], ch->credits[sender]) != 1)
+    {
+        ERROR("Error in credits_send()\n");
+        return -1;
+    }
+
+    ch->credits[sender] = 0;
+
+    return 1;
+}
+
+int credits_send(MPI_Channel *ch, int dest, int count)
+{
+    // Credit messages are sent from a send slot
+    if (!ch->rma_credits)
+    {
+        if (send_slots_isend(ch, &count, sizeof(int), dest) != 1)
+        {
+            ERROR("Error in send_slots_isend(): Credit message could not be sent\n");
+            return -1;
+        }
+
+        return 1;
+    }
+
+    // Add the credit to the consumed counter of the calling receiver at the sender
+    if (MPI_Accumulate(&count, 1, MPI_INT, dest, ch->credit_disp, 1, MPI_INT, MPI_SUM, ch->credit_win) != MPI_SUCCESS)
+    {
+        ERROR("Error in MPI_Accumulate()\n");
+        return -1;
+    }
+
+    // Complete the accumulate at the sender, which might wait for the credit
+    if (MPI_Win_flush(dest, ch->credit_win) != MPI_SUCCESS)
+    {
+        ERROR("Error in MPI_Win_flush()\n");
+        return -1;
+    }
+
+    return 1;
+}
+
+int credits_collect(MPI_Channel *ch, int receiver, int block)
+{
+    int collected = 0;
+    int consumed;
+
+    // One-sided credits are read from the local consumed counter of the receiver
+    if (ch->rma_credits)
+    {
+        do
+        {
+            // Check MPI Memory Model for further information
+            // Ensure that memory is updated
+            if (MPI_Win_sync(ch->credit_win) != MPI_SUCCESS)
+            {
+                ERROR("Error in MPI_Win_sync()\n");
+                return -1;
+            }
+
+            // Take a snapshot of the counter; counters wrap around and the difference stays valid
+            consumed = ch->credit_lmem[receiver];
+            collected = (int) ((unsigned) consumed - (unsigned) ch->credit_seen[receiver]);
+        } while (block && collected == 0);
+
+        ch->credit_seen[receiver] = consumed;
+
+        return collected;
+    }
+
+    // Wait for the first credit message or check for one
+    if (block)
+    {
+        if (MPI_Mprobe(ch->receiver_ranks[receiver], 0, ch->comm, &ch->message, MPI_STATUS_IGNORE) != MPI_SUCCESS)
+        {
+            ERROR("Error in MPI_Mprobe(): Probing for credit messages failed\n");
+            return -1;
+        }
+
+        ch->flag = 1;
+    }
+    else if (MPI_Improbe(ch->receiver_ranks[receiver], 0, ch->comm, &ch->flag, &ch->message, MPI_STATUS_IGNORE) 
+    != MPI_SUCCESS)
+    {
+        ERROR("Error in MPI_Improbe(): Probing for credit messages failed\n");
+        return -1;
+    }
+
+    // Receive every credit message which has arrived
+    while (ch->flag)
+    {
+        if (MPI_Mrecv(&ch->credit, 1, MPI_INT, &ch->message, MPI_STATUS_IGNORE) != MPI_SUCCESS)
+        {
+            ERROR("Error in MPI_Mrecv(): Credit message could not be received\n");
+            return -1;
+        }
+
+        collected += ch->credit;
+
+        // Check for more credit messages
+        if (MPI_Improbe(ch->receiver_ranks[receiver], 0, ch->comm, &ch->flag, &ch->message, MPI_STATUS_IGNORE) 
+        != MPI_SUCCESS)
+        {
+            ERROR("Error in MPI_Improbe(): Probing for credit messages failed\n");
+            return -1;
+        }
+    }
+
+    return collected;
+}
+
+int credit_win_alloc(MPI_Channel *ch)
+{
+    // Senders expose one consumed counter per receiver; counters start at 0 before any receiver can access them
+    int count = ch->is_receiver ? 0 : ch->receiver_count;
+    ch->credit_lmem = calloc(count + 1, sizeof(int));
+    ch->credit_seen = calloc(count + 1, sizeof(int));
+
+    if (ch->credit_lmem == NULL || ch->credit_seen == NULL)
+    {
+        ERROR("Error in calloc(): Memory for credit counters could not be allocated\n");
+        free(ch->credit_lmem);
+        free(ch->credit_seen);
+        return -1;
+    }
+
+    // The index of a receiver is the displacement of its counter in the windows of the senders
+    ch->credit_disp = 0;
+    for (int i = 0; i < ch->receiver_count; i++)
+    {
+        if (ch->receiver_ranks[i] == ch->my_rank)
+            ch->credit_disp = i;
+    }
+
+    if (MPI_Win_create(ch->credit_lmem, count * sizeof(int), sizeof(int), ch->info, ch->comm, &ch->credit_win) 
+    != MPI_SUCCESS)
+    {
+        ERROR("Error in MPI_Win_create()\n");
+        free(ch->credit_lmem);
+        free(ch->credit_seen);
+        return -1;
+    }
+
+    // Keep a shared lock on every process for the lifetime of the channel
+    if (MPI_Win_lock_all(0, ch->credit_win) != MPI_SUCCESS)
+    {
+        ERROR("Error in MPI_Win_lock_all()\n");
+        MPI_Win_free(&ch->credit_win);
+        free(ch->credit_lmem);
+        free(ch->credit_seen);
+        return -1;
+    }
+
+    return 1;
+}
+
+void credit_win_free(MPI_Channel *ch)
+{
+    // Should be nothrow since the window has been locked successfully
+    MPI_Win_unlock_all(ch->credit_win);
+    MPI_Win_free(&ch->credit_win);
+
+    free(ch->credit_lmem);
+    free(ch->credit_seen);
+    ch->credit_lmem = NULL;
+    ch->credit_seen = NULL;
+}
+
+int recv_slots_alloc(MPI_Channel *ch, int count)
+{
+    int total = count * ch->sender_count;
+
+    ch->recv_slot_count = count;
+    ch->recv_slots = malloc(total * ch->data_size + 1);
+    ch->recv_requests = malloc(total * sizeof(*ch->recv_requests));
+    ch->recv_heads = calloc(ch->sender_count, sizeof(*ch->recv_heads));
+    ch->recv_waits = malloc(ch->sender_count * sizeof(*ch->recv_waits));
+    ch->recv_arrived = calloc(ch->sender_count, sizeof(*ch->recv_arrived));
+    ch->recv_indices = malloc(ch->sender_count * sizeof(*ch->recv_indices));
+    ch->credits = calloc(ch->sender_count, sizeof(*ch->credits));
+    ch->credit_limits = malloc(ch->sender_count * sizeof(*ch->credit_limits));
+
+    // Return the credit once half of the slots of a sender have been consumed
+    ch->credit_batch = (count + 1) / 2;
+
+    if (ch->recv_slots == NULL || ch->recv_requests == NULL || ch->recv_heads == NULL || ch->recv_waits == NULL || 
+    ch->recv_arrived == NULL || ch->recv_indices == NULL || ch->credits == NULL || ch->credit_limits == NULL)
+    {
+        ERROR("Error in malloc(): Memory for receive slots could not be allocated\n");
+        free(ch->recv_slots);
+        free(ch->recv_requests);
+        free(ch->recv_heads);
+        free(ch->recv_waits);
+        free(ch->recv_arrived);
+        free(ch->recv_indices);
+        free(ch->credits);
+        free(ch->credit_limits);
+        return -1;
+    }
+
+    // Every sender can fill all of its slots before it blocks unless the channel lowers the limit
+    for (int i = 0; i < ch->sender_count; i++)
+        ch->credit_limits[i] = count;
+
+    // Slots of a sender are consecutive; receives with the same source are matched in the order they are posted
+    for (int i = 0; i < total; i++)
+    {
+        if (MPI_Recv_init(ch->recv_slots + i * ch->data_size, ch->data_size, MPI_BYTE, ch->sender_ranks[i / count], 0, 
+        ch->comm, &ch->recv_requests[i]) != MPI_SUCCESS)
+        {
+            ERROR("Error in MPI_Recv_init()\n");
+
+            // Release the persistent requests created so far
+            while (i-- > 0)
+                MPI_Request_free(&ch->recv_requests[i]);
+
+            free(ch->recv_slots);
+            free(ch->recv_requests);
+            free(ch->recv_heads);
+            free(ch->recv_waits);
+            free(ch->recv_arrived);
+            free(ch->recv_indices);
+            free(ch->credits);
+            free(ch->credit_limits);
+            return -1;
+        }
+    }
+
+    // The first slot of every sender holds its oldest element; persistent request handles stay valid on completion
+    for (int i = 0; i < ch->sender_count; i++)
+        ch->recv_waits[i] = ch->recv_requests[i * count];
+
+    // Pre-post every receive
+    if (MPI_Startall(total, ch->recv_requests) != MPI_SUCCESS)
+    {
+        ERROR("Error in MPI_Startall()\n");
+        recv_slots_free(ch);
+        return -1;
+    }
+
+    return 1;
+}
+
+int recv_slots_ready(MPI_Channel *ch, int sender)
+{
+    int ready = 0;
+    int flag = 1;
+
+    // Count arrived elements starting from the oldest slot; MPI_Request_get_status() keeps the requests active
+    while (flag && ready < ch->recv_slot_count)
+    {
+        int slot = sender * ch->recv_slot_count + (ch->recv_heads[sender] + ready) % ch->recv_slot_count;
+
+        if (MPI_Request_get_status(ch->recv_requests[slot], &flag, MPI_STATUS_IGNORE) != MPI_SUCCESS)
+        {
+            ERROR("Error in MPI_Request_get_status()\n");
+            return -1;
+        }
+
+        ready += flag;
+    }
+
+    return ready;
+}
+
+int recv_slots_receive(MPI_Channel *ch, void *data, int sender)
+{
+    int slot = sender * ch->recv_slot_count + ch->recv_heads[sender];
+
+    // Wait for the element of the oldest slot
+    if (MPI_Wait(&ch->recv_requests[slot], MPI_STATUS_IGNORE) != MPI_SUCCESS)
+    {
+        ERROR("Error in MPI_Wait()\n");
+        return -1;
+    }
+
+    memcpy(data, ch->recv_slots + slot * ch->data_size, ch->data_size);
+
+    // Post the receive of the slot again; it becomes the youngest slot of the sender
+    if (MPI_Start(&ch->recv_requests[slot]) != MPI_SUCCESS)
+    {
+        ERROR("Error in MPI_Start()\n");
+        return -1;
+    }
+
+    ch->recv_heads[sender] = (ch->recv_heads[sender] + 1) % ch->recv_slot_count;
+
+    // The next slot holds the oldest element of the sender now; it has not been tested yet
+    ch->recv_waits[sender] = ch->recv_requests[sender * ch->recv_slot_count + ch->recv_heads[sender]];
+    ch->recv_arrived[sender] = 0;
+
+    return 1;
+}
+
+int recv_slots_test(MPI_Channel *ch)
+{
+    int outcount = 0;
+    int ready = 0;
+
+    // Test the oldest slot of every sender at once; slots which already completed are inactive and ignored
+    if (MPI_Testsome(ch->sender_count, ch->recv_waits, &outcount, ch->recv_indices, MPI_STATUSES_IGNORE) 
+    != MPI_SUCCESS)
+    {
+        ERROR("Error in MPI_Testsome()\n");
+        return -1;
+    }
+
+    // Remember the completed slots; outcount is MPI_UNDEFINED if every slot had completed before
+    for (int i = 0; i < outcount && outcount != MPI_UNDEFINED; i++)
+        ch->recv_arrived[ch->recv_indices[i]] = 1;
+
+    for (int i = 0; i < ch->sender_count; i++)
+        ready += ch->recv_arrived[i];
+
+    return ready;
+}
+
+int recv_slots_wait(MPI_Channel *ch)
+{
+    int ready = recv_slots_test(ch);
+    int index;
+
+    // An element has arrived or an error occured
+    if (ready != 0)
+        return ready;
+
+    // Block until the oldest element of any sender arrives
+    if (MPI_Waitany(ch->sender_count, ch->recv_waits, &index, MPI_STATUS_IGNORE) != MPI_SUCCESS)
+    {
+        ERROR("Error in MPI_Waitany()\n");
+        return -1;
+    }
+
+    ch->recv_arrived[index] = 1;
+
+    return 1;
+}
+
+void recv_slots_free(MPI_Channel *ch)
+{
+    // Cancel pre-posted receives; receives which have already completed are not affected
+    for (int i = 0; i < ch->recv_slot_count * ch->sender_count; i++)
+    {
+        // Oldest slots completed by recv_slots_test() are inactive and must not be cancelled
+        int sender = i / ch->recv_slot_count;
+        if (!ch->recv_arrived[sender] || i != sender * ch->recv_slot_count + ch->recv_heads[sender])
+        {
+            MPI_Cancel(&ch->recv_requests[i]);
+            MPI_Wait(&ch->recv_requests[i], MPI_STATUS_IGNORE);
+        }
+        MPI_Request_free(&ch->recv_requests[i]);
+    }
+
+    free(ch->recv_slots);
+    free(ch->recv_requests);
+    free(ch->recv_heads);
+    free(ch->recv_waits);
+    free(ch->recv_arrived);
+    free(ch->recv_indices);
+    free(ch->credits);
+    free(ch->credit_limits);
+    ch->recv_slots = NULL;
+    ch->recv_requests = NULL;
+    ch->recv_heads = NULL;
+}
+
+int segment_push(MPI_Channel *ch, void *data)
+{
+    MPI_Channel_segment *seg = ch->seg_tail;
+
+    // Append to the log file if enough elements are staged in memory; once the log file is used every new element is 
+    // appended to it until it is drained to preserve the order of elements
+    if (ch->spill != NULL && (ch->spill->items > 0 || ch->staged_items >= ch->spill_limit))
+        return spill_push(ch, data);
+
+    // Chain a new segment if there is none or the youngest segment is full
+    if (seg == NULL || seg->write == ch->capacity)
+    {
+        // Reuse the spare segment if available
+        if (ch->seg_spare != NULL)
+        {
+            seg = ch->seg_spare;
+            ch->seg_spare = NULL;
+        }
+        else if ((seg = malloc(sizeof(*seg) + ch->capacity * ch->data_size)) == NULL)
+        {
+            ERROR("Error in malloc(): Overflow segment could not be allocated\n");
+            return -1;
+        }
+
+        seg->next = NULL;
+        seg->read = seg->write = 0;
+
+        // Append segment to the chain
+        if (ch->seg_tail != NULL)
+            ch->seg_tail->next = seg;
+        else
+            ch->seg_head = seg;
+        ch->seg_tail = seg;
+    }
+
+    // Copy element into the next free slot
+    memcpy(seg->data + seg->write * ch->data_size, data, ch->data_size);
+    seg->write++;
+
+    ch->staged_items++;
+
+    return 1;
+}
+
+void *segment_front(MPI_Channel *ch)
+{
+    MPI_Channel_segment *seg = ch->seg_head;
+
+    // Overflow segments are drained
+    if (seg == NULL || seg->read == seg->write)
+    {
+        // Continue with the log file; its current chunk is always mapped while it stores elements
+        if (ch->spill != NULL && ch->spill->items > 0)
+            return ch->spill->read_map + (ch->spill->read_off - ch->spill->read_map_off);
+
+        // No element is staged
+        return NULL;
+    }
+
+    return seg->data + seg->read * ch->data_size;
+}
+
+int segment_pop(MPI_Channel *ch)
+{
+    MPI_Channel_segment *seg = ch->seg_head;
+
+    // Overflow segments are drained; continue with the log file
+    if (seg == NULL || seg->read == seg->write)
+        return ch->spill != NULL && ch->spill->items > 0 ? spill_pop(ch) : 1;
+
+    seg->read++;
+    ch->staged_items--;
+
+    // Segment is drained if every slot has been written and read or if no more elements are staged
+    if (seg->read == ch->capacity || seg->read == seg->write)
+    {
+        // Unchain segment
+        ch->seg_head = seg->next;
+        if (ch->seg_head == NULL)
+            ch->seg_tail = NULL;
+
+        // Keep one drained segment as spare, release the others
+        if (ch->seg_spare == NULL)
+            ch->seg_spare = seg;
+        else
+            free(seg);
+    }
+
+    return 1;
+}
+
+void segment_free_all(MPI_Channel *ch)
+{
+    MPI_Channel_segment *seg = ch->seg_head, *next;
+
+    while (seg != NULL)
+    {
+        next = seg->next;
+        free(seg);
+        seg = next;
+    }
+
+    free(ch->seg_spare);
+
+    ch->seg_head = ch->seg_tail = ch->seg_spare = NULL;
+    ch->staged_items = 0;
+
+    // Release log file
+    if (ch->spill != NULL)
+        spill_close(ch);
+}
+
+int spill_open(MPI_Channel *ch, const char *dir)
+{
+    MPI_Channel_spill *sp;
+
+    if ((sp = malloc(sizeof(*sp))) == NULL)
+    {
+        ERROR("Error in malloc(): Memory for the log file could not be allocated\n");
+        return -1;
+    }
+
+    // Create a unique log file in the passed directory
+    char *path = malloc(strlen(dir) + sizeof("/mpi_channel_XXXXXX"));
+    if (path == NULL)
+    {
+        ERROR("Error in malloc(): Memory for the log file path could not be allocated\n");
+        free(sp);
+        return -1;
+    }
+    sprintf(path, "%s/mpi_channel_XXXXXX", dir);
+
+    if ((sp->fd = mkstemp(path)) == -1)
+    {
+        ERROR("Error in mkstemp(): Log file could not be created in %s\n", dir);
+        free(path);
+        free(sp);
+        return -1;
+    }
+
+    // Unlink log file right away; the file is released on close() or process termination
+    unlink(path);
+    free(path);
+
+    // Chunks are a multiple of the page size to be mappable and of the element size so no element crosses a chunk
+    long page_size = sysconf(_SC_PAGESIZE);
+    size_t a = page_size, b = ch->data_size, t;
+    while (b != 0)
+    {
+        t = a % b;
+        a = b;
+        b = t;
+    }
+    size_t lcm = page_size / a * ch->data_size;
+    sp->chunk_size = lcm * (lcm < SPILL_CHUNK_SIZE ? SPILL_CHUNK_SIZE / lcm : 1);
+
+    sp->read_off = sp->write_off = sp->read_map_off = sp->write_map_off = 0;
+    sp->read_map = sp->write_map = NULL;
+    sp->items = 0;
+    sp->punch_holes = 1;
+
+    // The log file is read sequentially
+    posix_fadvise(sp->fd, 0, 0, POSIX_FADV_SEQUENTIAL);
+
+    ch->spill = sp;
+
+    return 1;
+}
+
+void spill_close(MPI_Channel *ch)
+{
+    MPI_Channel_spill *sp = ch->spill;
+
+    if (sp->read_map != NULL)
+        munmap(sp->read_map, sp->chunk_size);
+    if (sp->write_map != NULL)
+        munmap(sp->write_map, sp->chunk_size);
+
+    close(sp->fd);
+    free(sp);
+
+    ch->spill = NULL;
+}
+
+// Maps the chunk of the log file starting at offset off
+static char *spill_map(MPI_Channel_spill *sp, off_t off, int prot)
+{
+    char *map = mmap(NULL, sp->chunk_size, prot, MAP_SHARED, sp->fd, off);
+
+    if (map == MAP_FAILED)
+    {
+        ERROR("Error in mmap(): Chunk of the log file could not be mapped\n");
+        return NULL;
+    }
+
+    return map;
+}
+
+// Maps the chunk the read offset points to and reads ahead the following chunk if it has already been written
+static int spill_map_read(MPI_Channel_spill *sp)
+{
+    if (sp->read_map != NULL)
+    {
+        munmap(sp->read_map, sp->chunk_size);
+
+        // Consumed chunk will not be read again
+        posix_fadvise(sp->fd, sp->read_map_off, sp->chunk_size, POSIX_FADV_DONTNEED);
+
+        // Release the disk space of the consumed chunk; otherwise a receiver which lags behind without ever catching up
+        // lets the log file grow without bound since it is only truncated once it is drained
+#ifdef FALLOC_FL_PUNCH_HOLE
+        if (sp->punch_holes && 
+        fallocate(sp->fd, FALLOC_FL_PUNCH_HOLE | FALLOC_FL_KEEP_SIZE, sp->read_map_off, sp->chunk_size) != 0)
+        {
+            WARNING("Error in fallocate(): File system cannot release consumed chunks of the log file\n");
+            sp->punch_holes = 0;
+        }
+#endif
+    }
+
+    sp->read_map_off = sp->read_off;
+    if ((sp->read_map = spill_map(sp, sp->read_map_off, PROT_READ)) == NULL)
+        return -1;
+
+    madvise(sp->read_map, sp->chunk_size, MADV_SEQUENTIAL);
+
+    if (sp->read_map_off + (off_t) sp->chunk_size < sp->write_off)
+        posix_fadvise(sp->fd, sp->read_map_off + sp->chunk_size, sp->chunk_size, POSIX_FADV_WILLNEED);
+
+    return 1;
+}
+
+static int spill_push(MPI_Channel *ch, void *data)
+{
+    MPI_Channel_spill *sp = ch->spill;
+
+    // Current chunk is full; append a new chunk to the log file and map it
+    if (sp->write_map == NULL || sp->write_off == sp->write_map_off + (off_t) sp->chunk_size)
+    {
+        if (sp->write_map != NULL)
+        {
+            munmap(sp->write_map, sp->chunk_size);
+            sp->write_map = NULL;
+        }
+
+        sp->write_map_off = sp->write_off;
+
+        if (ftruncate(sp->fd, sp->write_map_off + sp->chunk_size) != 0)
+        {
+            ERROR("Error in ftruncate(): Log file could not be extended\n");
+            return -1;
+        }
+
+        if ((sp->write_map = spill_map(sp, sp->write_map_off, PROT_READ | PROT_WRITE)) == NULL)
+            return -1;
+    }
+
+    // Append element to the log file
+    memcpy(sp->write_map + (sp->write_off - sp->write_map_off), data, ch->data_size);
+    sp->write_off += ch->data_size;
+
+    // First element of the log file; map the chunk to read it from
+    if (sp->items == 0 && spill_map_read(sp) != 1)
+    {
+        sp->write_off -= ch->data_size;
+        return -1;
+    }
+
+    sp->items++;
+    ch->staged_items++;
+
+    return 1;
+}
+
+static int spill_pop(MPI_Channel *ch)
+{
+    MPI_Channel_spill *sp = ch->spill;
+
+    sp->read_off += ch->data_size;
+    sp->items--;
+    ch->staged_items--;
+
+    // Log file is drained; truncate it to release the disk space
+    if (sp->items == 0)
+    {
+        munmap(sp->read_map, sp->chunk_size);
+        munmap(sp->write_map, sp->chunk_size);
+        sp->read_map = sp->write_map = NULL;
+        sp->read_off = sp->write_off = sp->read_map_off = sp->write_map_off = 0;
+
+        if (ftruncate(sp->fd, 0) != 0)
+            WARNING("Error in ftruncate(): Log file could not be truncated\n");
+
+        return 1;
+    }
+
+    // Continue with the next chunk
+    if (sp->read_off == sp->read_map_off + (off_t) sp->chunk_size)
+        return spill_map_read(sp);
+
+    return 1;
 }
\ No newline at end of file
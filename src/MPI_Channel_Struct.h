@@ -12,7 +12,10 @@
 #define MPI_CHANNEL_STRUCT_H
 
 #include <malloc.h>
+#include <stdalign.h>
+#include <stdatomic.h>
 #include <string.h> /* memset */
+#include <sys/types.h> /* off_t */
 #include "mpi.h"
 
 #ifndef MPI_CHANNEL_DEBUG_MESSAGES
@@ -59,11 +62,80 @@ typedef enum MPI_Chan_type {
 
 typedef enum MPI_Comm_type {
     PT2PT,
-    RMA
+    RMA,
+    COLL,
+    THREADS
 } MPI_Communication_type;
 
 #endif 
 
+/**
+ * @brief Segment of the sender-side overflow storage used by unbounded channels. Segments are chained in FIFO order and
+ * store up to capacity elements each.
+ */
+typedef struct MPI_Channel_segment {
+    struct MPI_Channel_segment *next;   /** Next (younger) segment of the chain or NULL */
+    int         read;                   /** Index of the oldest staged element of the segment */
+    int         write;                  /** Index of the next free slot of the segment */
+    char        data[];                 /** Memory for capacity elements of size data_size */
+} MPI_Channel_segment;
+
+/**
+ * @brief Append-only log file used as overflow tier once the overflow segments of a channel hold the allowed number of 
+ * elements. The log is mapped in chunks which are a multiple of the page size and the element size, so no element 
+ * crosses a chunk boundary. Consumed chunks are punched out of the file where the file system supports it, so the disk
+ * space of the log is bounded by the elements it stores even if it is never drained.
+ */
+typedef struct MPI_Channel_spill {
+    int         fd;                     /** File descriptor of the (already unlinked) log file */
+    size_t      chunk_size;             /** Size of a mapped chunk in byte */
+    off_t       read_off;               /** Offset of the oldest element in the log */
+    off_t       write_off;              /** Offset behind the youngest element in the log */
+    char        *read_map;              /** Mapping of the chunk containing read_off or NULL */
+    off_t       read_map_off;           /** Offset of the chunk mapped at read_map */
+    char        *write_map;             /** Mapping of the chunk containing write_off or NULL */
+    off_t       write_map_off;          /** Offset of the chunk mapped at write_map */
+    int         items;                  /** Number of elements stored in the log */
+    int         punch_holes;            /** Flag which signals that consumed chunks are released with fallocate() */
+} MPI_Channel_spill;
+
+/**
+ * @brief Ring of a channel between the threads of a process. Head and tail are positions which only increase; the slot 
+ * of a position is the position modulo the capacity. Head, tail and the slots are placed on cache lines of their own so
+ * senders and receivers do not invalidate each other's cache lines.
+ */
+typedef struct MPI_Channel_ring {
+    alignas(64) atomic_size_t head;     /** Position of the next element to receive */
+    size_t      cached_tail;            /** Tail as last seen by the receiver of a SPSC ring */
+    alignas(64) atomic_size_t tail;     /** Position of the next element to send */
+    size_t      cached_head;            /** Head as last seen by the sender of a SPSC ring */
+    alignas(64) size_t slot_size;       /** Size of a slot; slots of MPSC and MPMC rings start with a sequence number */
+    char        slots[];                /** Memory for capacity slots */
+} MPI_Channel_ring;
+
+struct MPI_Channel;
+
+/**
+ * @brief Operation a thread publishes on a thread-safe channel. The operation lives on the stack of the publishing 
+ * thread, which waits until the combining thread has executed it.
+ */
+typedef struct MPI_Channel_op {
+    struct MPI_Channel_op *next;        /** Operation published before (stack) or after (execution order) this one */
+    int         (*fn)(struct MPI_Channel*, void*);  /** Function executing the operation */
+    void        *data;                  /** Data passed to fn */
+    int         result;                 /** Return value of fn */
+    atomic_int  done;                   /** Set once the operation has been executed */
+} MPI_Channel_op;
+
+/**
+ * @brief State of a thread-safe channel. Threads publish their operations on a lock-free stack; the thread which holds 
+ * the combining flag executes every published operation, so the channel itself is only used by one thread at a time.
+ */
+typedef struct MPI_Channel_ts {
+    _Atomic(MPI_Channel_op *) top;      /** Youngest published operation or NULL */
+    atomic_flag combining;              /** Set while a thread executes published operations */
+} MPI_Channel_ts;
+
 typedef struct MPI_Channel{
 
     ////////////////////////**
@@ -93,18 +165,121 @@ typedef struct MPI_Channel{
     int (*ptr_channel_receive)(struct MPI_Channel*, void*);
     int (*ptr_channel_peek)(struct MPI_Channel*);
     int (*ptr_channel_free)(struct MPI_Channel*);
+    int (*ptr_channel_trysend)(struct MPI_Channel*, void*);     /** Nonblocking send used by unbounded channels */
+    int (*ptr_channel_tryreceive)(struct MPI_Channel*, void*);  /** Nonblocking receive used by priority levels */
+    int (*ptr_channel_drain)(struct MPI_Channel*);              /** Nonblocking drain used by channel_ifree() */
 
     int         buffered_items;         /** Bookmarks the number of buffered elements at the sender process */
-    int                 flag;           /** Used for MPI_Iprobe() */
+    int                 flag;           /** Used for MPI_Iprobe() and MPI_Improbe() */
+    MPI_Message         message;        /** Message matched by MPI_Improbe() or MPI_Mprobe() and received by MPI_Mrecv() */
     int         idx_last_rank;          /** Used for MPSC storing the last rank to receive from */
 
+    // PT2PT BUF send slots
+    char        *send_slots;            /** Copies of the elements in transit; one slot per request */
+    MPI_Request *send_requests;         /** Request of the MPI_Isend() of each send slot */
+    int         *send_indices;          /** Indices of completed requests returned by MPI_Testsome() */
+    char        *send_busy;             /** Flag per send slot which signals that its message is in transit */
+    int         send_slot_count;        /** Number of send slots */
+    size_t      send_slot_size;         /** Size of a send slot in byte */
+    int         send_next;              /** Index of the next send slot of the ring */
+    int         send_persistent;        /** Flag which signals that the requests are persistent requests */
+
+    // PT2PT BUF pre-posted receives
+    char        *recv_slots;            /** Slots the pre-posted receives of every sender land in */
+    MPI_Request *recv_requests;         /** Persistent receive request of each receive slot */
+    int         *recv_heads;            /** Index of the oldest receive slot of each sender within its ring */
+    int         recv_slot_count;        /** Number of receive slots per sender */
+    MPI_Request *recv_waits;            /** Request of the oldest receive slot of each sender; tested as a whole */
+    int         *recv_arrived;          /** Flags which signal that the oldest element of a sender has arrived */
+    int         *recv_indices;          /** Indices of completed requests returned by MPI_Testsome() */
+
+    // PT2PT BUF credits
+    int         *credits;               /** Consumed elements of each sender which have not been returned as credit */
+    int         credit_batch;           /** Number of consumed elements returned in one credit message */
+    int         *credit_limits;         /** Elements each sender can have at the receiver before it blocks */
+    int         min_quota;              /** Smallest quota of all senders of the channel */
+    int         credit;                 /** Used for receiving credit messages */
+    int         rma_credits;            /** Flag which signals that credits are accumulated into credit_win */
+    MPI_Win     credit_win;             /** Window holding the consumed counters of the receivers at every sender */
+    int         *credit_lmem;           /** Local memory of credit_win; one consumed counter per receiver at a sender */
+    int         *credit_seen;           /** Consumed counts of each receiver the sender has already taken into account */
+    int         credit_disp;            /** Index of the calling receiver; displacement of its counter at the senders */
+
+    // PT2PT SPSC
+    void        *pers_buf;              /** Buffer the persistent request of a PT2PT SPSC SYNC channel is bound to */
+
+    // Weighted MPSC
+    int         *weights;               /** Weight of each sender at the receiver of a weighted MPSC channel or NULL */
+    int         *deficits;              /** Remaining deficit of each sender in the current round or NULL */
+    int         quota;                  /** Maximum number of outstanding elements of a MPSC sender */
+    int         sender_idx;             /** Index of the calling sender in sender_ranks (RMA MPSC BUF DRR) */
+
+    // Hints
+    MPI_Info    info;                   /** Hints passed to the shadow comm and the window or MPI_INFO_NULL */
+    int         fifo;                   /** Flag which signals that elements of different senders keep their order */
+    int         matchmaker;             /** Flag which signals that a matchmaker pairs senders and receivers (MPMC SYNC) */
+    int         pull;                   /** Flag which signals that MPMC BUF receivers demand elements from the senders */
+
+    // Unbounded BUF
+    int         unbounded;              /** Flag which signals if the sender stages elements instead of blocking */
+    int         staged_items;           /** Number of elements staged in overflow segments at the sender process */
+    MPI_Channel_segment *seg_head;      /** Oldest overflow segment; elements are handed over to the channel from here */
+    MPI_Channel_segment *seg_tail;      /** Youngest overflow segment; new elements are staged here */
+    MPI_Channel_segment *seg_spare;     /** Drained segment kept for reuse to avoid reallocation for bursts */
+    MPI_Channel_spill   *spill;         /** Log file used once spill_limit elements are staged in memory or NULL */
+    int         spill_limit;            /** Maximum number of elements staged in overflow segments if spill is set */
+
+    // Thread safety
+    MPI_Channel_ts *ts;                 /** State of a thread-safe channel or NULL */
+    int         progress;               /** Flag which signals that the progress thread polls the channel */
+
+    // THREADS
+    MPI_Channel_ring *ring;             /** Ring of a channel between threads or NULL */
+
+    // Priority levels
+    int         levels;                 /** Number of priority levels; 1 for channels without priority levels */
+    struct MPI_Channel **level_ch;      /** Channel of each priority level (lowest first) if levels > 1 or NULL */
+
+    // Reduction MPSC
+    MPI_Op      reduce_op;              /** Operation combining the elements of an epoch or MPI_OP_NULL */
+    MPI_Datatype reduce_type;           /** Datatype of the elements of a reduction channel */
+    int         reduce_count;           /** Number of elements of reduce_type in each data element */
+    int         epoch;                  /** Next epoch the calling process contributes to or receives */
+    int         consumed;               /** Number of epochs received as last seen by a RMA sender */
+
+    // COLL superstep
+    char        *stage;                 /** Sender: region of stage_cap elements per receiver; receiver: current batch */
+    int         *stage_counts;          /** Number of elements per receiver (sender) or per sender (receiver) */
+    int         *stage_displs;          /** Displacement of each region (sender) or each part of the batch (receiver) */
+    int         stage_cap;              /** Elements per region (sender) or elements the batch can hold (receiver) */
+    int         batch_len;              /** Number of elements of the batch at the receiver */
+    int         batch_pos;              /** Index of the next element of the batch to receive */
+    MPI_Datatype elem_type;             /** Contiguous datatype of data_size bytes */
+
     // PT2PT MPMC SYNC
     int             tag;                /** Used to send unique send requests for PT2PT MPMC SYNC channels */
     int             *requests_sent;     /** Stores integer array to check for sent request messages */
 
+    // PT2PT MPMC SYNC MATCH
+    int     *waiting_senders;           /** Ring of the senders waiting at the matchmaker in arrival order */
+    int     *waiting_receivers;         /** Ring of the receivers waiting at the matchmaker in arrival order */
+    int     waiting_senders_head;       /** Index of the oldest waiting sender */
+    int     waiting_senders_count;      /** Number of waiting senders */
+    int     waiting_receivers_head;     /** Index of the oldest waiting receiver */
+    int     waiting_receivers_count;    /** Number of waiting receivers */
+    int     demand_posted;              /** Flag which signals that the receiver waits at the matchmaker */
+    int     matched_sender;             /** Sender paired with the matchmaker itself or -1 */
+    int     match_frees;                /** Number of processes which have announced their free to the matchmaker */
+
     // PT2PT MPMC BUF
-    int loc_capacity;                   /** Used to store the local capacity for every receiver */
     int *receiver_buffered_items;       /** Integer array storing the number of buffered elements at each receiver */
+    unsigned int choice_seed;           /** Seed of the random second choice of a receiver for PT2PT MPMC BUF */
+    int *receiver_order;                /** Receiver indices, the receivers on the node of the sender come first */
+    int local_receiver_count;           /** Number of receivers on the node of the sender */
+    int remote_threshold;               /** Elements buffered at a same-node receiver before remote ones are considered */
+
+    // PT2PT MPMC BUF PULL
+    int demand_count;                   /** Number of slots of the queue of demands; a power of two */
     // PT2PT MPMC SYNC
     MPI_Request         *requests;      /** Used for PT2PT MPMC SYNC */
     // RMA
@@ -143,6 +318,238 @@ int append_buffer(int to_append);
  */
 int shrink_buffer(int to_append);
 
+/**
+ * @brief Internal utility function to allocate the ring of send slots of a PT2PT BUF channel. Elements and 
+ * acknowledgement messages are sent with MPI_Isend() from a slot of the ring instead of MPI_Bsend(), so neither the 
+ * buffer attached to MPI nor its allocator is used.
+ * 
+ * @param[in, out] ch Pointer to the MPI_Channel
+ * @param[in] count Number of send slots; needs to cover the maximum number of messages in transit
+ * @param[in] slot_size Size of a slot in byte; data_size if elements are sent and sizeof(int) if only credit messages 
+ * are sent
+ * @return Returns 1 if the send slots could be allocated and -1 otherwise
+ */
+int send_slots_alloc(MPI_Channel *ch, int count, size_t slot_size);
+
+/**
+ * @brief Internal utility function to send a message from the next free send slot with MPI_Isend() or MPI_Start() if
+ * the slots are bound to persistent requests. Completed slots are reclaimed with MPI_Testsome() once the next slot of 
+ * the ring is still in transit; the calling process only waits if every slot is in transit.
+ * 
+ * @param[in, out] ch Pointer to the MPI_Channel
+ * @param[in] data Pointer to the element or credit which is copied into the slot
+ * @param[in] size Size of the message in byte; at most the slot size
+ * @param[in] dest Rank of the destination in the shadow comm of the channel; ignored for persistent requests
+ * @return Returns 1 if the message has been started and -1 otherwise
+ */
+int send_slots_isend(MPI_Channel *ch, void *data, size_t size, int dest);
+
+/**
+ * @brief Internal utility function to bind every send slot to a persistent request with MPI_Send_init(). Used by 
+ * channels whose messages always go to the same destination, so MPI_Start() replaces MPI_Isend() and MPI does not
+ * process the arguments of every message again. Needs to be called after the shadow comm has been created.
+ * 
+ * @param[in, out] ch Pointer to the MPI_Channel
+ * @param[in] size Size of every message in byte; at most the slot size
+ * @param[in] dest Rank of the destination in the shadow comm of the channel
+ * @return Returns 1 if the persistent requests could be created and -1 otherwise
+ */
+int send_slots_persist(MPI_Channel *ch, size_t size, int dest);
+
+/**
+ * @brief Internal utility function to wait for every message in transit and release the send slots of a channel
+ * 
+ * @param[in, out] ch Pointer to the MPI_Channel
+ * @return Returns 1 if every message has been completed and -1 otherwise
+ */
+int send_slots_free(MPI_Channel *ch);
+
+/**
+ * @brief Internal utility function to pre-post receives at the receiver of a PT2PT BUF channel. Every sender gets a ring
+ * of count receive slots, each bound to a persistent request created with MPI_Recv_init() and started at once, so 
+ * elements land in their slot instead of the unexpected-message queue of MPI. The credit counters of the senders are
+ * allocated as well; a credit is returned once half of the slots of a sender have been consumed. Needs to be called 
+ * after the shadow comm has been created.
+ * 
+ * @param[in, out] ch Pointer to the MPI_Channel of the receiver process
+ * @param[in] count Number of receive slots per sender; needs to cover the number of elements a sender can have in transit. 
+ * The limit of every sender in credit_limits starts at count
+ * @return Returns 1 if the receives could be pre-posted and -1 otherwise
+ */
+int recv_slots_alloc(MPI_Channel *ch, int count);
+
+/**
+ * @brief Internal utility function returning the number of elements of a sender which have arrived in its receive slots
+ * and can be received in order
+ * 
+ * @param[in] ch Pointer to the MPI_Channel of the receiver process
+ * @param[in] sender Index of the sender in sender_ranks
+ * @return Returns the number of arrived elements and -1 if an error occured
+ */
+int recv_slots_ready(MPI_Channel *ch, int sender);
+
+/**
+ * @brief Internal utility function to receive the element of the oldest receive slot of a sender. The calling process 
+ * waits until the element has arrived; afterwards the slot is copied out and its receive is posted again.
+ * 
+ * @param[in, out] ch Pointer to the MPI_Channel of the receiver process
+ * @param[out] data Pointer to a memory adress the element is copied to
+ * @param[in] sender Index of the sender in sender_ranks
+ * @return Returns 1 if the element has been received and -1 otherwise
+ */
+int recv_slots_receive(MPI_Channel *ch, void *data, int sender);
+
+/**
+ * @brief Internal utility function to find the senders whose oldest element has arrived with a single MPI_Testsome()
+ * over the oldest receive slots of every sender. The result is kept in recv_arrived.
+ * 
+ * @param[in, out] ch Pointer to the MPI_Channel of the receiver process
+ * @return Returns the number of senders whose oldest element has arrived and -1 if an error occured
+ */
+int recv_slots_test(MPI_Channel *ch);
+
+/**
+ * @brief Internal utility function like recv_slots_test() which blocks in MPI_Waitany() until the oldest element of 
+ * at least one sender has arrived
+ * 
+ * @param[in, out] ch Pointer to the MPI_Channel of the receiver process
+ * @return Returns the number of senders whose oldest element has arrived and -1 if an error occured
+ */
+int recv_slots_wait(MPI_Channel *ch);
+
+/**
+ * @brief Internal utility function to cancel the pre-posted receives and release the receive slots of a channel. 
+ * Elements which have arrived but have not been received are discarded.
+ * 
+ * @param[in, out] ch Pointer to the MPI_Channel of the receiver process
+ */
+void recv_slots_free(MPI_Channel *ch);
+
+/**
+ * @brief Internal utility function to count an element of a sender consumed with recv_slots_receive() and to send the
+ * accumulated credit to the sender if the batch is complete. The credit is sent early if the next element of the 
+ * sender has not arrived in its receive slot yet or if the arrived elements and the held back credits reach the limit
+ * of the sender in credit_limits, since the sender might wait for the credit in both cases.
+ * 
+ * @param[in, out] ch Pointer to the MPI_Channel of the receiver process
+ * @param[in] sender Index of the sender in sender_ranks
+ * @return Returns 1 if the element has been counted and -1 if an error occured
+ */
+int credits_return(MPI_Channel *ch, int sender);
+
+/**
+ * @brief Internal utility function to send a credit of count consumed elements to a sender. The credit is sent as a 
+ * message from a send slot or, if the channel returns credits one-sided, added to the consumed counter of the calling
+ * receiver in the window of the sender with MPI_Accumulate().
+ * 
+ * @param[in, out] ch Pointer to the MPI_Channel of the receiver process
+ * @param[in] dest Rank of the sender in the shadow comm of the channel
+ * @param[in] count Number of consumed elements
+ * @return Returns 1 if the credit has been sent and -1 otherwise
+ */
+int credits_send(MPI_Channel *ch, int dest, int count);
+
+/**
+ * @brief Internal utility function to collect the credits a receiver has returned to the calling sender. Credit 
+ * messages are received with MPI_Improbe() and MPI_Mrecv(); one-sided credits are read from the local consumed 
+ * counter of the receiver without any message matching.
+ * 
+ * @param[in, out] ch Pointer to the MPI_Channel of the sender process
+ * @param[in] receiver Index of the receiver in receiver_ranks
+ * @param[in] block Flag which signals that the calling process waits until at least one credit has arrived
+ * @return Returns the number of elements the collected credits return and -1 if an error occured
+ */
+int credits_collect(MPI_Channel *ch, int receiver, int block);
+
+/**
+ * @brief Internal utility function to create the window of one-sided credits of a PT2PT BUF channel. Every sender 
+ * exposes one consumed counter per receiver; receivers expose no memory. The window stays locked with 
+ * MPI_Win_lock_all() until credit_win_free() is called. Needs to be called after the shadow comm has been created and
+ * is collective over it.
+ * 
+ * @param[in, out] ch Pointer to the MPI_Channel
+ * @return Returns 1 if the window could be created and -1 otherwise
+ */
+int credit_win_alloc(MPI_Channel *ch);
+
+/**
+ * @brief Internal utility function to release the window of one-sided credits. Collective over the shadow comm.
+ * 
+ * @param[in, out] ch Pointer to the MPI_Channel
+ */
+void credit_win_free(MPI_Channel *ch);
+
+/**
+ * @brief Internal utility function to stage an element in the overflow segments of an unbounded channel. A new segment
+ * is chained to the youngest one if it is full.
+ * 
+ * @param[in, out] ch Pointer to the MPI_Channel of the sender process
+ * @param[in] data Pointer to the element which will be copied into the overflow segment
+ * @return Returns 1 if the element has been staged and -1 if a new segment could not be allocated
+ * 
+ * @note If the channel has a log file the element is appended to the log file once spill_limit elements are staged in
+ * memory or the log file is not empty. segment_front() and segment_pop() continue with the log file once the overflow
+ * segments are drained, which preserves the order of elements.
+ */
+int segment_push(MPI_Channel *ch, void *data);
+
+/**
+ * @brief Internal utility function returning the oldest staged element of an unbounded channel
+ * 
+ * @param[in] ch Pointer to the MPI_Channel of the sender process
+ * @return Returns a pointer to the oldest staged element or NULL if no element is staged
+ */
+void *segment_front(MPI_Channel *ch);
+
+/**
+ * @brief Internal utility function removing the oldest staged element of an unbounded channel. Drained segments are 
+ * released except for one which is kept as spare segment. A drained log file is truncated.
+ * 
+ * @param[in, out] ch Pointer to the MPI_Channel of the sender process
+ * @return Returns 1 if the element has been removed and -1 if the next chunk of the log file could not be mapped
+ */
+int segment_pop(MPI_Channel *ch);
+
+/**
+ * @brief Internal utility function releasing every overflow segment and the log file of an unbounded channel including
+ * staged elements
+ * 
+ * @param[in, out] ch Pointer to the MPI_Channel of the sender process
+ */
+void segment_free_all(MPI_Channel *ch);
+
+/**
+ * @brief Internal utility function to create the log file a channel spills staged elements to
+ * 
+ * @param[in, out] ch Pointer to the MPI_Channel of the sender process
+ * @param[in] dir Directory in which the log file is created
+ * @return Returns 1 if the log file could be created and mapped and -1 otherwise
+ */
+int spill_open(MPI_Channel *ch, const char *dir);
+
+/**
+ * @brief Internal utility function to unmap, close and release the log file of a channel
+ * 
+ * @param[in, out] ch Pointer to the MPI_Channel of the sender process
+ */
+void spill_close(MPI_Channel *ch);
+
+/**
+ * @brief Internal utility function to create the shadow comm of a channel. The hints of the channel are attached to the
+ * shadow comm if the channel was allocated with channel_alloc_info()
+ * 
+ * @param[in] ch Pointer to the MPI_Channel whose comm is duplicated
+ * @param[out] newcomm The shadow comm
+ * @return Returns MPI_SUCCESS or the errorcode of MPI_Comm_dup() or MPI_Comm_dup_with_info()
+ */
+static inline int channel_comm_dup(MPI_Channel *ch, MPI_Comm *newcomm)
+{
+    if (ch->info == MPI_INFO_NULL)
+        return MPI_Comm_dup(ch->comm, newcomm);
+
+    return MPI_Comm_dup_with_info(ch->comm, ch->info, newcomm);
+}
+
 static inline int channel_alloc_assert_success(MPI_Comm comm, int alloc_failed) 
 {
     // MPI_Allreduce to check if channel allocation was successfull for every process
@@ -0,0 +1,435 @@
+/**
+ * @file MPI_Pipeline.c
+ * @author Toni Hollfelder (Toni.Hollfelder@uni-bayreuth.de)
+ * @brief Implementation of a dataflow pipeline runtime built on MPI Channels
+ * @version 1.0
+ * @date 2021-05-28
+ * @copyright CC BY 4.0 (https://creativecommons.org/licenses/by/4.0/)
+ *
+ */
+
+#include <stdio.h>
+#include <string.h>
+
+#include "MPI_Pipeline.h"
+#include "../MPI_Channel_Struct.h"
+
+// Every element is followed by a flag which marks the end-of-stream marker of a replica
+#define PIPELINE_EOS 1
+
+typedef struct MPI_Pipeline_stage_desc {
+    MPI_Pipeline_stage  fn;             /** Function of the stage */
+    void                *arg;           /** Argument passed to fn */
+    size_t              out_size;       /** Size of the elements passed to the next stage */
+    int                 ranks;          /** Number of replicas */
+    int                 first_rank;     /** Rank of the first replica; replicas have consecutive ranks */
+} MPI_Pipeline_stage_desc;
+
+struct MPI_Pipeline {
+    MPI_Comm                comm;       /** Communicator whose processes run the stages */
+    int                     comm_size;  /** Size of the communicator */
+    int                     my_rank;    /** Rank of the calling process */
+    MPI_Pipeline_stage_desc *stages;    /** Stages in pipeline order */
+    int                     stage_count;/** Number of stages */
+    MPI_Communication_type  intra_type; /** Communication type of channels within a node */
+    MPI_Communication_type  inter_type; /** Communication type of channels across nodes */
+};
+
+// State of the replica of the calling process while the pipeline runs
+typedef struct MPI_Pipeline_replica {
+    MPI_Channel *in;                    /** Channel of the replica or NULL for the first stage */
+    MPI_Channel **out;                  /** Channels of the downstream replicas or NULL for the last stage */
+    int         out_count;              /** Number of downstream replicas */
+    int         out_idx;                /** Downstream replica the current batch is sent to */
+    int         batch_sent;             /** Number of elements of the current batch already sent */
+    int         batch;                  /** Number of elements of a batch */
+    size_t      out_size;               /** Size of the elements sent downstream */
+} MPI_Pipeline_replica;
+
+MPI_Pipeline *pipeline_create(MPI_Comm comm)
+{
+    // Check if MPI has been initialized, nothrow
+    int flag;
+    MPI_Initialized(&flag);
+
+    if (!flag) {
+        ERROR("MPI has not been initialized\n");
+        return NULL;
+    }
+
+    MPI_Pipeline *pl;
+    if ((pl = malloc(sizeof(*pl))) == NULL)
+    {
+        ERROR("Error in malloc(): Memory for MPI_Pipeline could not be allocated\n");
+        return NULL;
+    }
+
+    // Store size of the communicator and rank, first function call with a commumincator might fail (MPI_ERR_COMM)
+    if (MPI_Comm_size(comm, &pl->comm_size) != MPI_SUCCESS || MPI_Comm_rank(comm, &pl->my_rank) != MPI_SUCCESS)
+    {
+        ERROR("Error in MPI_Comm_size(): Communicator might be invalid\n");
+        free(pl);
+        return NULL;
+    }
+
+    pl->comm = comm;
+    pl->stages = NULL;
+    pl->stage_count = 0;
+    pl->intra_type = pl->inter_type = PT2PT;
+
+    return pl;
+}
+
+int pipeline_add_stage(MPI_Pipeline *pl, MPI_Pipeline_stage fn, void *arg, size_t out_size, int ranks)
+{
+    // Assert that pipeline and function are not NULL
+    if (pl == NULL || fn == NULL)
+    {
+        WARNING("Pipeline or stage function is NULL\n");
+        return -1;
+    }
+
+    // Assert that the stage has replicas
+    if (ranks < 1)
+    {
+        WARNING("A stage needs at least one rank\n");
+        return -1;
+    }
+
+    MPI_Pipeline_stage_desc *stages = realloc(pl->stages, (pl->stage_count + 1) * sizeof(*stages));
+    if (!stages)
+    {
+        ERROR("Error in realloc(): Memory for stage could not be allocated\n");
+        return -1;
+    }
+
+    // Replicas are placed directly behind the replicas of the previous stage
+    MPI_Pipeline_stage_desc *stage = &stages[pl->stage_count];
+    stage->fn = fn;
+    stage->arg = arg;
+    stage->out_size = out_size;
+    stage->ranks = ranks;
+    stage->first_rank = pl->stage_count ? stages[pl->stage_count - 1].first_rank + stages[pl->stage_count - 1].ranks 
+    : 0;
+
+    pl->stages = stages;
+    pl->stage_count++;
+
+    return 1;
+}
+
+int pipeline_set_comm_types(MPI_Pipeline *pl, MPI_Communication_type intra_node, MPI_Communication_type inter_node)
+{
+    // Assert that pipeline is not NULL
+    if (pl == NULL)
+    {
+        WARNING("Pipeline is NULL\n");
+        return -1;
+    }
+
+    // Stages do not proceed in supersteps
+    if ((intra_node != PT2PT && intra_node != RMA) || (inter_node != PT2PT && inter_node != RMA))
+    {
+        WARNING("Pipelines can only use PT2PT or RMA channels\n");
+        return -1;
+    }
+
+    pl->intra_type = intra_node;
+    pl->inter_type = inter_node;
+
+    return 1;
+}
+
+// Determines the node of every rank; a node is identified by its lowest rank
+static int *pipeline_nodes(MPI_Pipeline *pl)
+{
+    MPI_Comm node_comm;
+    int node;
+
+    int *nodes = malloc(pl->comm_size * sizeof(*nodes));
+    if (!nodes)
+    {
+        ERROR("Error in malloc(): Memory for node ids could not be allocated\n");
+        return NULL;
+    }
+
+    // Group ranks which can share memory, i.e. ranks of the same node
+    if (MPI_Comm_split_type(pl->comm, MPI_COMM_TYPE_SHARED, pl->my_rank, MPI_INFO_NULL, &node_comm) != MPI_SUCCESS)
+    {
+        ERROR("Error in MPI_Comm_split_type()\n");
+        free(nodes);
+        return NULL;
+    }
+
+    // Every rank of a node agrees on the lowest rank of the node and every rank learns the node of every other rank
+    if (MPI_Allreduce(&pl->my_rank, &node, 1, MPI_INT, MPI_MIN, node_comm) != MPI_SUCCESS || 
+    MPI_Allgather(&node, 1, MPI_INT, nodes, 1, MPI_INT, pl->comm) != MPI_SUCCESS)
+    {
+        ERROR("Error in MPI_Allgather()\n");
+        MPI_Comm_free(&node_comm);
+        free(nodes);
+        return NULL;
+    }
+
+    MPI_Comm_free(&node_comm);
+
+    return nodes;
+}
+
+// Allocates the channel of downstream replica receiver of the edge between stage and stage + 1; only the replicas of
+// stage and the receiver take part
+static MPI_Channel *pipeline_alloc_channel(MPI_Pipeline *pl, int stage, int receiver, int *nodes, int capacity)
+{
+    MPI_Pipeline_stage_desc *up = &pl->stages[stage];
+    MPI_Group group, channel_group;
+    MPI_Comm comm;
+    MPI_Channel *ch;
+
+    // Ranks of the upstream replicas followed by the receiver; the channel is intra-node if every rank shares the node
+    // of the receiver
+    int *ranks = malloc((up->ranks + 1) * sizeof(*ranks));
+    if (!ranks)
+    {
+        ERROR("Error in malloc(): Memory for channel ranks could not be allocated\n");
+        return NULL;
+    }
+
+    int intra_node = 1;
+    for (int i = 0; i < up->ranks; i++)
+    {
+        ranks[i] = up->first_rank + i;
+        intra_node &= nodes[ranks[i]] == nodes[receiver];
+    }
+    ranks[up->ranks] = receiver;
+
+    // Create communicator of the channel; only its members take part
+    if (MPI_Comm_group(pl->comm, &group) != MPI_SUCCESS)
+    {
+        ERROR("Error in MPI_Comm_group()\n");
+        free(ranks);
+        return NULL;
+    }
+
+    if (MPI_Group_incl(group, up->ranks + 1, ranks, &channel_group) != MPI_SUCCESS)
+    {
+        ERROR("Error in MPI_Group_incl()\n");
+        MPI_Group_free(&group);
+        free(ranks);
+        return NULL;
+    }
+
+    if (MPI_Comm_create_group(pl->comm, channel_group, stage, &comm) != MPI_SUCCESS)
+    {
+        ERROR("Error in MPI_Comm_create_group()\n");
+        MPI_Group_free(&channel_group);
+        MPI_Group_free(&group);
+        free(ranks);
+        return NULL;
+    }
+
+    MPI_Group_free(&channel_group);
+    MPI_Group_free(&group);
+    free(ranks);
+
+    // Every element carries the end-of-stream flag behind its data
+    ch = channel_alloc(up->out_size + sizeof(int), capacity, intra_node ? pl->intra_type : pl->inter_type, comm, 
+    pl->my_rank == receiver);
+
+    // The channel uses a communicator of its own
+    MPI_Comm_free(&comm);
+
+    return ch;
+}
+
+// Sends an element to the current downstream replica; batches move on to the next downstream replica which is not
+// full
+static int pipeline_emit(MPI_Pipeline_replica *rep, char *buff)
+{
+    if (rep->batch_sent == rep->batch)
+    {
+        int next = (rep->out_idx + 1) % rep->out_count;
+
+        // Skip downstream replicas whose channel is full; if every channel is full the next send blocks
+        for (int i = 0; i < rep->out_count; i++)
+        {
+            int idx = (rep->out_idx + 1 + i) % rep->out_count;
+            int free_slots = channel_peek(rep->out[idx]);
+
+            if (free_slots == -1)
+                return -1;
+
+            if (free_slots > 0)
+            {
+                next = idx;
+                break;
+            }
+        }
+
+        rep->out_idx = next;
+        rep->batch_sent = 0;
+    }
+
+    rep->batch_sent++;
+
+    return channel_send(rep->out[rep->out_idx], buff);
+}
+
+// Calls the function of the stage and sends the produced element downstream
+static int pipeline_call(MPI_Pipeline_stage_desc *stage, MPI_Pipeline_replica *rep, void *in, char *out)
+{
+    int produced = (*stage->fn)(in, rep->out ? out : NULL, stage->arg);
+
+    if (produced == 1 && rep->out && pipeline_emit(rep, out) != 1)
+        return -1;
+
+    return produced;
+}
+
+int pipeline_run(MPI_Pipeline *pl, int batch, int capacity)
+{
+    // Assert that pipeline is not NULL
+    if (pl == NULL)
+    {
+        WARNING("Pipeline is NULL\n");
+        return -1;
+    }
+
+    // Every rank runs a replica of a stage
+    int ranks = 0;
+    for (int i = 0; i < pl->stage_count; i++)
+        ranks += pl->stages[i].ranks;
+
+    if (ranks != pl->comm_size || batch < 1 || capacity < 1)
+    {
+        ERROR("The ranks of the stages need to add up to the communicator size, batch and capacity need to be positive"
+        "\n");
+        return -1;
+    }
+
+    // Stage of the calling process
+    int s = 0;
+    while (pl->my_rank >= pl->stages[s].first_rank + pl->stages[s].ranks)
+        s++;
+
+    MPI_Pipeline_stage_desc *stage = &pl->stages[s];
+    MPI_Pipeline_replica rep = {NULL, NULL, 0, 0, 0, batch, stage->out_size};
+
+    int *nodes = pipeline_nodes(pl);
+    if (!nodes)
+        return -1;
+
+    if (s + 1 < pl->stage_count)
+    {
+        rep.out_count = pl->stages[s + 1].ranks;
+        rep.out = calloc(rep.out_count, sizeof(*rep.out));
+    }
+
+    // Input buffer for an element of the upstream stage and output buffer for an element of the stage, both followed
+    // by the end-of-stream flag
+    char *in = s > 0 ? malloc(pl->stages[s - 1].out_size + sizeof(int)) : NULL;
+    char *out = malloc(stage->out_size + sizeof(int));
+
+    if ((s + 1 < pl->stage_count && !rep.out) || (s > 0 && !in) || !out)
+    {
+        ERROR("Error in malloc(): Memory for pipeline buffers could not be allocated\n");
+        free(rep.out);
+        free(in);
+        free(out);
+        free(nodes);
+        return -1;
+    }
+
+    // Allocate channels edge by edge and downstream replica by downstream replica; every rank takes part in the same
+    // order, so creating the communicators of the channels cannot deadlock. A rank whose allocation failed still takes
+    // part in the remaining edges since the other members of these edges wait for it
+    int failed = 0;
+    for (int e = 0; e + 1 < pl->stage_count; e++)
+    {
+        for (int j = 0; j < pl->stages[e + 1].ranks; j++)
+        {
+            int receiver = pl->stages[e + 1].first_rank + j;
+
+            if (e == s)
+                failed |= (rep.out[j] = pipeline_alloc_channel(pl, e, receiver, nodes, capacity)) == NULL;
+            else if (receiver == pl->my_rank)
+                failed |= (rep.in = pipeline_alloc_channel(pl, e, receiver, nodes, capacity)) == NULL;
+        }
+    }
+
+    free(nodes);
+
+    // Every rank needs to know if an allocation failed, otherwise its upstream and downstream replicas wait for it
+    if (MPI_Allreduce(MPI_IN_PLACE, &failed, 1, MPI_INT, MPI_LOR, pl->comm) != MPI_SUCCESS)
+    {
+        ERROR("Error in MPI_Allreduce()\n");
+        failed = 1;
+    }
+
+    // Elements of the stage are no end-of-stream markers; the flag might not be aligned behind the data
+    int eos = 0;
+    memcpy(out + stage->out_size, &eos, sizeof(eos));
+
+    // Elements processed by the stage
+    int count = 0;
+
+    // Number of upstream replicas which have not finished yet
+    int upstream = s > 0 ? pl->stages[s - 1].ranks : 0;
+    size_t in_size = s > 0 ? pl->stages[s - 1].out_size : 0;
+
+    // Process elements of the upstream replicas until every one has finished
+    while (!failed && upstream > 0)
+    {
+        if (channel_receive(rep.in, in) != 1)
+        {
+            failed = 1;
+            break;
+        }
+
+        memcpy(&eos, in + in_size, sizeof(eos));
+        if (eos == PIPELINE_EOS)
+        {
+            upstream--;
+            continue;
+        }
+
+        count++;
+        failed = pipeline_call(stage, &rep, in, out) == -1;
+    }
+
+    // Produce the elements of the first stage or emit the results of the stage
+    int produced = 0;
+    while (!failed && (produced = pipeline_call(stage, &rep, NULL, out)) == 1)
+    {
+        if (s == 0)
+            count++;
+    }
+    failed |= produced == -1;
+
+    // Mark the end of the stream of the replica in every downstream channel
+    eos = PIPELINE_EOS;
+    memcpy(out + stage->out_size, &eos, sizeof(eos));
+    for (int j = 0; !failed && j < rep.out_count; j++)
+        failed = channel_send(rep.out[j], out) != 1;
+
+    // Free channels in the order they have been allocated
+    if (rep.in)
+        channel_free(rep.in);
+    for (int j = 0; j < rep.out_count; j++)
+        if (rep.out[j])
+            channel_free(rep.out[j]);
+
+    free(rep.out);
+    free(in);
+    free(out);
+
+    return failed ? -1 : count;
+}
+
+void pipeline_free(MPI_Pipeline *pl)
+{
+    if (pl == NULL)
+        return;
+
+    free(pl->stages);
+    free(pl);
+}
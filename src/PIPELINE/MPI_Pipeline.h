@@ -0,0 +1,100 @@
+/**
+ * @file MPI_Pipeline.h
+ * @author Toni Hollfelder (Toni.Hollfelder@uni-bayreuth.de)
+ * @brief Header of a dataflow pipeline runtime built on MPI Channels
+ * @version 1.0
+ * @date 2021-05-28
+ * @copyright CC BY 4.0 (https://creativecommons.org/licenses/by/4.0/)
+ *
+ * A pipeline is a chain of stages (e.g. parse -> filter -> aggregate -> write) declared over a communicator. Every
+ * stage is placed onto a block of consecutive ranks of the communicator in the order the stages have been added, so
+ * neighbouring stages tend to share a node. Each rank runs one replica of its stage.
+ *
+ * Only a linear chain of stages is supported: every stage has exactly one upstream and one downstream stage except for
+ * the first and the last one. Dataflow graphs in which a stage fans out to several different stages or fans in from 
+ * several different stages are out of scope; replicas of one stage are the only way to spread or merge elements.
+ *
+ * Between two neighbouring stages every replica of the downstream stage gets a MPSC channel of its own whose senders
+ * are the replicas of the upstream stage. A replica sends batches of elements to one downstream replica before it
+ * moves on to the next downstream replica whose channel is not full. If every downstream channel is full sending
+ * blocks, which throttles the upstream stages (back-pressure). Once a replica has finished it sends an end-of-stream
+ * marker into every downstream channel; a replica has finished once it has received the marker of every upstream
+ * replica.
+ *
+ * Channels whose processes all share a node use the intra-node communication type, all other channels the inter-node
+ * communication type. Both default to PT2PT which showed the best runtimes on one and on different nodes.
+ */
+
+#ifndef MPI_PIPELINE_H
+#define MPI_PIPELINE_H
+
+#include "../MPI_Channel.h"
+
+/**
+ * @brief Function of a stage. It is called with an element of the upstream stage in in and returns 1 if it has
+ * written an element for the downstream stage to out, 0 if not and -1 if an error occured. Once every upstream
+ * replica has finished, or right away for the first stage, it is called with in set to NULL until it returns 0; this
+ * lets the first stage produce its elements and aggregating stages emit their results. out is NULL for the last stage.
+ */
+typedef int (*MPI_Pipeline_stage)(void *in, void *out, void *arg);
+
+typedef struct MPI_Pipeline MPI_Pipeline;
+
+/**
+ * @brief Creates an empty pipeline over the passed communicator
+ *
+ * @param comm The communicator whose processes run the stages of the pipeline
+ *
+ * @return Returns a pointer to a MPI_Pipeline if creation was successfull, NULL otherwise
+ */
+MPI_Pipeline *pipeline_create(MPI_Comm comm);
+
+/**
+ * @brief Appends a stage to the pipeline. Every process of the communicator needs to add the same stages in the same
+ * order
+ *
+ * @param[in, out] pl Pointer to a MPI_Pipeline created with pipeline_create()
+ * @param[in] fn Function of the stage
+ * @param[in] arg Argument passed to every call of fn, e.g. the state of the stage
+ * @param[in] out_size Size of the elements the stage passes to the next stage; 0 for the last stage
+ * @param[in] ranks Number of replicas of the stage; the ranks of every stage need to add up to the communicator size
+ *
+ * @return Returns 1 if the stage has been added and -1 otherwise
+ */
+int pipeline_add_stage(MPI_Pipeline *pl, MPI_Pipeline_stage fn, void *arg, size_t out_size, int ranks);
+
+/**
+ * @brief Sets the communication types of the channels between stages
+ *
+ * @param[in, out] pl Pointer to a MPI_Pipeline created with pipeline_create()
+ * @param[in] intra_node Communication type of channels whose processes all share a node
+ * @param[in] inter_node Communication type of every other channel
+ *
+ * @return Returns 1 if the communication types have been set and -1 otherwise
+ *
+ * @note Superstep channels (COLL) cannot be used since stages do not proceed in supersteps
+ */
+int pipeline_set_comm_types(MPI_Pipeline *pl, MPI_Communication_type intra_node, MPI_Communication_type inter_node);
+
+/**
+ * @brief Allocates the channels between the stages and runs the stage of the calling process until every upstream
+ * replica has finished. Every process of the communicator needs to call this function
+ *
+ * @param[in] pl Pointer to a MPI_Pipeline created with pipeline_create()
+ * @param[in] batch Number of elements sent to a downstream replica before moving on to the next one; needs to be
+ * positive
+ * @param[in] capacity Capacity of the channel of every replica; needs to be positive
+ *
+ * @return Returns the number of elements the stage of the calling process has processed (received elements, or
+ * produced elements for the first stage) and -1 if an error occures
+ */
+int pipeline_run(MPI_Pipeline *pl, int batch, int capacity);
+
+/**
+ * @brief Deallocates the pipeline
+ *
+ * @param[in, out] pl Pointer to a MPI_Pipeline created with pipeline_create()
+ */
+void pipeline_free(MPI_Pipeline *pl);
+
+#endif // MPI_PIPELINE_H
@@ -7,19 +7,93 @@
  * @copyright CC BY 4.0 (https://creativecommons.org/licenses/by/4.0/)
  */
 
+#include <stdlib.h> /* rand_r */
 #include "PT2PT_MPMC_BUF.h"
 
+// Orders the receivers of a sender by locality, the receivers on the node of the sender come first; collective
+static int locality_pt2pt_mpmc_buf(MPI_Channel *ch)
+{
+    // Used to store the processes sharing memory with the calling process
+    MPI_Comm node_comm;
+    MPI_Group node_group, group;
+
+    // Split the communicator into the processes of every node
+    if (MPI_Comm_split_type(ch->comm, MPI_COMM_TYPE_SHARED, 0, MPI_INFO_NULL, &node_comm) != MPI_SUCCESS)
+    {
+        ERROR("Error in MPI_Comm_split_type()\n");
+        return -1;
+    }
+
+    // Receiver does not choose between processes
+    if (ch->is_receiver)
+    {
+        MPI_Comm_free(&node_comm);
+        return 1;
+    }
+
+    ch->receiver_order = malloc(ch->receiver_count * sizeof(int));
+    int *node_ranks = malloc(ch->receiver_count * sizeof(int));
+
+    if (!ch->receiver_order || !node_ranks)
+    {
+        ERROR("Error in malloc()\n");
+        MPI_Comm_free(&node_comm);
+        free(ch->receiver_order);
+        free(node_ranks);
+        return -1;
+    }
+
+    // Translate the ranks of the receivers into ranks of the node communicator
+    // Receivers on another node translate to MPI_UNDEFINED
+    MPI_Comm_group(node_comm, &node_group);
+    MPI_Comm_group(ch->comm, &group);
+    if (MPI_Group_translate_ranks(group, ch->receiver_count, ch->receiver_ranks, node_group, node_ranks) != MPI_SUCCESS)
+    {
+        ERROR("Error in MPI_Group_translate_ranks()\n");
+        MPI_Group_free(&group);
+        MPI_Group_free(&node_group);
+        MPI_Comm_free(&node_comm);
+        free(ch->receiver_order);
+        free(node_ranks);
+        return -1;
+    }
+    MPI_Group_free(&group);
+    MPI_Group_free(&node_group);
+    MPI_Comm_free(&node_comm);
+
+    // Count the receivers on the node of the sender
+    ch->local_receiver_count = 0;
+    for (int i = 0; i < ch->receiver_count; i++)
+    {
+        if (node_ranks[i] != MPI_UNDEFINED)
+            ch->local_receiver_count++;
+    }
+
+    // Store the indices of the receivers on the node first and of the remote receivers afterwards
+    int local = 0, remote = ch->local_receiver_count;
+    for (int i = 0; i < ch->receiver_count; i++)
+    {
+        if (node_ranks[i] != MPI_UNDEFINED)
+            ch->receiver_order[local++] = i;
+        else
+            ch->receiver_order[remote++] = i;
+    }
+    free(node_ranks);
+
+    // Without a receiver on the node every receiver is treated as local
+    if (ch->local_receiver_count == 0)
+        ch->local_receiver_count = ch->receiver_count;
+
+    return 1;
+}
+
 MPI_Channel *channel_alloc_pt2pt_mpmc_buf(MPI_Channel *ch)
 {
     // Store type of channel
     ch->chan_type = MPMC;
 
-    // Update channel capacity to (a multiple of) receiver_count
-    if (ch->capacity % ch->receiver_count != 0)
-        ch->capacity += ch->receiver_count - ch->capacity % ch->receiver_count;
-
-    // Sender can send loc_capacity of data items to every receiver
-    ch->loc_capacity = ch->capacity / ch->receiver_count;
+    // Capacity is shared by all receivers; a sender can buffer up to capacity elements in total at any receivers
+    ch->buffered_items = 0;
 
     // Sender needs to allocate memory to store current count of buffered items at each receiver 
     if (!ch->is_receiver)
@@ -47,14 +121,21 @@ MPI_Channel *channel_alloc_pt2pt_mpmc_buf(MPI_Channel *ch)
     //ch->idx_last_rank = 0;
     ch->idx_last_rank = ch->my_rank % ch->sender_count;
 
-    // Adjust buffer depending on the rank
-    if (append_buffer(ch->is_receiver ? MPI_BSEND_OVERHEAD * ch->capacity * ch->sender_count : ch->receiver_count * 
-    ((int) ch->data_size + MPI_BSEND_OVERHEAD) * ch->capacity) != 1)
+    // Seed the random choice of receivers differently on every process
+    ch->choice_seed = ch->my_rank + 1;
+
+    // Set to NULL, makes following error handling easier; filled after the shadow comm exists
+    ch->receiver_order = NULL;
+
+    // Allocate send slots for the elements (sender) or credit messages (receiver) in transit
+    if (send_slots_alloc(ch, ch->is_receiver ? ch->capacity * ch->sender_count : ch->capacity, 
+    ch->is_receiver ? sizeof(int) : ch->data_size) != 1)
     {
-        ERROR("Error in append_buffer()\n");
+        ERROR("Error in send_slots_alloc()\n");
         free(ch->receiver_ranks);
         free(ch->sender_ranks);
         free(ch->receiver_buffered_items);
+        free(ch->receiver_order);
         channel_alloc_assert_success(ch->comm, 1);
         free(ch);
         return NULL;
@@ -65,29 +146,89 @@ MPI_Channel *channel_alloc_pt2pt_mpmc_buf(MPI_Channel *ch)
 
     // Create shadow comm and store it
     // Should be nothrow
-    if (MPI_Comm_dup(ch->comm, &ch->comm) != MPI_SUCCESS)
+    if (channel_comm_dup(ch, &ch->comm) != MPI_SUCCESS)
     {
         ERROR("Error in MPI_Comm_dup(): Fatal Error\n");
-        shrink_buffer(ch->is_receiver ? MPI_BSEND_OVERHEAD * ch->capacity * ch->sender_count : ch->receiver_count * 
-        ((int) ch->data_size + MPI_BSEND_OVERHEAD) * ch->capacity);
+        send_slots_free(ch);
+        free(ch->receiver_ranks);
+        free(ch->sender_ranks);
+        free(ch->receiver_buffered_items);
+        free(ch->receiver_order);
+        channel_alloc_assert_success(comm, 1);
+        free(ch);
+        return NULL;
+    }
+
+    // Order the receivers by node locality; same-node receivers are preferred by the sender
+    if (locality_pt2pt_mpmc_buf(ch) != 1)
+    {
+        ERROR("Error in locality_pt2pt_mpmc_buf()\n");
+        send_slots_free(ch);
+        MPI_Comm_free(&ch->comm);
+        free(ch->receiver_ranks);
+        free(ch->sender_ranks);
+        free(ch->receiver_buffered_items);
+        channel_alloc_assert_success(comm, 1);
+        free(ch);
+        return NULL;
+    }
+
+    // A same-node receiver is considered loaded once it buffers its share of the capacity
+    ch->remote_threshold = (ch->capacity + ch->receiver_count - 1) / ch->receiver_count;
+
+    // Create the window of one-sided credits if the receivers return credits with MPI_Accumulate()
+    if (ch->rma_credits && credit_win_alloc(ch) != 1)
+    {
+        ERROR("Error in credit_win_alloc()\n");
+        send_slots_free(ch);
+        MPI_Comm_free(&ch->comm);
         free(ch->receiver_ranks);
         free(ch->sender_ranks);
         free(ch->receiver_buffered_items);
+        free(ch->receiver_order);
         channel_alloc_assert_success(comm, 1);
         free(ch);
         return NULL;
     }
 
+    // Pre-post a receive for every element each sender can have in transit to this receiver
+    // A sender can send its whole capacity to a single receiver
+    if (ch->is_receiver && recv_slots_alloc(ch, ch->capacity) != 1)
+    {
+        ERROR("Error in recv_slots_alloc()\n");
+        if (ch->rma_credits)
+            credit_win_free(ch);
+        send_slots_free(ch);
+        MPI_Comm_free(&ch->comm);
+        free(ch->receiver_ranks);
+        free(ch->sender_ranks);
+        free(ch->receiver_buffered_items);
+        free(ch->receiver_order);
+        channel_alloc_assert_success(comm, 1);
+        free(ch);
+        return NULL;
+    }
+
+    // A sender spreads its capacity over every receiver and might block with a single element at this receiver, so
+    // the receiver cannot hold back credits
+    if (ch->is_receiver)
+        for (int i = 0; i < ch->sender_count; i++)
+            ch->credit_limits[i] = 1;
+
     // Final call to assure that every process was successfull
     // Use initial communicator since duplicated communicater has a new context
     if (channel_alloc_assert_success(comm, 0) != 1)
     {
         ERROR("Error in finalizing channel allocation: At least one process failed\n");
-        shrink_buffer(ch->is_receiver ? MPI_BSEND_OVERHEAD * ch->capacity * ch->sender_count : ch->receiver_count * 
-        ((int) ch->data_size + MPI_BSEND_OVERHEAD) * ch->capacity);
+        if (ch->rma_credits)
+            credit_win_free(ch);
+        if (ch->is_receiver)
+            recv_slots_free(ch);
+        send_slots_free(ch);
         free(ch->receiver_ranks);
         free(ch->sender_ranks);
         free(ch->receiver_buffered_items);
+        free(ch->receiver_order);
         free(ch);
         return NULL;
     }
@@ -97,74 +238,129 @@ MPI_Channel *channel_alloc_pt2pt_mpmc_buf(MPI_Channel *ch)
     return ch;
 }
 
+// Collects the credits of a receiver and decrements the buffered items at the receiver and in total
+static int credits_pt2pt_mpmc_buf(MPI_Channel *ch, int receiver, int block)
+{
+    // Collect the credits which have arrived from the receiver
+    if ((ch->credit = credits_collect(ch, receiver, block)) == -1)
+    {
+        ERROR("Error in credits_collect()\n");
+        return -1;
+    }
+
+    // Decrement buffered items by the number of elements the credits return
+    ch->receiver_buffered_items[receiver] -= ch->credit;
+    ch->buffered_items -= ch->credit;
+
+    return 1;
+}
+
 int channel_send_pt2pt_mpmc_buf(MPI_Channel *ch, void *data)
 {
+    // Used to store the result of a nonblocking send attempt
+    int sent;
+
     // Loop over all receivers starting from last receiver ch->idx_last_rank until data can be sent
-    while (1)
+    while ((sent = channel_trysend_pt2pt_mpmc_buf(ch, data)) == 0);
+
+    return sent;
+}
+
+int channel_trysend_pt2pt_mpmc_buf(MPI_Channel *ch, void *data)
+{
+    // Number of receivers on the node of the sender; they come first in receiver_order
+    int local = ch->local_receiver_count;
+
+    // If current receiver index is equal to count of same-node receivers reset to 0
+    if (ch->idx_last_rank >= local)
     {
-        // If current receiver index is equal to count of receiver reset to 0
-        if (ch->idx_last_rank >= ch->receiver_count)
-        {
-            ch->idx_last_rank = 0;
-        }
+        ch->idx_last_rank = 0;
+    }
+
+    // Power of two choices among the same-node receivers: the next one in round robin order and a random one
+    int first = ch->receiver_order[ch->idx_last_rank];
+    int second = ch->receiver_order[rand_r(&ch->choice_seed) % local];
+
+    // Collect the credits of both choices
+    if (credits_pt2pt_mpmc_buf(ch, first, 0) != 1 || (second != first && credits_pt2pt_mpmc_buf(ch, second, 0) != 1))
+    {
+        ERROR("Error in credits_pt2pt_mpmc_buf()\n");
+        return -1;
+    }
+
+    // Send to the less loaded choice, the round robin receiver wins ties
+    int target = ch->receiver_buffered_items[second] < ch->receiver_buffered_items[first] ? second : first;
+
+    // If the same-node receiver is loaded spill to the remote receivers
+    if (local < ch->receiver_count && ch->receiver_buffered_items[target] >= ch->remote_threshold)
+    {
+        // Power of two choices among the remote receivers, both random
+        first = ch->receiver_order[local + rand_r(&ch->choice_seed) % (ch->receiver_count - local)];
+        second = ch->receiver_order[local + rand_r(&ch->choice_seed) % (ch->receiver_count - local)];
 
-        // Check for incoming acknowledgement message from receiver r
-        if (MPI_Iprobe(ch->receiver_ranks[ch->idx_last_rank], 0, ch->comm, &ch->flag, MPI_STATUS_IGNORE) != MPI_SUCCESS)
+        if (credits_pt2pt_mpmc_buf(ch, first, 0) != 1 || (second != first && credits_pt2pt_mpmc_buf(ch, second, 0) != 1))
         {
-            ERROR("Error in MPI_Iprobe\n");
+            ERROR("Error in credits_pt2pt_mpmc_buf()\n");
             return -1;
         }
 
-        // An acknowledgment message can be received
-        while (ch->flag)
-        {
-            // Receive acknowledgement message from receiver
-            if (MPI_Recv(NULL, 0, MPI_BYTE, ch->receiver_ranks[ch->idx_last_rank], 0, ch->comm, MPI_STATUS_IGNORE) 
-            != MPI_SUCCESS)
-            {
-                ERROR("Error in MPI_Recv(): Acknowledgment message could not be received\n");
-                return -1;
-            }
-
-            // Decrement buffered items for receiver r
-            ch->receiver_buffered_items[ch->idx_last_rank]--;
+        // A remote receiver only takes the element if it is less loaded than the same-node receiver
+        int remote = ch->receiver_buffered_items[second] < ch->receiver_buffered_items[first] ? second : first;
+        if (ch->receiver_buffered_items[remote] < ch->receiver_buffered_items[target])
+            target = remote;
+    }
 
-            // Iprobe for more acknowledgment messages
-            if (MPI_Iprobe(ch->receiver_ranks[ch->idx_last_rank], 0, ch->comm, &ch->flag, MPI_STATUS_IGNORE) 
-            != MPI_SUCCESS)
+    // If the capacity of the sender is used up the credits of the other receivers may have arrived
+    if (ch->buffered_items >= ch->capacity)
+    {
+        for (int i = 0; i < ch->receiver_count; i++)
+        {
+            if (credits_pt2pt_mpmc_buf(ch, i, 0) != 1)
             {
-                ERROR("Error in MPI_Iprobe\n");
+                ERROR("Error in credits_pt2pt_mpmc_buf()\n");
                 return -1;
             }
         }
 
-        // If there is enough buffer space data can be sent to receiver r
-        if (ch->receiver_buffered_items[ch->idx_last_rank] < ch->loc_capacity)
+        // Every receiver still buffers elements of this sender
+        if (ch->buffered_items >= ch->capacity)
+            return 0;
+
+        // Send to the least loaded receiver, same-node receivers win ties
+        target = ch->receiver_order[0];
+        for (int i = 1; i < ch->receiver_count; i++)
         {
-            // Send data to receiver with buffered send
-            if (MPI_Bsend(data, ch->data_size, MPI_BYTE, ch->receiver_ranks[ch->idx_last_rank], 0, ch->comm) 
-            != MPI_SUCCESS)
-            {
-                ERROR("Error in MPI_Bsend()\n");
-                return -1;
-            }
+            if (ch->receiver_buffered_items[ch->receiver_order[i]] < ch->receiver_buffered_items[target])
+                target = ch->receiver_order[i];
+        }
+    }
 
-            // Increment buffered items for receiver r
-            ch->receiver_buffered_items[ch->idx_last_rank]++;
+    // Send data to receiver from a send slot
+    if (send_slots_isend(ch, data, ch->data_size, ch->receiver_ranks[target]) != 1)
+    {
+        ERROR("Error in send_slots_isend()\n");
+        return -1;
+    }
 
-            // Increment idx of last_rank
-            ch->idx_last_rank++;
+    // Increment buffered items for the receiver and in total
+    ch->receiver_buffered_items[target]++;
+    ch->buffered_items++;
 
-            return 1;
-        }
+    // Increment idx of last_rank
+    ch->idx_last_rank++;
 
-        // If buffer of receiver r is full try the next receiver
-        ch->idx_last_rank++;
-    }
+    return 1;
 }
 
 int channel_receive_pt2pt_mpmc_buf(MPI_Channel *ch, void *data)
 {
+    // Find the senders whose oldest element has arrived; blocks until there is one
+    if (recv_slots_wait(ch) == -1)
+    {
+        ERROR("Error in recv_slots_wait()\n");
+        return -1;
+    }
+
     // Loop over all senders starting from last sender ch->idx_last_rank until data can be received
     while (1)
     {
@@ -174,28 +370,20 @@ int channel_receive_pt2pt_mpmc_buf(MPI_Channel *ch, void *data)
             ch->idx_last_rank = 0;
         }
 
-        // Check for an incoming message
-        if (MPI_Iprobe(ch->sender_ranks[ch->idx_last_rank], 0, ch->comm, &ch->flag, MPI_STATUS_IGNORE) != MPI_SUCCESS)
-        {
-            ERROR("Error in MPI_Iprobe()\n");
-            return -1;
-        }
-
-        // If a message can be received
-        if (ch->flag)
+        // If the oldest element of the sender has arrived
+        if (ch->recv_arrived[ch->idx_last_rank])
         {
-            // Call blocking receive
-            if (MPI_Recv(data, ch->data_size, MPI_BYTE, ch->sender_ranks[ch->idx_last_rank], 0, ch->comm, &ch->status) 
-            != MPI_SUCCESS)
+            // Copy the element out of its slot and post the receive again
+            if (recv_slots_receive(ch, data, ch->idx_last_rank) != 1)
             {
-                ERROR("Error in MPI_Recv()\n");
+                ERROR("Error in recv_slots_receive()\n");
                 return -1;
             }
 
-            // Send acknowledgement message to source rank of data message
-            if (MPI_Bsend(NULL, 0, MPI_BYTE, ch->sender_ranks[ch->idx_last_rank], 0, ch->comm) != MPI_SUCCESS)
+            // Return the credit for the element to its sender; accumulated until half of its slots have been consumed
+            if (credits_return(ch, ch->idx_last_rank) != 1)
             {
-                ERROR("Error in MPI_Bsend(): Acknowledgement message could not be sent. Channel buffer could be invalid\n");
+                ERROR("Error in credits_return(): Credit message could not be sent\n");
                 return -1;
             }
 
@@ -215,127 +403,82 @@ int channel_peek_pt2pt_mpmc_buf(MPI_Channel *ch)
     // Check if sender is calling
     if (!ch->is_receiver)
     {
-        // For every receiver r in receiver_ranks check if acknowledgment messages can be received
+        // For every receiver r in receiver_ranks collect the credits which have arrived
         for (int i = 0; i < ch->receiver_count; i++)
         {
-            // If current receiver index is equal to count of receiver reset to 0
-            if (ch->idx_last_rank >= ch->receiver_count)
+            if (credits_pt2pt_mpmc_buf(ch, i, 0) != 1)
             {
-                ch->idx_last_rank = 0;
-            }
-
-            // Check for incoming acknowledgement messages from receiver
-            if (MPI_Iprobe(ch->receiver_ranks[ch->idx_last_rank], 0, ch->comm, &ch->flag, MPI_STATUS_IGNORE) 
-            != MPI_SUCCESS)
-            {
-                ERROR("Error in MPI_Iprobe\n");
+                ERROR("Error in credits_pt2pt_mpmc_buf()\n");
                 return -1;
             }
-
-            while (ch->flag)
-            {
-                // Receive acknowledgement messages from receiver
-                if (MPI_Recv(NULL, 0, MPI_BYTE, ch->receiver_ranks[ch->idx_last_rank], 0, ch->comm, MPI_STATUS_IGNORE) 
-                != MPI_SUCCESS)
-                {
-                    ERROR("Error in MPI_Recv(): Ack messages could not be received\n");
-                    return -1;
-                }
-
-                // Decrement count of buffered items for every received acknowledgement message
-                ch->receiver_buffered_items[ch->idx_last_rank]--;
-
-                // Check for more incoming acknowledgement messages from receiver
-                if (MPI_Iprobe(ch->receiver_ranks[ch->idx_last_rank], 0, ch->comm, &ch->flag, MPI_STATUS_IGNORE) 
-                != MPI_SUCCESS)
-                {
-                    ERROR("Error in MPI_Iprobe\n");
-                    return -1;
-                }
-            }
-
-            // Iprobe for acknowledgment messages of the next receiver
-            ch->idx_last_rank++;
-        }
-
-        // Take the sum of every buffered_items count for each receiver
-        int temp_cap = 0;
-        for (int i = 0; i < ch->receiver_count; i++)
-        {
-            temp_cap += ch->receiver_buffered_items[i];
         }
 
         // Returns the number of data messages which can be sent
-        return ch->capacity - temp_cap;
+        return ch->capacity - ch->buffered_items;
     }
     // Else the receiver is calling
     else
     {
-        // Checks if items can be received
-        if (MPI_Iprobe(MPI_ANY_SOURCE, 0, ch->comm, &ch->flag, MPI_STATUS_IGNORE) != MPI_SUCCESS)
-        {
-            ERROR("Error in MPI_Iprobe()\n");
-            return -1;
-        }
-
-        // Returns flag which is positive if at least one data message can be received
-        return ch->flag;
+        // Returns the number of senders whose oldest element has arrived in the pre-posted receives
+        return recv_slots_test(ch);
     }
 }
 
+int channel_drain_pt2pt_mpmc_buf(MPI_Channel *ch)
+{
+    // Receiver process has nothing to drain
+    if (ch->is_receiver)
+        return 1;
+
+    // Peeking consumes the acknowledgement messages which have arrived
+    if (channel_peek_pt2pt_mpmc_buf(ch) == -1)
+        return -1;
+
+    // Check if every receiver has acknowledged its messages
+    return ch->buffered_items == 0;
+}
+
 int channel_free_pt2pt_mpmc_buf(MPI_Channel *ch)
 {
     // Check if all messages have been sent and received
     // Needs to be done to assure that no message is on transit when channel is freed
     if (!ch->is_receiver)
-        // For every receiver r in receiver_ranks check if acknowledgment messages can be received
+        // For every receiver r in receiver_ranks wait for the credits of its buffered items
         for (int i = 0; i < ch->receiver_count; i++)
         {
-            // If current receiver index is equal to count of receiver reset to 0
-            if (ch->idx_last_rank >= ch->receiver_count)
+            while (ch->receiver_buffered_items[i] > 0)
             {
-                ch->idx_last_rank = 0;
-            }
-
-            while (ch->receiver_buffered_items[ch->idx_last_rank] > 0)
-            {
-                // Check for more incoming acknowledgement messages from receiver
-                if (MPI_Probe(ch->receiver_ranks[ch->idx_last_rank], 0, ch->comm, MPI_STATUS_IGNORE) != MPI_SUCCESS)
+                if (credits_pt2pt_mpmc_buf(ch, i, 1) != 1)
                 {
-                    ERROR("Error in MPI_Probe(): Probing for acknowledgment messages failed\n");
+                    ERROR("Error in credits_pt2pt_mpmc_buf()\n");
                     return -1;
-                }   
-
-                // Receive acknowledgement messages from receiver
-                if (MPI_Recv(NULL, 0, MPI_BYTE, ch->receiver_ranks[ch->idx_last_rank], 0, ch->comm, MPI_STATUS_IGNORE) 
-                != MPI_SUCCESS)
-                {
-                    ERROR("Error in MPI_Recv(): Acknowledgements could not be received\n")
-                    return -1;
-                } 
-
-                // Decrement count of buffered items for every received acknowledgement message
-                ch->receiver_buffered_items[ch->idx_last_rank]--;      
+                }
             }
-
-            // Go to next rank
-            ch->idx_last_rank++;
         }
 
-    // Free memory used for storing buffered items for each receiver
+    // Cancel the pre-posted receives of the receiver
+    if (ch->is_receiver)
+        recv_slots_free(ch);
+
+    // Free memory used for storing buffered items for each receiver and the locality order
     free(ch->receiver_buffered_items);
+    free(ch->receiver_order);
 
     // Free allocated memory used for storing ranks
     free(ch->receiver_ranks);
     free(ch->sender_ranks);
 
+    // Wait for the messages in transit and release the send slots
+    int error = send_slots_free(ch);
+
+    // Release the window of one-sided credits
+    if (ch->rma_credits)
+        credit_win_free(ch);
+
     // Mark shadow comm for deallocation
     // Should be nothrow since shadow comm duplication was successful
     MPI_Comm_free(&ch->comm);
 
-    // Adjust buffer depending on the rank
-    int error = shrink_buffer(ch->is_receiver ? MPI_BSEND_OVERHEAD * ch->capacity * ch->sender_count : 
-    ch->receiver_count * ((int) ch->data_size + MPI_BSEND_OVERHEAD) * ch->capacity);
 
     // Deallocate channel
     free(ch);
@@ -6,20 +6,27 @@
  * @date 2021-04-26
  * @copyright CC BY 4.0 (https://creativecommons.org/licenses/by/4.0/)
  * 
- * This PT2PT MPMC BUF channel implementation uses the buffered send mode of MPI. To bookmark the count of sent elements
- * the sender process stores the current buffer size, decrements it for every sent element and increments it for every
- * received acknowledgement message from the receiver. The channel capacity is resized to a multiple of the number of 
- * receivers to achieve the same local buffer capacity for every receiver. To assert a correct usage of the buffered 
- * send mode channel_alloc_pt2pt_mpmc_buf() needs to append enough memory for the receiver and the sender. To guarantee 
- * a fair and starvation-free implementation both the receiver and sender process iterate over the processes and 
- * remember the last process they have sent to/received from. The sender process checks for incoming acknowledgment 
- * messages and sends the element to the receiver iterating over them. The receiver process iterates over all senders 
- * starting from the last sender rank it received from, checks for incoming elements, receives the element and sends an 
- * acknowledgment message.
- * 
- * Important usage note: Depending on the arrival of the acknowledgement messages one receiver might receive more 
- * elements than another receiver. Therefore it might happen that a sender process which sends 10 elements, sends 8 to
- * receiver process A and 2 to receiver process B.
+ * This PT2PT MPMC BUF channel implementation sends every message with MPI_Isend() from a ring of send slots owned by 
+ * the channel. To bookmark the count of sent elements the sender process stores the current buffer size, decrements it
+ * for every sent element and increments it by the count of every received credit message from the receiver. The channel
+ * capacity is not split among the receivers: a sender can buffer up to capacity elements in total, at one receiver or
+ * spread over all of them. channel_alloc_pt2pt_mpmc_buf() allocates enough send slots for the receiver and the sender;
+ * completed slots are reclaimed with MPI_Testsome(), so no buffer needs to be attached for MPI_Bsend(). The sender
+ * process chooses the receiver by power of two choices: it collects the credits of the next receiver in round robin
+ * order and of a random receiver and sends the element to the one which buffers fewer of its elements. Only if its
+ * capacity is used up it collects the credits of every receiver and sends to the least loaded one. A slow receiver
+ * therefore gets fewer elements instead of blocking the sender while other receivers are idle. Both choices are drawn
+ * from the receivers on the node of the sender, detected with MPI_Comm_split_type() at allocation. Once the chosen
+ * receiver buffers its share of the capacity (capacity / receivers) the sender also draws two remote receivers and
+ * sends to one of them if it is less loaded, so elements only cross nodes under load. The receiver process
+ * keeps a receive pre-posted for every element a sender can have in transit to it, i.e. capacity receives per sender,
+ * and finds the senders whose oldest element has arrived with a single MPI_Testsome(), or blocks in MPI_Waitany() if
+ * there is none. It serves these senders starting from the last sender rank it received from, receives the element
+ * and counts it as credit of the sender. The credit is returned in one message once half of the capacity of the sender
+ * has been consumed, or earlier if its next element has not arrived yet.
+ *
+ * Important usage note: The elements of a sender are distributed by the load of the receivers. Therefore it might
+ * happen that a sender process which sends 10 elements, sends 8 to receiver process A and 2 to receiver process B.
  */
 
 #ifndef PT2PT_MPMC_BUF_H
@@ -31,9 +38,9 @@
  * @brief Updates the properties of a passed MPI_Channel of type PT2PT MPMC BUF and returns it.
  * @param[in, out] ch Pointer to a MPI_Channel allocated with channel_alloc(). 
  * @return Returns a pointer to a valid MPI_Channel with updated properties if updating was successful and NULL otherwise
- * @note Returns NULL if appending the buffer failed.
- * @note Every sender can send n messages until the buffer is exhausted. This means that n * |sender| data messages can
- * arrive at the receiver without calling channel_receive() in between.
+ * @note Returns NULL if allocating the send slots failed.
+ * @note Every sender can send n messages until the buffer is exhausted, all of them possibly to the same receiver. This
+ * means that n * |sender| data messages can arrive at a receiver without calling channel_receive() in between.
  */
 MPI_Channel* channel_alloc_pt2pt_mpmc_buf(MPI_Channel* ch);
 
@@ -48,6 +55,16 @@ MPI_Channel* channel_alloc_pt2pt_mpmc_buf(MPI_Channel* ch);
  */
 int channel_send_pt2pt_mpmc_buf(MPI_Channel *ch, void *data);
 
+/**
+ * @brief Sends the element only if the channel buffer has not reached the channel capacity. Calling 
+ * channel_trysend_pt2pt_mpmc_buf() never blocks and is used by unbounded channels to hand over staged elements.
+ * @param[in] ch Pointer to a MPI_Channel of type PT2PT MPMC BUF.              
+ * @param[in] data Pointer to a memory adress of which size bytes will be sent from.
+ * @return Returns 1 if the element has been sent, 0 if the channel buffer is full and -1 if an error occured.
+ * @note Returns -1 if internal problems with MPI related functions happend.
+ */
+int channel_trysend_pt2pt_mpmc_buf(MPI_Channel *ch, void *data);
+
 /**
  * @brief Receives the numbers of bytes of a data element specified in channel_alloc() from the channel and stores them
  * starting at the adress the void pointer holds. Calling channel_receive_pt2pt_mpmc_buf() blocks only if no element has
@@ -64,19 +81,26 @@ int channel_receive_pt2pt_mpmc_buf(MPI_Channel *ch, void *data);
  * calls).
  * @param[in] ch Pointer to a MPI_Channel of type PT2PT MPMC BUF.                 
  * @return If the sender process calls it returns the current number of elements which can be sent. If the receiver 
- * process calls it returns 1 if a message can be received and 0 if no message can be received. If an error occures it
- * returns -1. 
+ * process calls it returns the number of senders whose oldest element has arrived. If an error occures it returns -1.
  * @note Returns -1 if internal problems with MPI related functions happen.
- * @note Since MPI will only let you check if and not how many messages can be received (MPI_Iprobe()) this function 
- * cannot return the number of buffered messages to the receiver.
  */
 int channel_peek_pt2pt_mpmc_buf(MPI_Channel *ch);
 
+/**
+ * @brief Consumes the acknowledgement messages which have arrived at the sender process without blocking. Used by 
+ * channel_ifree() to drain the channel before it is freed.
+ * @param[in] ch Pointer to a MPI_Channel of type PT2PT MPMC BUF.
+ * @return Returns 1 if every message of the sender process has been acknowledged or the receiver process calls, 0 if 
+ * messages are still unacknowledged and -1 if an error occured.
+ * @note Returns -1 if internal problems with MPI related functions happen.
+ */
+int channel_drain_pt2pt_mpmc_buf(MPI_Channel *ch);
+
 /**
  * @brief Deallocates the channel and all allocated members.
  * @param[in] ch Pointer to a MPI_Channel of type PT2PT MPMC BUF.                            
  * @return Returns 1 if deallocation was successful, -1 otherwise.
- * @note This function returns -1 if resizing of the buffer for MPI_Bsend() failed.
+ * @note This function returns -1 if a message in transit could not be completed.
  */
 int channel_free_pt2pt_mpmc_buf(MPI_Channel *ch);
 
@@ -0,0 +1,406 @@
+/**
+ * @file PT2PT_MPMC_BUF_PULL.c
+ * @author Toni Hollfelder (Toni.Hollfelder@uni-bayreuth.de)
+ * @brief Implementation of PT2PT MPMC BUF Channels in pull mode
+ * @version 1.0
+ * @date 2021-07-09
+ * @copyright CC BY 4.0 (https://creativecommons.org/licenses/by/4.0/)
+ */
+
+#include "PT2PT_MPMC_BUF_PULL.h"
+
+#define HEAD 0
+#define TAIL 1
+
+// Number of slots of the queue of demands; at least the number of demands which can be pending at the same time
+#define DEMAND_COUNT(ch) ((ch)->demand_count)
+
+// Index of the sequence number of the demand slot of ticket i; the rank of the demand follows it
+#define SEQ(ch, i) (2 + 2 * (int) ((unsigned int) (i) % (unsigned int) DEMAND_COUNT(ch)))
+#define RANK(ch, i) (SEQ(ch, i) + 1)
+
+// Sequence numbers wrap around like the tickets
+#define TICKET(i) ((int) (unsigned int) (i))
+
+// Used for mpi calls as origin buffer
+const int pt2pt_mpmc_buf_pull_one = 1;
+
+// Spins until the integer at index disp of the queue of demands at the first receiver has the value seq
+static int wait_pt2pt_mpmc_buf_pull(MPI_Channel *ch, int disp, int seq)
+{
+    // Used to store the fetched value
+    int value;
+
+    do
+    {
+        if (MPI_Fetch_and_op(NULL, &value, MPI_INT, ch->receiver_ranks[0], disp, MPI_NO_OP, ch->win) != MPI_SUCCESS)
+        {
+            ERROR("Error in MPI_Fetch_and_op()\n");
+            return -1;
+        }
+
+        if (MPI_Win_flush(ch->receiver_ranks[0], ch->win) != MPI_SUCCESS)
+        {
+            ERROR("Error in MPI_Win_flush()\n");
+            return -1;
+        }
+    } while (value != seq);
+
+    return 1;
+}
+
+// Atomically stores value at index disp of the queue of demands at the first receiver; completes before returning
+static int store_pt2pt_mpmc_buf_pull(MPI_Channel *ch, int disp, int value)
+{
+    if (MPI_Accumulate(&value, 1, MPI_INT, ch->receiver_ranks[0], disp, 1, MPI_INT, MPI_REPLACE, ch->win) != MPI_SUCCESS)
+    {
+        ERROR("Error in MPI_Accumulate()\n");
+        return -1;
+    }
+
+    if (MPI_Win_flush(ch->receiver_ranks[0], ch->win) != MPI_SUCCESS)
+    {
+        ERROR("Error in MPI_Win_flush()\n");
+        return -1;
+    }
+
+    return 1;
+}
+
+// Appends a demand of the calling receiver to the queue of demands at the first receiver
+static int demand_pt2pt_mpmc_buf_pull(MPI_Channel *ch)
+{
+    // Used to store the fetched tail
+    int tail;
+
+    // Reserve the next ticket
+    if (MPI_Fetch_and_op(&pt2pt_mpmc_buf_pull_one, &tail, MPI_INT, ch->receiver_ranks[0], TAIL, MPI_SUM, ch->win) 
+    != MPI_SUCCESS)
+    {
+        ERROR("Error in MPI_Fetch_and_op()\n");
+        return -1;
+    }
+
+    if (MPI_Win_flush(ch->receiver_ranks[0], ch->win) != MPI_SUCCESS)
+    {
+        ERROR("Error in MPI_Win_flush()\n");
+        return -1;
+    }
+
+    // Wait until the sender of the previous ticket of the slot has taken its rank out
+    if (wait_pt2pt_mpmc_buf_pull(ch, SEQ(ch, tail), tail) != 1)
+    {
+        ERROR("Error in wait_pt2pt_mpmc_buf_pull()\n");
+        return -1;
+    }
+
+    // Store the rank and afterwards mark the slot as filled for the ticket
+    if (store_pt2pt_mpmc_buf_pull(ch, RANK(ch, tail), ch->my_rank) != 1 || 
+    store_pt2pt_mpmc_buf_pull(ch, SEQ(ch, tail), TICKET((unsigned int) tail + 1)) != 1)
+    {
+        ERROR("Error in store_pt2pt_mpmc_buf_pull()\n");
+        return -1;
+    }
+
+    return 1;
+}
+
+// Atomically loads head and tail of the queue of demands at the first receiver
+static int load_pt2pt_mpmc_buf_pull(MPI_Channel *ch, int *indices)
+{
+    if (MPI_Get_accumulate(NULL, 0, MPI_INT, indices, 2, MPI_INT, ch->receiver_ranks[0], HEAD, 2, MPI_INT, MPI_NO_OP, 
+    ch->win) != MPI_SUCCESS)
+    {
+        ERROR("Error in MPI_Get_accumulate()\n");
+        return -1;
+    }
+
+    if (MPI_Win_flush(ch->receiver_ranks[0], ch->win) != MPI_SUCCESS)
+    {
+        ERROR("Error in MPI_Win_flush()\n");
+        return -1;
+    }
+
+    return 1;
+}
+
+MPI_Channel *channel_alloc_pt2pt_mpmc_buf_pull(MPI_Channel *ch)
+{
+    // Store type of channel
+    ch->chan_type = MPMC;
+
+    // Tickets are 32 bit integers which wrap around, so the number of slots needs to divide 2^32; otherwise the slot of
+    // a ticket and the sequence number freeing it stop matching once the counter wraps. Round the number of demands
+    // which can be pending at the same time up to a power of two
+    ch->demand_count = 1;
+    while (ch->demand_count < ch->capacity * ch->receiver_count)
+        ch->demand_count *= 2;
+
+    // Size of the queue of demands; only the first receiver exposes memory
+    MPI_Aint win_size = ch->my_rank == ch->receiver_ranks[0] ? (2 + 2 * DEMAND_COUNT(ch)) * sizeof(int) : 0;
+
+    // Allocate send slots for the elements in transit; receivers send no messages
+    if (send_slots_alloc(ch, ch->is_receiver ? 1 : ch->capacity, ch->is_receiver ? 0 : ch->data_size) != 1)
+    {
+        ERROR("Error in send_slots_alloc()\n");
+        free(ch->receiver_ranks);
+        free(ch->sender_ranks);
+        channel_alloc_assert_success(ch->comm, 1);
+        free(ch);
+        return NULL;
+    }
+
+    // Create backup in case of failing MPI_Comm_dup
+    MPI_Comm comm = ch->comm;
+
+    // Create shadow comm and store it
+    // Should be nothrow
+    if (channel_comm_dup(ch, &ch->comm) != MPI_SUCCESS)
+    {
+        ERROR("Error in MPI_Comm_dup(): Fatal Error\n");
+        send_slots_free(ch);
+        free(ch->receiver_ranks);
+        free(ch->sender_ranks);
+        channel_alloc_assert_success(comm, 1);
+        free(ch);
+        return NULL;
+    }
+
+    // Allocate the queue of demands; initialized before any process can access it
+    if (MPI_Alloc_mem(win_size + 1, MPI_INFO_NULL, &ch->win_lmem) != MPI_SUCCESS)
+    {
+        ERROR("Error in MPI_Alloc_mem()\n");
+        send_slots_free(ch);
+        MPI_Comm_free(&ch->comm);
+        free(ch->receiver_ranks);
+        free(ch->sender_ranks);
+        channel_alloc_assert_success(comm, 1);
+        free(ch);
+        return NULL;
+    }
+    memset(ch->win_lmem, 0, win_size);
+
+    // Slot i is free for ticket i
+    for (int i = 0; win_size > 0 && i < DEMAND_COUNT(ch); i++)
+        ((int *) ch->win_lmem)[SEQ(ch, i)] = i;
+
+    // Create window object
+    if (MPI_Win_create(ch->win_lmem, win_size, sizeof(int), ch->info, ch->comm, &ch->win) != MPI_SUCCESS)
+    {
+        ERROR("Error in MPI_Win_create()\n");
+        MPI_Free_mem(ch->win_lmem);
+        send_slots_free(ch);
+        MPI_Comm_free(&ch->comm);
+        free(ch->receiver_ranks);
+        free(ch->sender_ranks);
+        channel_alloc_assert_success(comm, 1);
+        free(ch);
+        return NULL;
+    }
+
+    // Keep a shared lock on every process for the lifetime of the channel
+    if (MPI_Win_lock_all(0, ch->win) != MPI_SUCCESS)
+    {
+        ERROR("Error in MPI_Win_lock_all()\n");
+        MPI_Win_free(&ch->win);
+        MPI_Free_mem(ch->win_lmem);
+        send_slots_free(ch);
+        MPI_Comm_free(&ch->comm);
+        free(ch->receiver_ranks);
+        free(ch->sender_ranks);
+        channel_alloc_assert_success(comm, 1);
+        free(ch);
+        return NULL;
+    }
+
+    // Receiver demands capacity elements in advance; the queue of demands has room for them, so no receiver waits
+    int failed = 0;
+    for (int i = 0; ch->is_receiver && !failed && i < ch->capacity; i++)
+    {
+        if (demand_pt2pt_mpmc_buf_pull(ch) != 1)
+        {
+            ERROR("Error in demand_pt2pt_mpmc_buf_pull()\n");
+            failed = 1;
+        }
+    }
+
+    // Final call to assure that every process was successfull
+    // Use initial communicator since duplicated communicater has a new context
+    if (channel_alloc_assert_success(comm, failed) != 1)
+    {
+        ERROR("Error in finalizing channel allocation: At least one process failed\n");
+        MPI_Win_unlock_all(ch->win);
+        MPI_Win_free(&ch->win);
+        MPI_Free_mem(ch->win_lmem);
+        send_slots_free(ch);
+        MPI_Comm_free(&ch->comm);
+        free(ch->receiver_ranks);
+        free(ch->sender_ranks);
+        free(ch);
+        return NULL;
+    }
+
+    DEBUG("PT2PT MPMC BUF PULL finished allocation\n");
+
+    return ch;
+}
+
+int channel_send_pt2pt_mpmc_buf_pull(MPI_Channel *ch, void *data)
+{
+    // Used to store the result of a nonblocking send attempt
+    int sent;
+
+    // Try to claim a demand until a receiver has one pending
+    while ((sent = channel_trysend_pt2pt_mpmc_buf_pull(ch, data)) == 0);
+
+    return sent;
+}
+
+int channel_trysend_pt2pt_mpmc_buf_pull(MPI_Channel *ch, void *data)
+{
+    // Used to store head and tail of the queue of demands and the result of the compare and swap
+    int indices[2];
+    int head;
+
+    // Claim the oldest demand; fails only if another sender has claimed it in between
+    do
+    {
+        if (load_pt2pt_mpmc_buf_pull(ch, indices) != 1)
+        {
+            ERROR("Error in load_pt2pt_mpmc_buf_pull()\n");
+            return -1;
+        }
+
+        // No demand is pending
+        if (indices[HEAD] == indices[TAIL])
+            return 0;
+
+        // Move head to the next demand if no other sender has done so
+        int next = (int) ((unsigned int) indices[HEAD] + 1);
+        if (MPI_Compare_and_swap(&next, &indices[HEAD], &head, MPI_INT, ch->receiver_ranks[0], HEAD, ch->win) 
+        != MPI_SUCCESS)
+        {
+            ERROR("Error in MPI_Compare_and_swap()\n");
+            return -1;
+        }
+
+        if (MPI_Win_flush(ch->receiver_ranks[0], ch->win) != MPI_SUCCESS)
+        {
+            ERROR("Error in MPI_Win_flush()\n");
+            return -1;
+        }
+    } while (head != indices[HEAD]);
+
+    // Wait until the receiver has filled the slot of the claimed ticket
+    if (wait_pt2pt_mpmc_buf_pull(ch, SEQ(ch, head), TICKET((unsigned int) head + 1)) != 1)
+    {
+        ERROR("Error in wait_pt2pt_mpmc_buf_pull()\n");
+        return -1;
+    }
+
+    // Take the rank out of the slot
+    int rank;
+    if (MPI_Fetch_and_op(NULL, &rank, MPI_INT, ch->receiver_ranks[0], RANK(ch, head), MPI_NO_OP, ch->win) != MPI_SUCCESS)
+    {
+        ERROR("Error in MPI_Fetch_and_op()\n");
+        return -1;
+    }
+
+    if (MPI_Win_flush(ch->receiver_ranks[0], ch->win) != MPI_SUCCESS)
+    {
+        ERROR("Error in MPI_Win_flush()\n");
+        return -1;
+    }
+
+    // Free the slot for the ticket which uses it next
+    if (store_pt2pt_mpmc_buf_pull(ch, SEQ(ch, head), TICKET((unsigned int) head + DEMAND_COUNT(ch))) != 1)
+    {
+        ERROR("Error in store_pt2pt_mpmc_buf_pull()\n");
+        return -1;
+    }
+
+    // Send data to the receiver of the demand from a send slot
+    if (send_slots_isend(ch, data, ch->data_size, rank) != 1)
+    {
+        ERROR("Error in send_slots_isend()\n");
+        return -1;
+    }
+
+    return 1;
+}
+
+int channel_receive_pt2pt_mpmc_buf_pull(MPI_Channel *ch, void *data)
+{
+    // Only senders which have claimed a demand of this receiver send elements to it
+    if (MPI_Recv(data, ch->data_size, MPI_BYTE, MPI_ANY_SOURCE, 0, ch->comm, MPI_STATUS_IGNORE) != MPI_SUCCESS)
+    {
+        ERROR("Error in MPI_Recv(): Data could not be received; Channel might be broken\n");
+        return -1;
+    }
+
+    // Replace the served demand
+    if (demand_pt2pt_mpmc_buf_pull(ch) != 1)
+    {
+        ERROR("Error in demand_pt2pt_mpmc_buf_pull()\n");
+        return -1;
+    }
+
+    return 1;
+}
+
+int channel_peek_pt2pt_mpmc_buf_pull(MPI_Channel *ch)
+{
+    // Check if sender is calling
+    if (!ch->is_receiver)
+    {
+        // Used to store head and tail of the queue of demands
+        int indices[2];
+
+        if (load_pt2pt_mpmc_buf_pull(ch, indices) != 1)
+        {
+            ERROR("Error in load_pt2pt_mpmc_buf_pull()\n");
+            return -1;
+        }
+
+        // Returns the number of pending demands
+        return (int) ((unsigned int) indices[TAIL] - (unsigned int) indices[HEAD]);
+    }
+    // Else the receiver is calling
+    else
+    {
+        // Check if a demanded element has arrived
+        if (MPI_Iprobe(MPI_ANY_SOURCE, 0, ch->comm, &ch->flag, MPI_STATUS_IGNORE) != MPI_SUCCESS)
+        {
+            ERROR("Error in MPI_Iprobe()\n");
+            return -1;
+        }
+
+        return ch->flag;
+    }
+}
+
+int channel_free_pt2pt_mpmc_buf_pull(MPI_Channel *ch)
+{
+    // Wait for the messages in transit and release the send slots
+    int error = send_slots_free(ch);
+
+    // Free allocated memory used for storing ranks
+    free(ch->receiver_ranks);
+    free(ch->sender_ranks);
+
+    // Release the queue of demands; pending demands of the receivers are dropped
+    // Should be nothrow since the window has been locked successfully
+    MPI_Win_unlock_all(ch->win);
+    MPI_Win_free(&ch->win);
+    MPI_Free_mem(ch->win_lmem);
+
+    // Mark shadow comm for deallocation
+    // Should be nothrow since shadow comm duplication was successful
+    MPI_Comm_free(&ch->comm);
+
+    // Deallocate channel
+    free(ch);
+    ch = NULL;
+
+    return error;
+}
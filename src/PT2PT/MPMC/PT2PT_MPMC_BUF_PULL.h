@@ -0,0 +1,96 @@
+/**
+ * @file PT2PT_MPMC_BUF_PULL.h
+ * @author Toni Hollfelder (Toni.Hollfelder@uni-bayreuth.de)
+ * @brief Header of PT2PT MPMC BUF Channel in pull mode
+ * @version 1.0
+ * @date 2021-07-09
+ * @copyright CC BY 4.0 (https://creativecommons.org/licenses/by/4.0/)
+ *
+ * This PT2PT MPMC BUF channel implementation is used if the channel is allocated with channel_alloc_info() and the
+ * key mpi_channel_distribution set to "pull". Instead of the senders pushing the elements to the receivers, every
+ * receiver asks for elements: it posts a demand into a queue of demands in the window of the first receiver and a
+ * sender serves the oldest pending demand by sending its element to the receiver of that demand. Every receiver keeps
+ * capacity demands pending and posts a new one for every element it receives, so fast receivers take more elements
+ * and an element is only sent to a receiver which has room for it.
+ *
+ * Layout of local window memory of the first receiver; the window of every other process is empty:
+ * | HEAD | TAIL | SEQ_0 | RANK_0 | ... | SEQ_N | RANK_N |    where N + 1 = capacity * receivers rounded up to 2^k
+ *
+ * HEAD and TAIL count the claimed and the posted demands. A receiver takes the next ticket by incrementing TAIL with
+ * MPI_Fetch_and_op(), waits until the sequence number of the slot of its ticket equals the ticket, stores its rank and
+ * then sets the sequence number to ticket + 1. A sender claims the ticket at HEAD with MPI_Compare_and_swap(), waits
+ * for the sequence number ticket + 1, takes the rank out of the slot and sets the sequence number to ticket + N + 1,
+ * which frees the slot for the next ticket using it. The elements are sent with MPI_Isend() from a ring of send slots
+ * owned by the channel and received with MPI_Recv() from any sender. Claiming demands in ticket order keeps the
+ * implementation fair for the receivers.
+ *
+ * Regarding progress guarantees claiming a demand is lock-free for the sender process: it only fails if another sender
+ * has claimed the demand. Afterwards the sender waits only for the receiver of the demand to finish storing its rank.
+ */
+
+#ifndef PT2PT_MPMC_BUF_PULL_H
+#define PT2PT_MPMC_BUF_PULL_H
+
+#include "../../MPI_Channel_Struct.h"
+
+/**
+ * @brief Updates the properties of a passed MPI_Channel of type PT2PT MPMC BUF PULL and returns it.
+ * @param[in, out] ch Pointer to a MPI_Channel allocated with channel_alloc_info().
+ * @return Returns a pointer to a valid MPI_Channel with updated properties if updating was successful and NULL otherwise
+ * @note Returns NULL if MPI related functions or allocation memory failure happend.
+ * @note Every receiver demands capacity elements in advance. This means that capacity data messages can arrive at a
+ * receiver without calling channel_receive() in between.
+ */
+MPI_Channel *channel_alloc_pt2pt_mpmc_buf_pull(MPI_Channel *ch);
+
+/**
+ * @brief Sends the numbers of bytes of a data element specified in channel_alloc_info() starting at the adress the
+ * void pointer holds into the channel. Calling channel_send_pt2pt_mpmc_buf_pull() blocks only if no receiver has a
+ * pending demand.
+ * @param[in] ch Pointer to a MPI_Channel of type PT2PT MPMC BUF PULL.
+ * @param[in] data Pointer to a memory adress of which size bytes will be sent from.
+ * @return Returns 1 if sending was successful, -1 otherwise.
+ * @note Returns -1 if internal problems with MPI related functions happend.
+ */
+int channel_send_pt2pt_mpmc_buf_pull(MPI_Channel *ch, void *data);
+
+/**
+ * @brief Sends the element only if a receiver has a pending demand. Calling channel_trysend_pt2pt_mpmc_buf_pull()
+ * never blocks and is used by unbounded channels to hand over staged elements.
+ * @param[in] ch Pointer to a MPI_Channel of type PT2PT MPMC BUF PULL.
+ * @param[in] data Pointer to a memory adress of which size bytes will be sent from.
+ * @return Returns 1 if the element has been sent, 0 if no demand is pending and -1 if an error occured.
+ * @note Returns -1 if internal problems with MPI related functions happend.
+ */
+int channel_trysend_pt2pt_mpmc_buf_pull(MPI_Channel *ch, void *data);
+
+/**
+ * @brief Receives the numbers of bytes of a data element specified in channel_alloc_info() from the channel and stores
+ * them starting at the adress the void pointer holds and demands the next element. Calling
+ * channel_receive_pt2pt_mpmc_buf_pull() blocks only if no demanded element has arrived.
+ * @param[in] ch Pointer to a MPI_Channel of type PT2PT MPMC BUF PULL.
+ * @param[in] data Pointer to a memory adress of which size bytes will be received to.
+ * @return Returns 1 if receiving was successful, -1 otherwise.
+ * @note Returns -1 if internal problems with MPI related functions happend.
+ */
+int channel_receive_pt2pt_mpmc_buf_pull(MPI_Channel *ch, void *data);
+
+/**
+ * @brief Peeks at the channel and signals if messages can be sent (sender process calls) or received (receiver process
+ * calls).
+ * @param[in] ch Pointer to a MPI_Channel of type PT2PT MPMC BUF PULL.
+ * @return Returns the number of pending demands if the sender process calls and 1 if a demanded element has arrived,
+ * 0 otherwise, if the receiver process calls.
+ * @note Returns -1 if internal problems with MPI related functions happend.
+ */
+int channel_peek_pt2pt_mpmc_buf_pull(MPI_Channel *ch);
+
+/**
+ * @brief Deallocates the channel and all allocated members. Freeing the window makes channel_free() collective.
+ * @param[in] ch Pointer to a MPI_Channel of type PT2PT MPMC BUF PULL.
+ * @return Returns 1 if deallocation was successfull, -1 otherwise
+ * @note Returns -1 if internal problems with MPI related functions happend.
+ */
+int channel_free_pt2pt_mpmc_buf_pull(MPI_Channel *ch);
+
+#endif // PT2PT_MPMC_BUF_PULL_H
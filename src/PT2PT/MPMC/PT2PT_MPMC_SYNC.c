@@ -74,7 +74,7 @@ MPI_Channel *channel_alloc_pt2pt_mpmc_sync(MPI_Channel *ch)
 
     // Create shadow comm and store it
     // Should be nothrow
-    if (MPI_Comm_dup(ch->comm, &ch->comm) != MPI_SUCCESS)
+    if (channel_comm_dup(ch, &ch->comm) != MPI_SUCCESS)
     {
         ERROR("Error in MPI_Comm_dup(): Fatal Error\n");
         shrink_buffer(ch->is_receiver ? (sizeof(int) + MPI_BSEND_OVERHEAD) * ch->sender_count : (sizeof(int) + MPI_BSEND_OVERHEAD) * ch->receiver_count);
@@ -273,32 +273,54 @@ int channel_receive_pt2pt_mpmc_sync(MPI_Channel *ch, void *data)
             return -1;
         }
 
-        // Wait for data or cancel message
-        if (MPI_Probe(ch->status.MPI_SOURCE, MPI_ANY_TAG, ch->comm, &ch->status) != MPI_SUCCESS)
+        // Wait for data or cancel message and match it
+        if (MPI_Mprobe(ch->status.MPI_SOURCE, MPI_ANY_TAG, ch->comm, &ch->message, &ch->status) != MPI_SUCCESS)
         {
-            ERROR("Error in MPI_Probe(): Probing for data/cancel message failed; Channel might be broken\n");
+            ERROR("Error in MPI_Mprobe(): Probing for data/cancel message failed; Channel might be broken\n");
             return -1;
         }
 
         // If tag of incoming message is not comm_size calling message contains data
         if (ch->status.MPI_TAG != ch->comm_size)
         {
-            if (MPI_Recv(data, ch->data_size, MPI_BYTE, ch->status.MPI_SOURCE, ch->status.MPI_SOURCE, ch->comm, MPI_STATUS_IGNORE) != MPI_SUCCESS)
+            if (MPI_Mrecv(data, ch->data_size, MPI_BYTE, &ch->message, MPI_STATUS_IGNORE) != MPI_SUCCESS)
             {
-                ERROR("Error in MPI_Recv(): Data could not be received; Channel might be broken\n");
+                ERROR("Error in MPI_Mrecv(): Data could not be received; Channel might be broken\n");
                 return -1;
             }
             return 1;
         }
         // Else incoming message is a cancel message
-        if (MPI_Recv(NULL, 0, MPI_INT, ch->status.MPI_SOURCE, ch->comm_size, ch->comm, MPI_STATUS_IGNORE) != MPI_SUCCESS)
+        if (MPI_Mrecv(NULL, 0, MPI_INT, &ch->message, MPI_STATUS_IGNORE) != MPI_SUCCESS)
         {
-            ERROR("Error in MPI_Recv(): Cancel message could not be received; Channel might be broken\n");
+            ERROR("Error in MPI_Mrecv(): Cancel message could not be received; Channel might be broken\n");
             return -1;
         }
     }
 }
 
+int channel_peek_pt2pt_mpmc_sync(MPI_Channel *ch)
+{
+    // Receivers only show up when answering send requests, so a sender cannot observe them
+    if (!ch->is_receiver)
+        return 1;
+
+    // Send requests are tagged with the rank of the sender, stale cancel messages are tagged with comm_size
+    for (int i = 0; i < ch->sender_count; i++)
+    {
+        if (MPI_Iprobe(ch->sender_ranks[i], ch->sender_ranks[i], ch->comm, &ch->flag, MPI_STATUS_IGNORE) != MPI_SUCCESS)
+        {
+            ERROR("Error in MPI_Iprobe()\n");
+            return -1;
+        }
+
+        if (ch->flag)
+            return 1;
+    }
+
+    return 0;
+}
+
 int channel_free_pt2pt_mpmc_sync(MPI_Channel *ch)
 {
     // Need to assure that all messages have been received before freeing the channel
@@ -54,6 +54,18 @@ int channel_send_pt2pt_mpmc_sync(MPI_Channel *ch, void *data);
  */
 int channel_receive_pt2pt_mpmc_sync(MPI_Channel *ch, void *data);
 
+/**
+ * @brief Peeks at the channel and signals if a matching sender is waiting. The receiver process probes for a send
+ * request of any sender. Since the sender might choose another receiver which answered its send request first, a
+ * following channel_receive_pt2pt_mpmc_sync() might still block. Since receivers do not announce themselves a sender
+ * process always gets 1.
+ * @param[in] ch Pointer to a MPI_Channel of type PT2PT MPMC SYNC
+ * @return Returns 1 if a send request is pending (receiver process calls) or a sender process calls, 0 otherwise and -1
+ * if an error occured
+ * @note Returns -1 if internal problems with MPI related functions happend
+ */
+int channel_peek_pt2pt_mpmc_sync(MPI_Channel *ch);
+
 /**
  * @brief Deallocates the channel and all allocated members
  * @param[in, out] ch Pointer to a MPI_Channel of type PT2PT MPMC SYNC                 
@@ -0,0 +1,402 @@
+/**
+ * @file PT2PT_MPMC_SYNC_MATCH.c
+ * @author Toni Hollfelder (Toni.Hollfelder@uni-bayreuth.de)
+ * @brief Implementation of PT2PT MPMC SYNC channel with a matchmaker
+ * @version 1.0
+ * @date 2021-07-02
+ * @copyright CC BY 4.0 (https://creativecommons.org/licenses/by/4.0/)
+ *
+ * Tags used on the shadow comm:
+ * MATCH_CONTROL:   offer, demand or free of a process to the matchmaker
+ * MATCH_PAIR:      rank of the paired receiver from the matchmaker to a sender
+ * MATCH_DATA:      element from a sender to its paired receiver
+ */
+
+#include "PT2PT_MPMC_SYNC_MATCH.h"
+
+#define MATCH_CONTROL 0
+#define MATCH_PAIR 1
+#define MATCH_DATA 2
+
+#define OFFER 0
+#define DEMAND 1
+#define FREE 2
+
+// Used for mpi calls as origin buffer
+const int pt2pt_mpmc_sync_match_offer = OFFER;
+const int pt2pt_mpmc_sync_match_demand = DEMAND;
+const int pt2pt_mpmc_sync_match_free = FREE;
+
+// Size of the buffer the matchmaker needs to send one pair message to every sender with MPI_Bsend()
+#define MATCH_BUFFER_SIZE(ch) ((sizeof(int) + MPI_BSEND_OVERHEAD) * (ch)->sender_count)
+
+MPI_Channel *channel_alloc_pt2pt_mpmc_sync_match(MPI_Channel *ch)
+{
+    // Store type of channel
+    ch->chan_type = MPMC;
+
+    // The first receiver is the matchmaker of the channel
+    int matchmaker = ch->my_rank == ch->receiver_ranks[0];
+
+    // Initialize the state of the protocol
+    ch->waiting_senders = ch->waiting_receivers = NULL;
+    ch->waiting_senders_head = ch->waiting_senders_count = 0;
+    ch->waiting_receivers_head = ch->waiting_receivers_count = 0;
+    ch->demand_posted = 0;
+    ch->matched_sender = -1;
+    ch->match_frees = 0;
+    ch->req = MPI_REQUEST_NULL;
+
+    // Matchmaker needs to allocate the rings of waiting processes; every process waits at most once at a time
+    if (matchmaker)
+    {
+        ch->waiting_senders = malloc(ch->sender_count * sizeof(int));
+        ch->waiting_receivers = malloc(ch->receiver_count * sizeof(int));
+
+        if (!ch->waiting_senders || !ch->waiting_receivers)
+        {
+            ERROR("Error in malloc()\n");
+            free(ch->waiting_senders);
+            free(ch->waiting_receivers);
+            free(ch->receiver_ranks);
+            free(ch->sender_ranks);
+            channel_alloc_assert_success(ch->comm, 1);
+            free(ch);
+            return NULL;
+        }
+
+        // Matchmaker sends the pair messages buffered so it never waits for a sender
+        if (append_buffer(MATCH_BUFFER_SIZE(ch)) != 1)
+        {
+            ERROR("Error in append_buffer()\n");
+            free(ch->waiting_senders);
+            free(ch->waiting_receivers);
+            free(ch->receiver_ranks);
+            free(ch->sender_ranks);
+            channel_alloc_assert_success(ch->comm, 1);
+            free(ch);
+            return NULL;
+        }
+    }
+
+    // Create backup in case of failing MPI_Comm_dup
+    MPI_Comm comm = ch->comm;
+
+    // Create shadow comm and store it
+    // Should be nothrow
+    if (channel_comm_dup(ch, &ch->comm) != MPI_SUCCESS)
+    {
+        ERROR("Error in MPI_Comm_dup(): Fatal Error\n");
+        if (matchmaker)
+            shrink_buffer(MATCH_BUFFER_SIZE(ch));
+        free(ch->waiting_senders);
+        free(ch->waiting_receivers);
+        free(ch->receiver_ranks);
+        free(ch->sender_ranks);
+        channel_alloc_assert_success(comm, 1);
+        free(ch);
+        return NULL;
+    }
+
+    // Final call to assure that every process was successfull
+    // Use initial communicator since duplicated communicater has a new context
+    if (channel_alloc_assert_success(comm, 0) != 1)
+    {
+        ERROR("Error in finalizing channel allocation: At least one process failed\n");
+        if (matchmaker)
+            shrink_buffer(MATCH_BUFFER_SIZE(ch));
+        MPI_Comm_free(&ch->comm);
+        free(ch->waiting_senders);
+        free(ch->waiting_receivers);
+        free(ch->receiver_ranks);
+        free(ch->sender_ranks);
+        free(ch);
+        return NULL;
+    }
+
+    DEBUG("PT2PT MPMC SYNC MATCH finished allocation\n");
+
+    return ch;
+}
+
+// Pairs the oldest waiting sender with the oldest waiting receiver as long as both are waiting; matchmaker only
+static int pair_pt2pt_mpmc_sync_match(MPI_Channel *ch)
+{
+    while (ch->waiting_senders_count > 0 && ch->waiting_receivers_count > 0)
+    {
+        // Take the oldest sender and receiver out of their rings
+        int sender = ch->waiting_senders[ch->waiting_senders_head];
+        int receiver = ch->waiting_receivers[ch->waiting_receivers_head];
+        ch->waiting_senders_head = (ch->waiting_senders_head + 1) % ch->sender_count;
+        ch->waiting_receivers_head = (ch->waiting_receivers_head + 1) % ch->receiver_count;
+        ch->waiting_senders_count--;
+        ch->waiting_receivers_count--;
+
+        // The matchmaker receives the element of the sender itself
+        if (receiver == ch->my_rank)
+            ch->matched_sender = sender;
+
+        // Tell the sender to which receiver it sends its element
+        if (MPI_Bsend(&receiver, 1, MPI_INT, sender, MATCH_PAIR, ch->comm) != MPI_SUCCESS)
+        {
+            ERROR("Error in MPI_Bsend(): Pair message could not be sent; Channel might be broken\n");
+            return -1;
+        }
+    }
+
+    return 1;
+}
+
+// Stores the control messages which have arrived at the matchmaker and pairs the waiting processes; waits for the
+// first control message if block is set
+static int poll_pt2pt_mpmc_sync_match(MPI_Channel *ch, int block)
+{
+    // Used to store the kind of control message
+    int kind;
+
+    while (1)
+    {
+        // Wait for the first control message if the caller blocks, afterwards take the arrived ones only
+        if (block)
+        {
+            if (MPI_Mprobe(MPI_ANY_SOURCE, MATCH_CONTROL, ch->comm, &ch->message, &ch->status) != MPI_SUCCESS)
+            {
+                ERROR("Error in MPI_Mprobe(): Probing for control messages failed; Channel might be broken\n");
+                return -1;
+            }
+            ch->flag = 1;
+            block = 0;
+        }
+        else if (MPI_Improbe(MPI_ANY_SOURCE, MATCH_CONTROL, ch->comm, &ch->flag, &ch->message, &ch->status)
+        != MPI_SUCCESS)
+        {
+            ERROR("Error in MPI_Improbe(): Probing for control messages failed; Channel might be broken\n");
+            return -1;
+        }
+
+        // No further control message has arrived
+        if (!ch->flag)
+            break;
+
+        if (MPI_Mrecv(&kind, 1, MPI_INT, &ch->message, MPI_STATUS_IGNORE) != MPI_SUCCESS)
+        {
+            ERROR("Error in MPI_Mrecv(): Control message could not be received; Channel might be broken\n");
+            return -1;
+        }
+
+        // Append sender or receiver to its ring in arrival order or count the free of the process
+        if (kind == OFFER)
+        {
+            ch->waiting_senders[(ch->waiting_senders_head + ch->waiting_senders_count) % ch->sender_count] =
+            ch->status.MPI_SOURCE;
+            ch->waiting_senders_count++;
+        }
+        else if (kind == DEMAND)
+        {
+            ch->waiting_receivers[(ch->waiting_receivers_head + ch->waiting_receivers_count) % ch->receiver_count] =
+            ch->status.MPI_SOURCE;
+            ch->waiting_receivers_count++;
+        }
+        else
+        {
+            // A receiver which frees cannot take an element anymore, so drop its pending demand out of the ring
+            int kept = 0;
+            for (int i = 0; i < ch->waiting_receivers_count; i++)
+            {
+                int receiver = ch->waiting_receivers[(ch->waiting_receivers_head + i) % ch->receiver_count];
+                if (receiver != ch->status.MPI_SOURCE)
+                    ch->waiting_receivers[(ch->waiting_receivers_head + kept++) % ch->receiver_count] = receiver;
+            }
+            ch->waiting_receivers_count = kept;
+
+            ch->match_frees++;
+        }
+    }
+
+    return pair_pt2pt_mpmc_sync_match(ch);
+}
+
+int channel_send_pt2pt_mpmc_sync_match(MPI_Channel *ch, void *data)
+{
+    // Used to store the rank of the paired receiver
+    int receiver;
+
+    // Offer the element to the matchmaker
+    if (MPI_Isend(&pt2pt_mpmc_sync_match_offer, 1, MPI_INT, ch->receiver_ranks[0], MATCH_CONTROL, ch->comm, &ch->req)
+    != MPI_SUCCESS)
+    {
+        ERROR("Error in MPI_Isend(): Offer could not be sent; Channel might be broken\n");
+        return -1;
+    }
+
+    // Wait until the matchmaker has paired the sender with a receiver
+    if (MPI_Recv(&receiver, 1, MPI_INT, ch->receiver_ranks[0], MATCH_PAIR, ch->comm, MPI_STATUS_IGNORE) != MPI_SUCCESS)
+    {
+        ERROR("Error in MPI_Recv(): Pair message could not be received; Channel might be broken\n");
+        return -1;
+    }
+
+    // The offer has been received since the matchmaker answered it
+    if (MPI_Wait(&ch->req, MPI_STATUS_IGNORE) != MPI_SUCCESS)
+    {
+        ERROR("Error in MPI_Wait(): Completion of the offer could not be guaranteed; Channel might be broken\n");
+        return -1;
+    }
+
+    // Send data synchronously to the paired receiver
+    if (MPI_Ssend(data, ch->data_size, MPI_BYTE, receiver, MATCH_DATA, ch->comm) != MPI_SUCCESS)
+    {
+        ERROR("Error in MPI_Ssend(): Data could not be sent; Channel might be broken\n");
+        return -1;
+    }
+
+    return 1;
+}
+
+int channel_receive_pt2pt_mpmc_sync_match(MPI_Channel *ch, void *data)
+{
+    // Matchmaker appends itself to the ring of waiting receivers and pairs until it has been paired itself
+    if (ch->my_rank == ch->receiver_ranks[0])
+    {
+        if (!ch->demand_posted)
+        {
+            ch->waiting_receivers[(ch->waiting_receivers_head + ch->waiting_receivers_count) % ch->receiver_count] =
+            ch->my_rank;
+            ch->waiting_receivers_count++;
+            ch->demand_posted = 1;
+        }
+
+        // Pair with the senders which are already waiting, afterwards wait for new control messages
+        if (poll_pt2pt_mpmc_sync_match(ch, 0) == -1)
+        {
+            ERROR("Error in poll_pt2pt_mpmc_sync_match()\n");
+            return -1;
+        }
+
+        while (ch->matched_sender == -1)
+        {
+            if (poll_pt2pt_mpmc_sync_match(ch, 1) == -1)
+            {
+                ERROR("Error in poll_pt2pt_mpmc_sync_match()\n");
+                return -1;
+            }
+        }
+
+        // Receive the element of the paired sender
+        if (MPI_Recv(data, ch->data_size, MPI_BYTE, ch->matched_sender, MATCH_DATA, ch->comm, MPI_STATUS_IGNORE)
+        != MPI_SUCCESS)
+        {
+            ERROR("Error in MPI_Recv(): Data could not be received; Channel might be broken\n");
+            return -1;
+        }
+
+        ch->matched_sender = -1;
+        ch->demand_posted = 0;
+
+        return 1;
+    }
+
+    // Demand an element from the matchmaker
+    if (MPI_Isend(&pt2pt_mpmc_sync_match_demand, 1, MPI_INT, ch->receiver_ranks[0], MATCH_CONTROL, ch->comm, &ch->req)
+    != MPI_SUCCESS)
+    {
+        ERROR("Error in MPI_Isend(): Demand could not be sent; Channel might be broken\n");
+        return -1;
+    }
+
+    // Only the sender paired with this demand sends an element to the receiver
+    if (MPI_Recv(data, ch->data_size, MPI_BYTE, MPI_ANY_SOURCE, MATCH_DATA, ch->comm, MPI_STATUS_IGNORE) != MPI_SUCCESS)
+    {
+        ERROR("Error in MPI_Recv(): Data could not be received; Channel might be broken\n");
+        return -1;
+    }
+
+    // The demand has been received since the receiver has been paired
+    if (MPI_Wait(&ch->req, MPI_STATUS_IGNORE) != MPI_SUCCESS)
+    {
+        ERROR("Error in MPI_Wait(): Completion of the demand could not be guaranteed; Channel might be broken\n");
+        return -1;
+    }
+
+    return 1;
+}
+
+int channel_peek_pt2pt_mpmc_sync_match(MPI_Channel *ch)
+{
+    // Senders only show up at the matchmaker, so a sender cannot observe receivers
+    if (!ch->is_receiver)
+        return 1;
+
+    // Matchmaker pairs the waiting processes and returns the number of senders no receiver has been paired with
+    if (ch->my_rank == ch->receiver_ranks[0])
+    {
+        if (poll_pt2pt_mpmc_sync_match(ch, 0) == -1)
+        {
+            ERROR("Error in poll_pt2pt_mpmc_sync_match()\n");
+            return -1;
+        }
+
+        return ch->waiting_senders_count;
+    }
+
+    // Peeking must not demand an element since the demand commits a sender to this receiver; only check locally if
+    // the element of a paired sender has arrived
+    if (MPI_Iprobe(MPI_ANY_SOURCE, MATCH_DATA, ch->comm, &ch->flag, MPI_STATUS_IGNORE) != MPI_SUCCESS)
+    {
+        ERROR("Error in MPI_Iprobe()\n");
+        return -1;
+    }
+
+    return ch->flag;
+}
+
+int channel_free_pt2pt_mpmc_sync_match(MPI_Channel *ch)
+{
+    // Used to store the result of shrinking the buffer
+    int error = 1;
+
+    // Matchmaker keeps pairing until every other process has announced its free
+    if (ch->my_rank == ch->receiver_ranks[0])
+    {
+        while (ch->match_frees < ch->sender_count + ch->receiver_count - 1)
+        {
+            if (poll_pt2pt_mpmc_sync_match(ch, 1) == -1)
+            {
+                ERROR("Error in poll_pt2pt_mpmc_sync_match()\n");
+                return -1;
+            }
+        }
+
+        // Waits for the pair messages in transit
+        error = shrink_buffer(MATCH_BUFFER_SIZE(ch));
+    }
+    else
+    {
+        // Announce the free to the matchmaker
+        if (MPI_Send(&pt2pt_mpmc_sync_match_free, 1, MPI_INT, ch->receiver_ranks[0], MATCH_CONTROL, ch->comm)
+        != MPI_SUCCESS)
+        {
+            ERROR("Error in MPI_Send(): Free could not be announced; Channel might be broken\n");
+            return -1;
+        }
+
+    }
+
+    // Free allocated memory used for storing the waiting processes
+    free(ch->waiting_senders);
+    free(ch->waiting_receivers);
+
+    // Free allocated memory used for storing ranks
+    free(ch->receiver_ranks);
+    free(ch->sender_ranks);
+
+    // Mark shadow comm for deallocation
+    // Should be nothrow since shadow comm duplication was successful
+    MPI_Comm_free(&ch->comm);
+
+    // Deallocate channel
+    free(ch);
+    ch = NULL;
+
+    return error;
+}
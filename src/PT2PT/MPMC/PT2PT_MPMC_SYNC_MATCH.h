@@ -0,0 +1,80 @@
+/**
+ * @file PT2PT_MPMC_SYNC_MATCH.h
+ * @author Toni Hollfelder (Toni.Hollfelder@uni-bayreuth.de)
+ * @brief Header of PT2PT MPMC SYNC Channel with a matchmaker
+ * @version 1.0
+ * @date 2021-07-02
+ * @copyright CC BY 4.0 (https://creativecommons.org/licenses/by/4.0/)
+ *
+ * This PT2PT MPMC SYNC channel implementation is used if the channel is allocated with channel_alloc_info() and the
+ * key mpi_channel_sync set to "matchmaker". Instead of sending a send request to every receiver and a cancel message
+ * to every receiver which has not been chosen, the senders and receivers announce themselves to a single matchmaker,
+ * the first receiver in receiver_ranks. A sender sends an offer, a receiver sends a demand. The matchmaker stores the
+ * waiting senders and receivers in two rings in arrival order and pairs the oldest sender with the oldest receiver by
+ * sending the rank of the receiver to the sender. The sender then sends the element to this receiver with MPI_Ssend(),
+ * so the send completes only once the receiver receives it. Every pair costs at most three control messages (offer,
+ * demand and pair) independent of the number of receivers, and processes wait in blocking receives instead of
+ * spinning over all ranks. Serving both rings in arrival order keeps the implementation fair and starvation-free.
+ *
+ * Important usage note: The matchmaker only pairs processes while it is inside a call of the channel. The first
+ * receiver therefore has to keep calling channel_receive(), channel_peek() or channel_free() while other processes
+ * use the channel, e.g. with channel_set_progress(). A receiver other than the matchmaker only demands an element inside
+ * channel_receive(), since a demand commits the next sender to this receiver. Peeking is therefore free of side
+ * effects, but it cannot observe waiting senders on these receivers.
+ */
+
+#ifndef PT2PT_MPMC_SYNC_MATCH_H
+#define PT2PT_MPMC_SYNC_MATCH_H
+
+#include "../../MPI_Channel_Struct.h"
+
+/**
+ * @brief Updates the properties of a passed MPI_Channel of type PT2PT MPMC SYNC MATCH and returns it.
+ * @param[in, out] ch Pointer to a MPI_Channel allocated with channel_alloc_info().
+ * @return Returns a pointer to a MPI_Channel if allocation was successfull, NULL otherwise.
+ * @note Returns NULL if internal problems with buffer appending happend or malloc failed
+ */
+MPI_Channel *channel_alloc_pt2pt_mpmc_sync_match(MPI_Channel *ch);
+
+/**
+ * @brief Sends the numbers of bytes of a data element specified in channel_alloc_info() starting at the adress the
+ * void pointer holds into the channel. channel_send_pt2pt_mpmc_sync_match() blocks until the matchmaker has paired
+ * the sender with a receiver and the receiver receives the element.
+ * @param[in] ch Pointer to a MPI_Channel of type PT2PT MPMC SYNC MATCH
+ * @param[in] data Pointer to a memory adress of which size bytes will be sent from
+ * @return Returns 1 if sending was successful, -1 otherwise.
+ * @note Returns -1 if internal problems with MPI related functions happend.
+ */
+int channel_send_pt2pt_mpmc_sync_match(MPI_Channel *ch, void *data);
+
+/**
+ * @brief Receives the numbers of bytes of a data element specified in channel_alloc_info() from the channel and stores
+ * them starting at the adress the void pointer holds. channel_receive_pt2pt_mpmc_sync_match() blocks until the
+ * matchmaker has paired the receiver with a sender and the element has been received.
+ * @param[in] ch Pointer to a MPI_Channel of type PT2PT MPMC SYNC MATCH
+ * @param[in] data Pointer to a memory adress of which size bytes will be received to
+ * @return Returns 1 if receiving was successful, -1 otherwise.
+ * @note Returns -1 if internal problems with MPI related functions happend.
+ */
+int channel_receive_pt2pt_mpmc_sync_match(MPI_Channel *ch, void *data);
+
+/**
+ * @brief Peeks at the channel and signals if a message can be received. The matchmaker pairs the processes which
+ * have announced themselves, a receiver other than the matchmaker only probes locally and sends no demand.
+ * @param[in] ch Pointer to a MPI_Channel of type PT2PT MPMC SYNC MATCH
+ * @return Returns 1 for the sender process. Returns the number of waiting senders for the matchmaker and 1 if the
+ * element of the paired sender has arrived for the other receivers, 0 otherwise.
+ * @note Returns -1 if internal problems with MPI related functions happend.
+ */
+int channel_peek_pt2pt_mpmc_sync_match(MPI_Channel *ch);
+
+/**
+ * @brief Deallocates the channel and all allocated members. Every process announces its free to the matchmaker, which
+ * keeps pairing the remaining processes until every other process has done so.
+ * @param[in] ch Pointer to a MPI_Channel of type PT2PT MPMC SYNC MATCH
+ * @return Returns 1 if deallocation was successfull, -1 otherwise
+ * @note Returns -1 if internal problems with MPI related functions happend.
+ */
+int channel_free_pt2pt_mpmc_sync_match(MPI_Channel *ch);
+
+#endif // PT2PT_MPMC_SYNC_MATCH_H
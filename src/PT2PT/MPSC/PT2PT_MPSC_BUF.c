@@ -22,11 +22,11 @@ MPI_Channel *channel_alloc_pt2pt_mpsc_buf(MPI_Channel *ch)
     // Will be used for receiver to iterate over all sender to make implementation fair
     ch->idx_last_rank = 0;
 
-    // Adjust buffer depending on the rank
-    if (append_buffer(ch->is_receiver ? MPI_BSEND_OVERHEAD * ch->capacity * ch->sender_count : (int) (ch->data_size 
-    + MPI_BSEND_OVERHEAD) * ch->capacity) != 1)
+    // Allocate send slots for the elements (sender) or credit messages (receiver) in transit
+    if (send_slots_alloc(ch, ch->is_receiver ? ch->capacity * ch->sender_count : ch->capacity, 
+    ch->is_receiver ? sizeof(int) : ch->data_size) != 1)
     {
-        ERROR("Error in append_buffer()\n");
+        ERROR("Error in send_slots_alloc()\n");
         free(ch->receiver_ranks);
         free(ch->sender_ranks);
         channel_alloc_assert_success(ch->comm, 1);
@@ -39,11 +39,10 @@ MPI_Channel *channel_alloc_pt2pt_mpsc_buf(MPI_Channel *ch)
 
     // Create shadow comm and store it
     // Should be nothrow
-    if (MPI_Comm_dup(ch->comm, &ch->comm) != MPI_SUCCESS)
+    if (channel_comm_dup(ch, &ch->comm) != MPI_SUCCESS)
     {
         ERROR("Error in MPI_Comm_dup(): Fatal Error\n");
-        shrink_buffer(ch->is_receiver ? MPI_BSEND_OVERHEAD * ch->capacity * ch->sender_count : (int) (ch->data_size 
-        + MPI_BSEND_OVERHEAD) * ch->capacity);
+        send_slots_free(ch);
         free(ch->receiver_ranks);
         free(ch->sender_ranks);
         channel_alloc_assert_success(comm, 1);
@@ -51,13 +50,50 @@ MPI_Channel *channel_alloc_pt2pt_mpsc_buf(MPI_Channel *ch)
         return NULL;
     }
 
+    // Create the window of one-sided credits if the receivers return credits with MPI_Accumulate()
+    if (ch->rma_credits && credit_win_alloc(ch) != 1)
+    {
+        ERROR("Error in credit_win_alloc()\n");
+        send_slots_free(ch);
+        MPI_Comm_free(&ch->comm);
+        free(ch->receiver_ranks);
+        free(ch->sender_ranks);
+        channel_alloc_assert_success(comm, 1);
+        free(ch);
+        return NULL;
+    }
+
+    // Pre-post a receive for every element each sender can have in transit; without FIFO order and weights the 
+    // receiver takes the element which arrived first with MPI_ANY_SOURCE instead
+    if (ch->is_receiver && (ch->fifo || ch->weights != NULL) && recv_slots_alloc(ch, ch->capacity) != 1)
+    {
+        ERROR("Error in recv_slots_alloc()\n");
+        if (ch->rma_credits)
+            credit_win_free(ch);
+        send_slots_free(ch);
+        MPI_Comm_free(&ch->comm);
+        free(ch->receiver_ranks);
+        free(ch->sender_ranks);
+        channel_alloc_assert_success(comm, 1);
+        free(ch);
+        return NULL;
+    }
+
+    // A sender blocks once its quota is used up, so the receiver must not hold back credits up to the capacity
+    if (ch->is_receiver && (ch->fifo || ch->weights != NULL))
+        for (int i = 0; i < ch->sender_count; i++)
+            ch->credit_limits[i] = ch->min_quota;
+
     // Final call to assure that every process was successfull
     // Use initial communicator since duplicated communicater has a new context
     if (channel_alloc_assert_success(comm, 0) != 1)
     {
         ERROR("Error in finalizing channel allocation: At least one process failed\n");
-        shrink_buffer(ch->is_receiver ? MPI_BSEND_OVERHEAD * ch->capacity * ch->sender_count : (int) (ch->data_size + 
-        MPI_BSEND_OVERHEAD) * ch->capacity);
+        if (ch->rma_credits)
+            credit_win_free(ch);
+        if (ch->is_receiver && (ch->fifo || ch->weights != NULL))
+            recv_slots_free(ch);
+        send_slots_free(ch);
         free(ch->receiver_ranks);
         free(ch->sender_ranks);
         free(ch);
@@ -71,59 +107,56 @@ MPI_Channel *channel_alloc_pt2pt_mpsc_buf(MPI_Channel *ch)
 
 int channel_send_pt2pt_mpsc_buf(MPI_Channel *ch, void *data)
 {
-    // Check for incoming acknowledgement messages from receiver
-    if (MPI_Iprobe(MPI_ANY_SOURCE, 0, ch->comm, &ch->flag, MPI_STATUS_IGNORE) != MPI_SUCCESS)
+    // Try to send data without blocking
+    int sent = channel_trysend_pt2pt_mpsc_buf(ch, data);
+
+    // Data has been sent or an error occured
+    if (sent != 0)
+        return sent;
+
+    // Wait for a credit from the receiver
+    if ((ch->credit = credits_collect(ch, 0, 1)) == -1)
     {
-        ERROR("Error in MPI_Iprobe(): Starting MPI_Iprobe() for acknowledgment messages failed\n");
+        ERROR("Error in credits_collect()\n");
         return -1;
     }
 
-    // Receive acknowledgement messages from receiver
-    while (ch->flag)
+    // Decrement buffered items by the number of elements the credits return
+    ch->buffered_items -= ch->credit;
+
+    // Send data to receiver from a send slot
+    if (send_slots_isend(ch, data, ch->data_size, ch->receiver_ranks[0]) != 1)
     {
-        // Receive acknowledgement messages from receiver
-        if (MPI_Recv(NULL, 0, MPI_BYTE, MPI_ANY_SOURCE, 0, ch->comm, MPI_STATUS_IGNORE) != MPI_SUCCESS)
-        {
-            ERROR("Error in MPI_Recv(): Acknowledgment messages could not be received\n");
-            return -1;
-        }
+        ERROR("Error in send_slots_isend(): Data could not be sent\n");
+        return -1;
+    }
 
-        // Update buffered items
-        ch->buffered_items--;
+    // Update buffered items
+    ch->buffered_items++;
 
-        // Check for more incoming acknowledgement messages from receiver
-        if (MPI_Iprobe(MPI_ANY_SOURCE, 0, ch->comm, &ch->flag, MPI_STATUS_IGNORE) != MPI_SUCCESS)
-        {
-            ERROR("Error in MPI_Iprobe(): Starting MPI_Iprobe() for acknowledgment messages failed\n");
-            return -1;
-        }
-    }
+    return 1;
+}
 
-    // If there is not enough buffer space wait for acknowledgment message
-    if (ch->buffered_items >= ch->capacity)
+int channel_trysend_pt2pt_mpsc_buf(MPI_Channel *ch, void *data)
+{
+    // Collect the credits which have arrived from the receiver
+    if ((ch->credit = credits_collect(ch, 0, 0)) == -1)
     {
-        // Wait for incoming acknowledgement message from receiver
-        if (MPI_Probe(MPI_ANY_SOURCE, 0, ch->comm, MPI_STATUS_IGNORE) != MPI_SUCCESS)
-        {
-            ERROR("Error in MPI_Probe(): Probing for acknowledgment message failed\n");
-            return -1;
-        }    
+        ERROR("Error in credits_collect()\n");
+        return -1;
+    }
 
-        // Receive acknowledgement messages from receiver
-        if (MPI_Recv(NULL, 0, MPI_BYTE, MPI_ANY_SOURCE,0, ch->comm, MPI_STATUS_IGNORE) != MPI_SUCCESS)
-        {
-            ERROR("Error in MPI_Recv(): Acknowledgment messages could not be received\n");
-            return -1;
-        }
+    // Decrement buffered items by the number of elements the credits return
+    ch->buffered_items -= ch->credit;
 
-        // Decrement count of buffered items for every received acknowledgement message
-        ch->buffered_items--;
-    }   
+    // If there is not enough buffer space or the quota is used up data cannot be sent without blocking
+    if (ch->buffered_items >= ch->quota)
+        return 0;
 
-    // Send data to receiver with buffered send
-    if (MPI_Bsend(data, ch->data_size, MPI_BYTE, ch->receiver_ranks[0], 0, ch->comm) != MPI_SUCCESS)
+    // Send data to receiver from a send slot
+    if (send_slots_isend(ch, data, ch->data_size, ch->receiver_ranks[0]) != 1)
     {
-        ERROR("Error in MPI_Bsend(): Data could not be sent\n");
+        ERROR("Error in send_slots_isend(): Data could not be sent\n");
         return -1;
     }
 
@@ -135,47 +168,75 @@ int channel_send_pt2pt_mpsc_buf(MPI_Channel *ch, void *data)
 
 int channel_receive_pt2pt_mpsc_buf(MPI_Channel *ch, void *data)
 {
-    // Loop until one message can be received
-    while (1) 
+    // Without FIFO order the element which arrived first is received from any sender
+    if (!ch->fifo && ch->weights == NULL)
     {
-        // If current sender index is equal to count of sender reset to 0
-        if (ch->idx_last_rank >= ch->sender_count) 
+        if (MPI_Recv(data, ch->data_size, MPI_BYTE, MPI_ANY_SOURCE, 0, ch->comm, &ch->status) != MPI_SUCCESS)
         {
-            ch->idx_last_rank = 0;
+            ERROR("Error in MPI_Recv()\n");
+            return -1;
         }
-        
-        // Check for an incoming message
-        if (MPI_Iprobe(ch->sender_ranks[ch->idx_last_rank], 0, ch->comm, &ch->flag, MPI_STATUS_IGNORE) != MPI_SUCCESS)
+
+        // Return a credit of one element to source rank of data message; without receive slots the receiver cannot
+        // tell whether the sender has more elements in transit
+        if (credits_send(ch, ch->status.MPI_SOURCE, 1) != 1)
         {
-            ERROR("Error in MPI_Iprobe()\n");
+            ERROR("Error in credits_send()\n");
             return -1;
         }
 
-        // If a message can be received
-        if (ch->flag)
+        return 1;
+    }
+
+    // Find the senders whose oldest element has arrived; blocks until there is one
+    if (recv_slots_wait(ch) == -1)
+    {
+        ERROR("Error in recv_slots_wait()\n");
+        return -1;
+    }
+
+    // Serve the senders starting from the last sender to keep fairness
+    while (1)
+    {
+        // If current sender index is equal to count of sender reset to 0
+        if (ch->idx_last_rank >= ch->sender_count) 
+        {
+            ch->idx_last_rank = 0;
+        }
+
+        // Weighted channels grant the weight of the sender as deficit once its turn starts
+        if (ch->weights != NULL && ch->deficits[ch->idx_last_rank] == 0)
+            ch->deficits[ch->idx_last_rank] = ch->weights[ch->idx_last_rank];
+
+        // If the oldest element of the sender has arrived
+        if (ch->recv_arrived[ch->idx_last_rank])
         {
-            // Call blocking receive
-            if (MPI_Recv(data, ch->data_size, MPI_BYTE, ch->sender_ranks[ch->idx_last_rank], 0, ch->comm, 
-            MPI_STATUS_IGNORE) != MPI_SUCCESS)
+            // Copy the element out of its slot and post the receive again
+            if (recv_slots_receive(ch, data, ch->idx_last_rank) != 1)
             {
-                ERROR("Error in MPI_Recv()\n");
+                ERROR("Error in recv_slots_receive()\n");
                 return -1;
             }
 
-            // Send acknowledgement message to source rank of data message
-            if (MPI_Bsend(NULL, 0, MPI_BYTE, ch->sender_ranks[ch->idx_last_rank], 0, ch->comm) != MPI_SUCCESS)
+            // Return the credit for the element to its sender; accumulated until half of its slots have been consumed
+            if (credits_return(ch, ch->idx_last_rank) != 1)
             {
-                ERROR("Error in MPI_Bsend(): Acknowledgement message could not be sent. Capacity of channel buffer"
-                " could be invalid\n");
+                ERROR("Error in credits_return(): Credit message could not be sent\n");
                 return -1;
             }
 
-            // Increment current sender index and restore it in last_rank for next channel_receive call
-            ch->idx_last_rank++;
+            // Increment current sender index and restore it in last_rank for next channel_receive call; senders of 
+            // weighted channels keep their turn until their deficit is used up
+            if (ch->weights == NULL || --ch->deficits[ch->idx_last_rank] == 0)
+                ch->idx_last_rank++;
 
             return 1;
         }
 
+        // A sender without pending elements loses the rest of its deficit
+        if (ch->weights != NULL)
+            ch->deficits[ch->idx_last_rank] = 0;
+
         // Incremet current sender index
         ch->idx_last_rank++;
     }
@@ -186,39 +247,26 @@ int channel_peek_pt2pt_mpsc_buf(MPI_Channel *ch)
     // Check if sender is calling
     if (!ch->is_receiver)
     {
-        // Check for incoming acknowledgement messages from receiver
-        if (MPI_Iprobe(MPI_ANY_SOURCE, 0, ch->comm, &ch->flag, MPI_STATUS_IGNORE) != MPI_SUCCESS)
+        // Collect the credits which have arrived from the receiver
+        if ((ch->credit = credits_collect(ch, 0, 0)) == -1)
         {
-            ERROR("Error in MPI_Iprobe()\n");
+            ERROR("Error in credits_collect()\n");
             return -1;
         }
 
-        while (ch->flag)
-        {
-            // Receive acknowledgement messages from receiver
-            if (MPI_Recv(NULL, 0, MPI_BYTE, MPI_ANY_SOURCE, 0, ch->comm, MPI_STATUS_IGNORE) != MPI_SUCCESS)
-            {
-                ERROR("Error in MPI_Recv(): Ack messages could not be received\n");
-                return -1;
-            }
-
-            // Decrement count of buffered items for every received acknowledgement message
-            ch->buffered_items--;
-
-            // Check for more incoming acknowledgement messages from receiver
-            if (MPI_Iprobe(MPI_ANY_SOURCE, 0, ch->comm, &ch->flag, MPI_STATUS_IGNORE) != MPI_SUCCESS)
-            {
-                ERROR("Error in MPI_Iprobe()\n");
-                return -1;
-            }
-        }
+        // Decrement buffered items by the number of elements the credits return
+        ch->buffered_items -= ch->credit;
 
         // Return number of items which can be sent
-        return ch->capacity - ch->buffered_items;
+        return ch->quota - ch->buffered_items;
     }
     // Else the receiver is calling
     else
     {
+        // Return number of senders whose oldest element has arrived in the pre-posted receives
+        if (ch->fifo || ch->weights != NULL)
+            return recv_slots_test(ch);
+
         // Checks if items can be received
         if (MPI_Iprobe(MPI_ANY_SOURCE, 0, ch->comm, &ch->flag, MPI_STATUS_IGNORE) != MPI_SUCCESS)
         {
@@ -230,6 +278,19 @@ int channel_peek_pt2pt_mpsc_buf(MPI_Channel *ch)
     }
 }
 
+int channel_drain_pt2pt_mpsc_buf(MPI_Channel *ch)
+{
+    // Receiver process has nothing to drain
+    if (ch->is_receiver)
+        return 1;
+
+    // Peeking consumes the acknowledgement messages which have arrived
+    if (channel_peek_pt2pt_mpsc_buf(ch) == -1)
+        return -1;
+
+    return ch->buffered_items == 0;
+}
+
 int channel_free_pt2pt_mpsc_buf(MPI_Channel *ch) 
 {
     // Check if all messages have been sent and received
@@ -237,34 +298,38 @@ int channel_free_pt2pt_mpsc_buf(MPI_Channel *ch)
     if (!ch->is_receiver)
         while (ch->buffered_items > 0)
         {
-            // Check for more incoming acknowledgement messages from receiver
-            if (MPI_Probe(MPI_ANY_SOURCE, 0, ch->comm, MPI_STATUS_IGNORE) != MPI_SUCCESS)
+            // Wait for a credit from the receiver
+            if ((ch->credit = credits_collect(ch, 0, 1)) == -1)
             {
-                ERROR("Error in MPI_Probe(): Probing for acknowledgment messages failed\n");
+                ERROR("Error in credits_collect()\n");
                 return -1;
-            }   
-
-            // Receive acknowledgement messages from receiver
-            if (MPI_Recv(NULL, 0, MPI_BYTE, MPI_ANY_SOURCE, 0, ch->comm, MPI_STATUS_IGNORE) != MPI_SUCCESS)
-            {
-                ERROR("Error in MPI_Recv(): Acknowledgements could not be received\n")
-                return -1;
-            } 
+            }
 
-            // Decrement buffered items
-            ch->buffered_items--;        
+            // Decrement buffered items by the number of elements the credits return
+            ch->buffered_items -= ch->credit;
         }
 
-    // Free allocated memory used for storing ranks
+    // Cancel the pre-posted receives of the receiver
+    if (ch->is_receiver && (ch->fifo || ch->weights != NULL))
+        recv_slots_free(ch);
+
+    // Free allocated memory used for storing ranks and weights
     free(ch->receiver_ranks);
     free(ch->sender_ranks);
+    free(ch->weights);
+    free(ch->deficits);
+
+    // Wait for the messages in transit and release the send slots
+    int error = send_slots_free(ch);
+
+    // Release the window of one-sided credits
+    if (ch->rma_credits)
+        credit_win_free(ch);
 
     // Mark shadow comm for deallocation
     // Should be nothrow since shadow comm duplication was successful
     MPI_Comm_free(&ch->comm);
 
-    // Adjust buffer depending on the rank
-    int error = shrink_buffer(ch->is_receiver ? MPI_BSEND_OVERHEAD * ch->capacity * ch->sender_count : (int) (ch->data_size + MPI_BSEND_OVERHEAD) * ch->capacity);
 
     // Deallocate channel
     free(ch);
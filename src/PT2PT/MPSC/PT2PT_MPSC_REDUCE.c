@@ -0,0 +1,195 @@
+/**
+ * @file PT2PT_MPSC_REDUCE.c
+ * @author Toni Hollfelder (Toni.Hollfelder@uni-bayreuth.de)
+ * @brief Implementation of PT2PT MPSC REDUCE Channel
+ * @version 1.0
+ * @date 2021-05-26
+ * @copyright CC BY 4.0 (https://creativecommons.org/licenses/by/4.0/)
+ *
+ */
+
+#include "PT2PT_MPSC_REDUCE.h"
+
+MPI_Channel *channel_alloc_pt2pt_mpsc_reduce(MPI_Channel *ch)
+{
+    // Store type of channel
+    ch->chan_type = MPSC;
+
+    // Sender needs a ring of capacity send buffers and requests, receiver a buffer for a single contribution
+    ch->local_buff = malloc(ch->is_receiver ? ch->data_size : ch->capacity * ch->data_size);
+    ch->requests = ch->is_receiver ? NULL : malloc(ch->capacity * sizeof(*ch->requests));
+
+    if (!ch->local_buff || (!ch->is_receiver && !ch->requests))
+    {
+        ERROR("Error in malloc(): Memory for contributions could not be allocated\n");
+        free(ch->local_buff);
+        free(ch->requests);
+        free(ch->receiver_ranks);
+        free(ch->sender_ranks);
+        channel_alloc_assert_success(ch->comm, 1);
+        free(ch);
+        return NULL;
+    }
+
+    // Initialize with MPI_REQUEST_NULL, memset doesnt work
+    for (int i = 0; !ch->is_receiver && i < ch->capacity; i++)
+    {
+        ch->requests[i] = MPI_REQUEST_NULL;
+    }
+
+    // Create backup in case of failing MPI_Comm_dup
+    MPI_Comm comm = ch->comm;
+
+    // Create shadow comm and store it
+    // Should be nothrow
+    if (channel_comm_dup(ch, &ch->comm) != MPI_SUCCESS)
+    {
+        ERROR("Error in MPI_Comm_dup(): Fatal Error\n");
+        free(ch->local_buff);
+        free(ch->requests);
+        free(ch->receiver_ranks);
+        free(ch->sender_ranks);
+        channel_alloc_assert_success(comm, 1);
+        free(ch);
+        return NULL;
+    }
+
+    // Final call to assure that every process was successfull
+    // Use initial communicator since duplicated communicater has a new context
+    if (channel_alloc_assert_success(comm, 0) != 1)
+    {
+        ERROR("Error in finalizing channel allocation: At least one process failed\n");
+        free(ch->local_buff);
+        free(ch->requests);
+        free(ch->receiver_ranks);
+        free(ch->sender_ranks);
+        MPI_Comm_free(&ch->comm);
+        free(ch);
+        return NULL;
+    }
+
+    DEBUG("PT2PT MPSC REDUCE finished allocation\n");
+
+    return ch;
+}
+
+int channel_send_pt2pt_mpsc_reduce(MPI_Channel *ch, void *data)
+{
+    // Send buffer of the current epoch
+    int slot = ch->epoch % ch->capacity;
+    char *buff = (char *) ch->local_buff + slot * ch->data_size;
+
+    // Wait until the receiver has received the contribution capacity epochs ago
+    if (MPI_Wait(&ch->requests[slot], MPI_STATUS_IGNORE) != MPI_SUCCESS)
+    {
+        ERROR("Error in MPI_Wait(): Contribution of a previous epoch could not be completed\n");
+        return -1;
+    }
+
+    // Copy contribution so the caller might reuse data immediately
+    memcpy(buff, data, ch->data_size);
+
+    // Synchronous mode completes only once the receiver has started to receive the contribution
+    if (MPI_Issend(buff, ch->reduce_count, ch->reduce_type, ch->receiver_ranks[0], 0, ch->comm, &ch->requests[slot]) 
+    != MPI_SUCCESS)
+    {
+        ERROR("Error in MPI_Issend(): Contribution could not be sent\n");
+        return -1;
+    }
+
+    // Next contribution belongs to the next epoch
+    ch->epoch++;
+
+    return 1;
+}
+
+int channel_receive_pt2pt_mpsc_reduce(MPI_Channel *ch, void *data)
+{
+    // Receive contributions from the last to the first sender; the first received contribution is stored in data
+    // directly and every further contribution s_i is combined as s_i op data
+    for (int i = ch->sender_count - 1; i >= 0; i--)
+    {
+        void *buff = i == ch->sender_count - 1 ? data : ch->local_buff;
+
+        if (MPI_Recv(buff, ch->reduce_count, ch->reduce_type, ch->sender_ranks[i], 0, ch->comm, MPI_STATUS_IGNORE) != 
+        MPI_SUCCESS)
+        {
+            ERROR("Error in MPI_Recv(): Contribution could not be received\n");
+            return -1;
+        }
+
+        if (buff != data && MPI_Reduce_local(buff, data, ch->reduce_count, ch->reduce_type, ch->reduce_op) != 
+        MPI_SUCCESS)
+        {
+            ERROR("Error in MPI_Reduce_local(): Contribution could not be combined\n");
+            return -1;
+        }
+    }
+
+    ch->epoch++;
+
+    return 1;
+}
+
+int channel_peek_pt2pt_mpsc_reduce(MPI_Channel *ch)
+{
+    int count = 0;
+
+    if (ch->is_receiver)
+    {
+        // The epoch can be received once every sender has a pending contribution
+        for (int i = 0; i < ch->sender_count; i++)
+        {
+            if (MPI_Iprobe(ch->sender_ranks[i], 0, ch->comm, &ch->flag, MPI_STATUS_IGNORE) != MPI_SUCCESS)
+            {
+                ERROR("Error in MPI_Iprobe()\n");
+                return -1;
+            }
+
+            if (!ch->flag)
+                return 0;
+        }
+
+        return 1;
+    }
+
+    // Count send buffers whose contribution has been received
+    for (int i = 0; i < ch->capacity; i++)
+    {
+        if (MPI_Test(&ch->requests[i], &ch->flag, MPI_STATUS_IGNORE) != MPI_SUCCESS)
+        {
+            ERROR("Error in MPI_Test(): Request could not be tested\n");
+            return -1;
+        }
+
+        count += ch->flag;
+    }
+
+    return count;
+}
+
+int channel_free_pt2pt_mpsc_reduce(MPI_Channel *ch)
+{
+    // Sender needs to wait until its contributions have been received before its send buffers are released
+    if (!ch->is_receiver && MPI_Waitall(ch->capacity, ch->requests, MPI_STATUSES_IGNORE) != MPI_SUCCESS)
+    {
+        ERROR("Error in MPI_Waitall(): Contributions could not be completed\n");
+        return -1;
+    }
+
+    // Free allocated memory used for storing ranks, requests and contributions
+    free(ch->receiver_ranks);
+    free(ch->sender_ranks);
+    free(ch->requests);
+    free(ch->local_buff);
+
+    // Mark shadow comm for deallocation
+    // Should be nothrow since shadow comm duplication was successful
+    MPI_Comm_free(&ch->comm);
+
+    // Free the allocated memory ch points to
+    free(ch);
+    ch = NULL;
+
+    return 1;
+}
@@ -0,0 +1,68 @@
+/**
+ * @file PT2PT_MPSC_REDUCE.h
+ * @author Toni Hollfelder (Toni.Hollfelder@uni-bayreuth.de)
+ * @brief Header of PT2PT MPSC REDUCE Channel
+ * @version 1.0
+ * @date 2021-05-26
+ * @copyright CC BY 4.0 (https://creativecommons.org/licenses/by/4.0/)
+ *
+ * This PT2PT MPSC REDUCE channel implementation combines one element of every sender per epoch into a single element
+ * at the receiver. Every sender sends its contribution with MPI_Issend() from a ring of capacity send buffers and waits
+ * for the oldest send only if every buffer is in use. This way a sender is at most capacity epochs ahead of the
+ * receiver. The receiver receives the contribution of every sender in reverse sender order and combines them with
+ * MPI_Reduce_local(), which yields s_0 op s_1 op ... op s_n for the senders s_i and thus also supports non-commutative
+ * user-defined operations.
+ */
+
+#ifndef PT2PT_MPSC_REDUCE_H
+#define PT2PT_MPSC_REDUCE_H
+
+#include "../../MPI_Channel_Struct.h"
+
+/**
+ * @brief Updates the properties of a passed MPI_Channel of type PT2PT MPSC REDUCE and returns it.
+ * @param[in, out] ch Pointer to a MPI_Channel allocated with channel_alloc_reduce().
+ * @return Returns a pointer to a valid MPI_Channel with updated properties if updating was successful and NULL otherwise
+ * @note Returns NULL if MPI related functions or allocation memory failure happend.
+ */
+MPI_Channel *channel_alloc_pt2pt_mpsc_reduce(MPI_Channel *ch);
+
+/**
+ * @brief Contributes the element the void pointer points to to the current epoch of the sender. Calling
+ * channel_send_pt2pt_mpsc_reduce() blocks only if the receiver has not yet received the last capacity contributions
+ * of the sender.
+ * @param[in] ch Pointer to a MPI_Channel of type PT2PT MPSC REDUCE
+ * @param[in] data Pointer to count elements of the datatype passed to channel_alloc_reduce()
+ * @return Returns 1 if sending was successful, -1 otherwise
+ * @note Returns -1 if internal problems with MPI related functions happend
+ */
+int channel_send_pt2pt_mpsc_reduce(MPI_Channel *ch, void *data);
+
+/**
+ * @brief Receives the contribution of every sender to the current epoch and stores the combined element starting at
+ * the adress the void pointer holds. Calling channel_receive_pt2pt_mpsc_reduce() blocks until every sender has
+ * contributed to the epoch.
+ * @param[in] ch Pointer to a MPI_Channel of type PT2PT MPSC REDUCE
+ * @param[out] data Pointer to memory for count elements of the datatype passed to channel_alloc_reduce()
+ * @return Returns 1 if receiving was successful, -1 otherwise
+ * @note Returns -1 if internal problems with MPI related functions happend
+ */
+int channel_receive_pt2pt_mpsc_reduce(MPI_Channel *ch, void *data);
+
+/**
+ * @brief Peeks at the channel and signals if the sender can contribute or the receiver can receive without blocking.
+ * @param[in] ch Pointer to a MPI_Channel of type PT2PT MPSC REDUCE
+ * @return Returns the number of free send buffers if the sender process calls and 1 if every sender has contributed
+ * to the current epoch or 0 otherwise if the receiver process calls. Returns -1 if an error occured
+ */
+int channel_peek_pt2pt_mpsc_reduce(MPI_Channel *ch);
+
+/**
+ * @brief Deallocates the channel and all allocated members. The sender waits until its contributions have been
+ * received.
+ * @param[in] ch Pointer to a MPI_Channel of type PT2PT MPSC REDUCE
+ * @return Returns 1 if deallocation was successful, -1 otherwise
+ */
+int channel_free_pt2pt_mpsc_reduce(MPI_Channel *ch);
+
+#endif // PT2PT_MPSC_REDUCE_H
@@ -23,7 +23,7 @@ MPI_Channel *channel_alloc_pt2pt_mpsc_sync(MPI_Channel *ch)
 
     // Create shadow comm and store it
     // Should be nothrow
-    if (MPI_Comm_dup(ch->comm, &ch->comm) != MPI_SUCCESS)
+    if (channel_comm_dup(ch, &ch->comm) != MPI_SUCCESS)
     {
         ERROR("Error in MPI_Comm_dup(): Fatal Error\n");
         free(ch->receiver_ranks);
@@ -63,43 +63,85 @@ int channel_send_pt2pt_mpsc_sync(MPI_Channel *ch, void *data)
 
 int channel_receive_pt2pt_mpsc_sync(MPI_Channel *ch, void *data)
 {
+    // Number of senders probed without finding an element
+    int misses = 0;
+
     // Loop over all sender until a element can be received; guarantees fairness
     while (1)
     {
+        // No sender has an element; block until any sender shows up instead of spinning over the senders
+        if (misses == ch->sender_count)
+        {
+            if (MPI_Probe(MPI_ANY_SOURCE, 0, ch->comm, MPI_STATUS_IGNORE) != MPI_SUCCESS)
+            {
+                ERROR("Error in MPI_Probe(): Probing for incoming data failed\n");
+                return -1;
+            }
+
+            misses = 0;
+        }
+
         // If current sender index is equal to sender count reset to 0
         if (ch->idx_last_rank >= ch->sender_count) {
             ch->idx_last_rank = 0;
         }
+
+        // Weighted channels grant the weight of the sender as deficit once its turn starts
+        if (ch->weights != NULL && ch->deficits[ch->idx_last_rank] == 0)
+            ch->deficits[ch->idx_last_rank] = ch->weights[ch->idx_last_rank];
         
-        // Check for an incoming message
-        if (MPI_Iprobe(ch->sender_ranks[ch->idx_last_rank], 0, ch->comm, &ch->flag, MPI_STATUS_IGNORE) != MPI_SUCCESS)
+        // Check for an incoming message and match it
+        if (MPI_Improbe(ch->sender_ranks[ch->idx_last_rank], 0, ch->comm, &ch->flag, &ch->message, MPI_STATUS_IGNORE) 
+        != MPI_SUCCESS)
         {
-            ERROR("Error in MPI_Iprobe(): Iprobing for incoming data failed\n");
+            ERROR("Error in MPI_Improbe(): Iprobing for incoming data failed\n");
             return -1;
         }
 
         // If a message can be received
         if (ch->flag)
         {
-            // Call blocking receive
-            if (MPI_Recv(data, ch->data_size, MPI_BYTE, ch->sender_ranks[ch->idx_last_rank], 0, ch->comm, 
-            MPI_STATUS_IGNORE) != MPI_SUCCESS)
+            // Receive the matched message
+            if (MPI_Mrecv(data, ch->data_size, MPI_BYTE, &ch->message, MPI_STATUS_IGNORE) != MPI_SUCCESS)
             {
-                ERROR("Error in MPI_Recv(): Data could not be received\n");
+                ERROR("Error in MPI_Mrecv(): Data could not be received\n");
                 return -1;
             }
 
-            // Increment current sender index and restore it in idx_last_rank for next call
-            ch->idx_last_rank++;
+            // Increment current sender index and restore it in idx_last_rank for next call; senders of weighted 
+            // channels keep their turn until their deficit is used up
+            if (ch->weights == NULL || --ch->deficits[ch->idx_last_rank] == 0)
+                ch->idx_last_rank++;
 
             return 1;
         }
 
+        // A sender without pending elements loses the rest of its deficit
+        if (ch->weights != NULL)
+            ch->deficits[ch->idx_last_rank] = 0;
+
         // Incremet current sender index
         ch->idx_last_rank++;
+        misses++;
     }
 }
 
+int channel_peek_pt2pt_mpsc_sync(MPI_Channel *ch)
+{
+    // The receiver only shows up when calling channel_receive(), so a sender cannot observe it
+    if (!ch->is_receiver)
+        return 1;
+
+    // Check for a pending synchronous send of any sender
+    if (MPI_Iprobe(MPI_ANY_SOURCE, 0, ch->comm, &ch->flag, MPI_STATUS_IGNORE) != MPI_SUCCESS)
+    {
+        ERROR("Error in MPI_Iprobe()\n");
+        return -1;
+    }
+
+    return ch->flag ? 1 : 0;
+}
+
 int channel_free_pt2pt_mpsc_sync(MPI_Channel *ch)
 {
     // Mark shadow comm for deallocation
@@ -108,6 +150,8 @@ int channel_free_pt2pt_mpsc_sync(MPI_Channel *ch)
 
     free(ch->receiver_ranks);
     free(ch->sender_ranks);
+    free(ch->weights);
+    free(ch->deficits);
 
     // Free channel
     free(ch);
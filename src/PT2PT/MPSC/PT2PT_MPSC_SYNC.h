@@ -8,7 +8,10 @@
  *  
  * This PT2PT MPSC SYNC channel implementation uses the synchronous send mode of MPI. For sending MPI_Ssend() and 
  * for receiving MPI_Recv() is used. To guarantee a fair and starvation-free implementation the receiver process 
- * iterates over all senders starting from the last sender rank it received from and checks for an incoming message.
+ * iterates over all senders starting from the last sender rank it received from and checks for an incoming message. 
+ * If no sender has an element after a full round the receiver blocks in MPI_Probe() until any sender shows up. 
+ * Pre-posted receives are not used since they would complete the MPI_Ssend() of a sender before channel_receive() is
+ * called.
  */
 
 #ifndef PT2PT_MPSC_SYNC_H
@@ -45,6 +48,16 @@ int channel_send_pt2pt_mpsc_sync(MPI_Channel *ch, void *data);
  */
 int channel_receive_pt2pt_mpsc_sync(MPI_Channel *ch, void *data);
 
+/**
+ * @brief Peeks at the channel and signals if a matching sender is waiting. The receiver process probes for a pending
+ * MPI_Ssend() of any sender. Since the receiver does not announce itself a sender process always gets 1.
+ * @param[in] ch Pointer to a MPI_Channel of type PT2PT MPSC SYNC
+ * @return Returns 1 if an element can be received without blocking (receiver process calls) or a sender process calls,
+ * 0 otherwise and -1 if an error occured
+ * @note Returns -1 if internal problems with MPI related functions happend
+ */
+int channel_peek_pt2pt_mpsc_sync(MPI_Channel *ch);
+
 /**
  * @brief Deallocates the channel and all allocated members
  * @param[in, out] ch Pointer to a MPI_Channel of type PT2PT MPSC SYNC                 
@@ -17,11 +17,10 @@ MPI_Channel *channel_alloc_pt2pt_spsc_buf(MPI_Channel *ch)
     // Initialize buffered_items with 0
     ch->buffered_items = 0;
 
-    // Adjust buffer depending on the rank
-    if (append_buffer(ch->is_receiver ? MPI_BSEND_OVERHEAD * ch->capacity : (int) (ch->data_size + MPI_BSEND_OVERHEAD) 
-    * ch->capacity) != 1)
+    // Allocate send slots for the elements (sender) or credit messages (receiver) in transit
+    if (send_slots_alloc(ch, ch->capacity, ch->is_receiver ? sizeof(int) : ch->data_size) != 1)
     {
-        ERROR("Error in append_buffer()\n");
+        ERROR("Error in send_slots_alloc()\n");
         free(ch->receiver_ranks);
         free(ch->sender_ranks);
         channel_alloc_assert_success(ch->comm, 1);
@@ -34,11 +33,52 @@ MPI_Channel *channel_alloc_pt2pt_spsc_buf(MPI_Channel *ch)
 
     // Create shadow comm and store it
     // Should be nothrow
-    if (MPI_Comm_dup(ch->comm, &ch->comm) != MPI_SUCCESS)
+    if (channel_comm_dup(ch, &ch->comm) != MPI_SUCCESS)
     {
         ERROR("Error in MPI_Comm_dup(): Fatal Error\n");
-        shrink_buffer(ch->is_receiver ? MPI_BSEND_OVERHEAD * ch->capacity : (int) (ch->data_size + MPI_BSEND_OVERHEAD) 
-        * ch->capacity);
+        send_slots_free(ch);
+        free(ch->receiver_ranks);
+        free(ch->sender_ranks);
+        channel_alloc_assert_success(comm, 1);
+        free(ch);
+        return NULL;
+    }
+
+    // Every message goes to the same peer; bind the send slots to persistent requests
+    if (send_slots_persist(ch, ch->is_receiver ? sizeof(int) : ch->data_size, ch->is_receiver ? ch->sender_ranks[0] : 
+    ch->receiver_ranks[0]) != 1)
+    {
+        ERROR("Error in send_slots_persist()\n");
+        send_slots_free(ch);
+        MPI_Comm_free(&ch->comm);
+        free(ch->receiver_ranks);
+        free(ch->sender_ranks);
+        channel_alloc_assert_success(comm, 1);
+        free(ch);
+        return NULL;
+    }
+
+    // Create the window of one-sided credits if the receivers return credits with MPI_Accumulate()
+    if (ch->rma_credits && credit_win_alloc(ch) != 1)
+    {
+        ERROR("Error in credit_win_alloc()\n");
+        send_slots_free(ch);
+        MPI_Comm_free(&ch->comm);
+        free(ch->receiver_ranks);
+        free(ch->sender_ranks);
+        channel_alloc_assert_success(comm, 1);
+        free(ch);
+        return NULL;
+    }
+
+    // Pre-post a receive for every element the sender can have in transit
+    if (ch->is_receiver && recv_slots_alloc(ch, ch->capacity) != 1)
+    {
+        ERROR("Error in recv_slots_alloc()\n");
+        if (ch->rma_credits)
+            credit_win_free(ch);
+        send_slots_free(ch);
+        MPI_Comm_free(&ch->comm);
         free(ch->receiver_ranks);
         free(ch->sender_ranks);
         channel_alloc_assert_success(comm, 1);
@@ -51,8 +91,11 @@ MPI_Channel *channel_alloc_pt2pt_spsc_buf(MPI_Channel *ch)
     if (channel_alloc_assert_success(comm, 0) != 1)
     {
         ERROR("Error in finalizing channel allocation: At least one process failed\n");
-        shrink_buffer(ch->is_receiver ? MPI_BSEND_OVERHEAD * ch->capacity : (int) (ch->data_size + MPI_BSEND_OVERHEAD) 
-        * ch->capacity);
+        if (ch->rma_credits)
+            credit_win_free(ch);
+        if (ch->is_receiver)
+            recv_slots_free(ch);
+        send_slots_free(ch);
         free(ch->receiver_ranks);
         free(ch->sender_ranks);
         free(ch);
@@ -66,59 +109,56 @@ MPI_Channel *channel_alloc_pt2pt_spsc_buf(MPI_Channel *ch)
 
 int channel_send_pt2pt_spsc_buf(MPI_Channel *ch, void *data)
 {
-    // Check for incoming acknowledgement messages from receiver
-    if (MPI_Iprobe(ch->receiver_ranks[0], 0, ch->comm, &ch->flag, MPI_STATUS_IGNORE) != MPI_SUCCESS)
+    // Try to send data without blocking
+    int sent = channel_trysend_pt2pt_spsc_buf(ch, data);
+
+    // Data has been sent or an error occured
+    if (sent != 0)
+        return sent;
+
+    // Wait for a credit from the receiver
+    if ((ch->credit = credits_collect(ch, 0, 1)) == -1)
     {
-        ERROR("Error in MPI_Iprobe(): Starting MPI_Iprobe() for acknowledgment messages failed\n");
+        ERROR("Error in credits_collect()\n");
         return -1;
     }
 
-    // Receive acknowledgement messages from receiver
-    while (ch->flag)
+    // Decrement buffered items by the number of elements the credits return
+    ch->buffered_items -= ch->credit;
+
+    // Send data to receiver from a send slot
+    if (send_slots_isend(ch, data, ch->data_size, ch->receiver_ranks[0]) != 1)
     {
-        // Receive acknowledgement messages from receiver
-        if (MPI_Recv(NULL, 0, MPI_BYTE, ch->receiver_ranks[0], 0, ch->comm, MPI_STATUS_IGNORE) != MPI_SUCCESS)
-        {
-            ERROR("Error in MPI_Recv(): Acknowledgment messages could not be received\n");
-            return -1;
-        }
+        ERROR("Error in send_slots_isend(): Data could not be sent\n");
+        return -1;
+    }
 
-        // Update buffered items
-        ch->buffered_items--;
+    // Update buffered items
+    ch->buffered_items++;
 
-        // Check for more incoming acknowledgement messages from receiver
-        if (MPI_Iprobe(ch->receiver_ranks[0], 0, ch->comm, &ch->flag, MPI_STATUS_IGNORE) != MPI_SUCCESS)
-        {
-            ERROR("Error in MPI_Iprobe(): Starting MPI_Iprobe() for acknowledgment messages failed\n");
-            return -1;
-        }
-    }
+    return 1;
+}
 
-    // If there is not enough buffer space wait for acknowledgment message
-    if (ch->buffered_items >= ch->capacity)
+int channel_trysend_pt2pt_spsc_buf(MPI_Channel *ch, void *data)
+{
+    // Collect the credits which have arrived from the receiver
+    if ((ch->credit = credits_collect(ch, 0, 0)) == -1)
     {
-        // Wait for incoming acknowledgement message from receiver
-        if (MPI_Probe(ch->receiver_ranks[0], 0, ch->comm, MPI_STATUS_IGNORE) != MPI_SUCCESS)
-        {
-            ERROR("Error in MPI_Probe(): Probing for acknowledgment message failed\n");
-            return -1;
-        }
+        ERROR("Error in credits_collect()\n");
+        return -1;
+    }
 
-        // Receive acknowledgement messages from receiver
-        if (MPI_Recv(NULL, 0, MPI_BYTE, ch->receiver_ranks[0], 0, ch->comm, MPI_STATUS_IGNORE) != MPI_SUCCESS)
-        {
-            ERROR("Error in MPI_Recv(): Acknowledgment messages could not be received\n");
-            return -1;
-        }
+    // Decrement buffered items by the number of elements the credits return
+    ch->buffered_items -= ch->credit;
 
-        // Update buffered items
-        ch->buffered_items--;
-    }
+    // If there is not enough buffer space data cannot be sent without blocking
+    if (ch->buffered_items >= ch->capacity)
+        return 0;
 
-    // Send data to receiver with buffered send
-    if (MPI_Bsend(data, ch->data_size, MPI_BYTE, ch->receiver_ranks[0], 0, ch->comm) != MPI_SUCCESS)
+    // Send data to receiver from a send slot
+    if (send_slots_isend(ch, data, ch->data_size, ch->receiver_ranks[0]) != 1)
     {
-        ERROR("Error in MPI_Bsend(): Data could not be sent\n");
+        ERROR("Error in send_slots_isend(): Data could not be sent\n");
         return -1;
     }
 
@@ -130,17 +170,17 @@ int channel_send_pt2pt_spsc_buf(MPI_Channel *ch, void *data)
 
 int channel_receive_pt2pt_spsc_buf(MPI_Channel *ch, void *data)
 {
-    // Receive data from sender
-    if (MPI_Recv(data, ch->data_size, MPI_BYTE, ch->sender_ranks[0], 0, ch->comm, MPI_STATUS_IGNORE) != MPI_SUCCESS)
+    // Receive data from the oldest pre-posted receive and post it again
+    if (recv_slots_receive(ch, data, 0) != 1)
     {
-        ERROR("Error in MPI_Recv(): Item could not be received\n");
+        ERROR("Error in recv_slots_receive(): Item could not be received\n");
         return -1;
     }
 
-    // Send acknowledgement message
-    if (MPI_Bsend(NULL, 0, MPI_BYTE, ch->sender_ranks[0], 0, ch->comm) != MPI_SUCCESS)
+    // Return the credit for the element; accumulated until half of the capacity has been consumed
+    if (credits_return(ch, 0) != 1)
     {
-        ERROR("Error in MPI_Bsend(): Acknowledgement message could not be sent. Capacity of channel could be invalid\n");
+        ERROR("Error in credits_return(): Credit message could not be sent\n");
         return -1;
     }
 
@@ -152,33 +192,15 @@ int channel_peek_pt2pt_spsc_buf(MPI_Channel *ch)
     // Check if sender is calling
     if (!ch->is_receiver)
     {
-        // Check for incoming acknowledgement messages from receiver
-        if (MPI_Iprobe(ch->receiver_ranks[0], 0, ch->comm, &ch->flag, MPI_STATUS_IGNORE) != MPI_SUCCESS)
+        // Collect the credits which have arrived from the receiver
+        if ((ch->credit = credits_collect(ch, 0, 0)) == -1)
         {
-            ERROR("Error in MPI_Iprobe(): Starting MPI_Iprobe() for acknowledgment messages failed\n");
+            ERROR("Error in credits_collect()\n");
             return -1;
         }
 
-        // Receive acknowledgement messages from receiver
-        while (ch->flag)
-        {
-            // Receive acknowledgement messages from receiver
-            if (MPI_Recv(NULL, 0, MPI_BYTE, ch->receiver_ranks[0], 0, ch->comm, MPI_STATUS_IGNORE) != MPI_SUCCESS)
-            {
-                ERROR("Error in MPI_Recv(): Acknowledgements could not be received\n")
-                return -1;
-            }
-
-            // Decrement send_count for every received message
-            ch->buffered_items--;
-
-            // Check for more incoming acknowledgement messages from receiver
-            if (MPI_Iprobe(ch->receiver_ranks[0], 0, ch->comm, &ch->flag, MPI_STATUS_IGNORE) != MPI_SUCCESS)
-            {
-                ERROR("Error in MPI_Iprobe(): Starting MPI_Iprobe() for acknowledgment messages failed\n");
-                return -1;
-            }
-        }
+        // Decrement buffered items by the number of elements the credits return
+        ch->buffered_items -= ch->credit;
 
         // Return number of items which can be sent
         return ch->capacity - ch->buffered_items;
@@ -186,18 +208,24 @@ int channel_peek_pt2pt_spsc_buf(MPI_Channel *ch)
     // Else the receiver is calling
     else
     {
-        // Checks if items can be received
-        if (MPI_Iprobe(ch->sender_ranks[0], 0, ch->comm, &ch->flag, MPI_STATUS_IGNORE) != MPI_SUCCESS)
-        {
-            ERROR("Error in MPI_Iprobe(): Starting MPI_Iprobe() for data message failed\n");
-            return -1;
-        }
-
-        // Returns a positive number if data can be received
-        return ch->flag;
+        // Return number of items which have arrived in the pre-posted receives
+        return recv_slots_ready(ch, 0);
     }
 }
 
+int channel_drain_pt2pt_spsc_buf(MPI_Channel *ch)
+{
+    // Receiver process has nothing to drain
+    if (ch->is_receiver)
+        return 1;
+
+    // Peeking consumes the acknowledgement messages which have arrived
+    if (channel_peek_pt2pt_spsc_buf(ch) == -1)
+        return -1;
+
+    return ch->buffered_items == 0;
+}
+
 int channel_free_pt2pt_spsc_buf(MPI_Channel *ch)
 {
     // Check if all messages have been sent and received
@@ -205,25 +233,29 @@ int channel_free_pt2pt_spsc_buf(MPI_Channel *ch)
     if (!ch->is_receiver) {
         while (ch->buffered_items > 0)
         {
-            // Check for more incoming acknowledgement messages from receiver
-            if (MPI_Probe(MPI_ANY_SOURCE, 0, ch->comm, MPI_STATUS_IGNORE) != MPI_SUCCESS)
-            {
-                ERROR("Error in MPI_Probe(): Probing for acknowledgment messages failed\n");
-                return -1;
-            }   
-
-            // Receive acknowledgement messages from receiver
-            if (MPI_Recv(NULL, 0, MPI_BYTE, MPI_ANY_SOURCE, 0, ch->comm, MPI_STATUS_IGNORE) != MPI_SUCCESS)
+            // Wait for a credit from the receiver
+            if ((ch->credit = credits_collect(ch, 0, 1)) == -1)
             {
-                ERROR("Error in MPI_Recv(): Acknowledgements could not be received\n")
+                ERROR("Error in credits_collect()\n");
                 return -1;
-            } 
+            }
 
-            // Decrement buffered items
-            ch->buffered_items--;        
+            // Decrement buffered items by the number of elements the credits return
+            ch->buffered_items -= ch->credit;
         }
     }
 
+    // Cancel the pre-posted receives of the receiver
+    if (ch->is_receiver)
+        recv_slots_free(ch);
+
+    // Wait for the messages in transit and release the send slots
+    int error = send_slots_free(ch);
+
+    // Release the window of one-sided credits
+    if (ch->rma_credits)
+        credit_win_free(ch);
+
     // Mark shadow comm for deallocation
     // Should be nothrow
     MPI_Comm_free(&ch->comm);
@@ -232,9 +264,6 @@ int channel_free_pt2pt_spsc_buf(MPI_Channel *ch)
     free(ch->receiver_ranks);
     free(ch->sender_ranks);
 
-    // Adjust buffer depending on the rank
-    int error = shrink_buffer(ch->is_receiver ? MPI_BSEND_OVERHEAD * ch->capacity : (int) (ch->data_size + 
-    MPI_BSEND_OVERHEAD) * ch->capacity);
 
     // Free channel
     free(ch);
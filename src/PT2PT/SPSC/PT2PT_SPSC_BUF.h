@@ -6,12 +6,17 @@
  * @date 2021-01-06
  * @copyright CC BY 4.0 (https://creativecommons.org/licenses/by/4.0/)
  * 
- * This PT2PT SPSC BUF channel implementation uses the buffered send mode of MPI. To bookmark the count of sent elements
- * the sender process stores the current buffer size, decrements it for every sent element and increments it for every
- * received acknowledgement message from the receiver. To assert a correct usage of the buffered send mode 
- * channel_alloc_pt2pt_spsc_buf() needs to append enough memory for the receiver and the sender. The sender process
- * checks for incoming acknowledgment messages and sends the element. The receiver process checks for incoming elements,
- * receives the element and sends an acknowledgment message.
+ * This PT2PT SPSC BUF channel implementation sends every message with MPI_Isend() from a ring of send slots owned by 
+ * the channel. To bookmark the count of sent elements the sender process stores the current buffer size, decrements it
+ * for every sent element and increments it by the count of every received credit message from the receiver. 
+ * channel_alloc_pt2pt_spsc_buf() allocates capacity send slots for the receiver and the sender; completed slots are 
+ * reclaimed with MPI_Testsome(), so no buffer needs to be attached for MPI_Bsend(). Since every message goes to the 
+ * same peer the send slots are bound to persistent requests which are restarted with MPI_Start(). The sender process
+ * checks for incoming acknowledgment messages and sends the element. The receiver process keeps capacity receives 
+ * pre-posted in a ring of receive slots, so elements do not pass through the unexpected-message queue of MPI. It 
+ * completes the oldest receive and posts it again. Instead of acknowledging every element the receiver returns the 
+ * consumed elements as one credit message once half of the capacity has been consumed, or earlier if the next element
+ * has not arrived yet since the sender might wait for the credit.
  */
 
 #ifndef PT2PT_SPSC_BUF_H
@@ -23,7 +28,7 @@
  * @brief Updates the properties of a passed MPI_Channel of type PT2PT SPSC BUF and returns it.
  * @param[in, out] MPI_Channel Pointer to a MPI_Channel allocated with channel_alloc(). 
  * @return Returns a pointer to a valid MPI_Channel with updated properties if updating was successful and NULL otherwise
- * @note Returns NULL if appending the buffer failed.
+ * @note Returns NULL if allocating the send slots failed.
  */
 MPI_Channel* channel_alloc_pt2pt_spsc_buf(MPI_Channel *ch);
 
@@ -38,6 +43,16 @@ MPI_Channel* channel_alloc_pt2pt_spsc_buf(MPI_Channel *ch);
  */
 int channel_send_pt2pt_spsc_buf(MPI_Channel *ch, void *data);
 
+/**
+ * @brief Sends the element only if the channel buffer has not reached the channel capacity. Calling 
+ * channel_trysend_pt2pt_spsc_buf() never blocks and is used by unbounded channels to hand over staged elements.
+ * @param[in] ch Pointer to a MPI_Channel of type PT2PT SPSC BUF.              
+ * @param[in] data Pointer to a memory adress of which size bytes will be sent from.
+ * @return Returns 1 if the element has been sent, 0 if the channel buffer is full and -1 if an error occured.
+ * @note Returns -1 if internal problems with MPI related functions happend.
+ */
+int channel_trysend_pt2pt_spsc_buf(MPI_Channel *ch, void *data);
+
 /**
  * @brief Receives the numbers of bytes of a data element specified in channel_alloc() from the channel and stores them
  * starting at the adress the void pointer holds. Calling channel_receive_pt2pt_spsc_buf() blocks only if no element has
@@ -54,19 +69,27 @@ int channel_receive_pt2pt_spsc_buf(MPI_Channel *ch, void *data);
  * calls).
  * @param[in] ch Pointer to a MPI_Channel of type PT2PT SPSC BUF.                 
  * @return If the sender process calls it returns the current number of elements which can be sent. If the receiver 
- * process calls it returns 1 if a message can be received and 0 if no message can be received. If an error occures it
- * returns -1. 
+ * process calls it returns the number of elements which have arrived in the pre-posted receives. If an error occures
+ * it returns -1. 
  * @note Returns -1 if internal problems with MPI related functions happen.
- * @note Since MPI will only let you check if and not how many messages can be received (MPI_Iprobe()) this function 
- * cannot return the number of buffered messages to the receiver.
  */
 int channel_peek_pt2pt_spsc_buf(MPI_Channel *ch);
 
+/**
+ * @brief Consumes the acknowledgement messages which have arrived at the sender process without blocking. Used by 
+ * channel_ifree() to drain the channel before it is freed.
+ * @param[in] ch Pointer to a MPI_Channel of type PT2PT SPSC BUF.
+ * @return Returns 1 if every message of the sender process has been acknowledged or the receiver process calls, 0 if 
+ * messages are still unacknowledged and -1 if an error occured.
+ * @note Returns -1 if internal problems with MPI related functions happen.
+ */
+int channel_drain_pt2pt_spsc_buf(MPI_Channel *ch);
+
 /**
  * @brief Deallocates the channel and all allocated members.
  * @param[in] ch Pointer to a MPI_Channel of type PT2PT SPSC BUF.                            
  * @return Returns 1 if deallocation was successful, -1 otherwise.
- * @note This function returns -1 if resizing of the buffer for MPI_Bsend() failed.
+ * @note This function returns -1 if a message in transit could not be completed.
  */
 int channel_free_pt2pt_spsc_buf(MPI_Channel *ch);
 
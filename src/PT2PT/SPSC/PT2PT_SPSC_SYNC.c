@@ -19,7 +19,7 @@ MPI_Channel *channel_alloc_pt2pt_spsc_sync(MPI_Channel *ch)
 
     // Create shadow comm and store it
     // Should be nothrow
-    if (MPI_Comm_dup(ch->comm, &ch->comm) != MPI_SUCCESS)
+    if (channel_comm_dup(ch, &ch->comm) != MPI_SUCCESS)
     {
         ERROR("Error in MPI_Comm_dup(): Fatal Error\n");
         free(ch->receiver_ranks);
@@ -29,11 +29,29 @@ MPI_Channel *channel_alloc_pt2pt_spsc_sync(MPI_Channel *ch)
         return NULL;
     }
 
+    // Every element goes to the same peer; bind a persistent request to a buffer of the channel
+    if ((ch->pers_buf = malloc(ch->data_size + 1)) == NULL || (ch->is_receiver ? 
+    MPI_Recv_init(ch->pers_buf, ch->data_size, MPI_BYTE, ch->sender_ranks[0], 0, ch->comm, &ch->req) : 
+    MPI_Ssend_init(ch->pers_buf, ch->data_size, MPI_BYTE, ch->receiver_ranks[0], 0, ch->comm, &ch->req)) 
+    != MPI_SUCCESS)
+    {
+        ERROR("Error in MPI_Ssend_init() or MPI_Recv_init()\n");
+        free(ch->pers_buf);
+        MPI_Comm_free(&ch->comm);
+        free(ch->receiver_ranks);
+        free(ch->sender_ranks);
+        channel_alloc_assert_success(comm, 1);
+        free(ch);
+        return NULL;
+    }
+
     // Final call to assure that every process was successfull
     // Use initial communicator since duplicated communicater has a new context
     if (channel_alloc_assert_success(comm, 0) != 1)
     {
         ERROR("Error in finalizing channel allocation: At least one process failed\n");
+        MPI_Request_free(&ch->req);
+        free(ch->pers_buf);
         free(ch->receiver_ranks);
         free(ch->sender_ranks);
         free(ch);
@@ -47,9 +65,12 @@ MPI_Channel *channel_alloc_pt2pt_spsc_sync(MPI_Channel *ch)
 
 int channel_send_pt2pt_spsc_sync(MPI_Channel *ch, void *data)
 {
-    // Send in synchronous mode, Ssend enforces synchronicity
-    if (MPI_Ssend(data, ch->data_size, MPI_BYTE, ch->receiver_ranks[0], 0, ch->comm) != MPI_SUCCESS) {
-        ERROR("Error in MPI_Ssend()\n");
+    // Copy element into the buffer the persistent request is bound to
+    memcpy(ch->pers_buf, data, ch->data_size);
+
+    // Send in synchronous mode, the persistent request was created with MPI_Ssend_init() which enforces synchronicity
+    if (MPI_Start(&ch->req) != MPI_SUCCESS || MPI_Wait(&ch->req, MPI_STATUS_IGNORE) != MPI_SUCCESS) {
+        ERROR("Error in MPI_Start() or MPI_Wait()\n");
         return -1;
     }
 
@@ -58,16 +79,40 @@ int channel_send_pt2pt_spsc_sync(MPI_Channel *ch, void *data)
 
 int channel_receive_pt2pt_spsc_sync(MPI_Channel *ch, void *data)
 {
-    // Call blocking receive 
-    if (MPI_Recv(data, ch->data_size, MPI_BYTE, ch->sender_ranks[0], 0, ch->comm, MPI_STATUS_IGNORE) != MPI_SUCCESS) {
-        ERROR("Error in MPI_Recv()\n");
+    // Start the persistent receive only now, so the synchronous send of the sender completes once the receiver calls
+    if (MPI_Start(&ch->req) != MPI_SUCCESS || MPI_Wait(&ch->req, MPI_STATUS_IGNORE) != MPI_SUCCESS) {
+        ERROR("Error in MPI_Start() or MPI_Wait()\n");
         return -1;    
     }
+
+    // Copy element out of the buffer the persistent request is bound to
+    memcpy(data, ch->pers_buf, ch->data_size);
+
     return 1;
 }
 
+int channel_peek_pt2pt_spsc_sync(MPI_Channel *ch)
+{
+    // The receiver only shows up when calling channel_receive(), so the sender cannot observe it
+    if (!ch->is_receiver)
+        return 1;
+
+    // Check for a pending synchronous send of the sender
+    if (MPI_Iprobe(ch->sender_ranks[0], 0, ch->comm, &ch->flag, MPI_STATUS_IGNORE) != MPI_SUCCESS)
+    {
+        ERROR("Error in MPI_Iprobe()\n");
+        return -1;
+    }
+
+    return ch->flag ? 1 : 0;
+}
+
 int channel_free_pt2pt_spsc_sync(MPI_Channel *ch) 
 {
+    // Free persistent request; it is inactive since every operation waited for it
+    MPI_Request_free(&ch->req);
+    free(ch->pers_buf);
+
     // Mark shadow comm for deallocation
     // Should be nothrow
     MPI_Comm_free(&ch->comm);
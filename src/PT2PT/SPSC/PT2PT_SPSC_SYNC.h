@@ -6,8 +6,9 @@
  * @date 2021-03-04
  * @copyright CC BY 4.0 (https://creativecommons.org/licenses/by/4.0/)
  *  
- * This PT2PT SPSC SYNC channel implementation uses the synchronous send mode of MPI. For sending MPI_Ssend() and 
- * for receiving MPI_Recv() is used.
+ * This PT2PT SPSC SYNC channel implementation uses the synchronous send mode of MPI. Since every element goes to the 
+ * same peer, the sender creates a persistent request with MPI_Ssend_init() and the receiver with MPI_Recv_init() 
+ * during allocation; both are bound to a buffer of the channel and every operation calls MPI_Start() and MPI_Wait().
  */
 
 #ifndef PT2PT_SPSC_SYNC_H
@@ -44,6 +45,16 @@ int channel_send_pt2pt_spsc_sync(MPI_Channel *ch, void *data);
  */
 int channel_receive_pt2pt_spsc_sync(MPI_Channel *ch, void *data);
 
+/**
+ * @brief Peeks at the channel and signals if a matching sender is waiting. The receiver process probes for a pending
+ * MPI_Ssend() of the sender. Since the receiver does not announce itself the sender process always gets 1.
+ * @param[in] ch Pointer to a MPI_Channel of type PT2PT SPSC SYNC
+ * @return Returns 1 if an element can be received without blocking (receiver process calls) or the sender process
+ * calls, 0 otherwise and -1 if an error occured
+ * @note Returns -1 if internal problems with MPI related functions happend
+ */
+int channel_peek_pt2pt_spsc_sync(MPI_Channel *ch);
+
 /**
  * @brief Deallocates the channel and all allocated members
  * @param[in, out] ch Pointer to a MPI_Channel of type PT2PT SPSC SYNC        
@@ -55,7 +55,7 @@ MPI_Channel *channel_alloc_rma_mpmc_buf(MPI_Channel *ch)
 
     // Create shadow comm and store it
     // Should be nothrow
-    if (MPI_Comm_dup(ch->comm, &ch->comm) != MPI_SUCCESS)
+    if (channel_comm_dup(ch, &ch->comm) != MPI_SUCCESS)
     {
         ERROR("Error in MPI_Comm_dup(): Fatal Error\n");
         free(ch->receiver_ranks);
@@ -78,7 +78,7 @@ MPI_Channel *channel_alloc_rma_mpmc_buf(MPI_Channel *ch)
             return NULL;
         }
         // Create window object
-        if (MPI_Win_create(ch->win_lmem, 5 * sizeof(int), sizeof(int), MPI_INFO_NULL, ch->comm, &ch->win) != MPI_SUCCESS)
+        if (MPI_Win_create(ch->win_lmem, 5 * sizeof(int), sizeof(int), ch->info, ch->comm, &ch->win) != MPI_SUCCESS)
         {
             ERROR("Error in MPI_Win_create()\n");
             MPI_Free_mem(ch->win_lmem);
@@ -102,7 +102,7 @@ MPI_Channel *channel_alloc_rma_mpmc_buf(MPI_Channel *ch)
             return NULL;
         }
         // Create window object
-        if (MPI_Win_create(ch->win_lmem, 2 * sizeof(int), sizeof(int), MPI_INFO_NULL, ch->comm, &ch->win) != MPI_SUCCESS)
+        if (MPI_Win_create(ch->win_lmem, 2 * sizeof(int), sizeof(int), ch->info, ch->comm, &ch->win) != MPI_SUCCESS)
         {
             ERROR("Error in MPI_Win_create()\n");
             MPI_Free_mem(ch->win_lmem);
@@ -127,7 +127,7 @@ MPI_Channel *channel_alloc_rma_mpmc_buf(MPI_Channel *ch)
         }
 
         // Create a window
-        if (MPI_Win_create(ch->win_lmem, INDICES_SIZE + (ch->capacity+1)*(ch->data_size + sizeof(int)), 1, MPI_INFO_NULL, ch->comm, &ch->win) != MPI_SUCCESS)
+        if (MPI_Win_create(ch->win_lmem, INDICES_SIZE + (ch->capacity+1)*(ch->data_size + sizeof(int)), 1, ch->info, ch->comm, &ch->win) != MPI_SUCCESS)
         {
             ERROR("Error in MPI_Win_create()\n");
             MPI_Free_mem(ch->win_lmem);
@@ -158,10 +158,11 @@ MPI_Channel *channel_alloc_rma_mpmc_buf(MPI_Channel *ch)
     return ch;
 }
 
-int channel_send_rma_mpmc_buf(MPI_Channel *ch, void *data) 
+// Appends the element as new node to the queue; needs a free node slot and an open access epoch
+static int enqueue_rma_mpmc_buf(MPI_Channel *ch, void *data)
 {
     // Stores size of one node in byte
-    char node_size = ch->data_size + sizeof(int);
+    int node_size = ch->data_size + sizeof(int);
 
     // Stores integer reference to local window memory usted to access read and write indices
     int *index = ch->win_lmem;
@@ -173,24 +174,6 @@ int channel_send_rma_mpmc_buf(MPI_Channel *ch, void *data)
     // Used to store tail adress
     int tail;
 
-    // Lock window of all procs of communicator (lock type is shared)
-    if (MPI_Win_lock_all(0, ch->win) != MPI_SUCCESS) 
-    {
-        ERROR("Error in MPI_Win_lock_all()\n");
-        return -1;    
-    }
-
-    // Loop while node buffer is full
-    do
-    {
-        // Ensure that memory is updated
-        if (MPI_Win_sync(ch->win) != MPI_SUCCESS) 
-        {
-            ERROR("Error in MPI_Win_sync()\n");
-            return -1;          
-        }
-    } while ((index[WRITE] + 1 == index[READ]) || ((index[WRITE] == ch->capacity && (index[READ] == 0))));
-
     // Create new node at current write index
     // Node consists of an integer next storing rank + write index and the data 
     memcpy(ptr_first_node + index[WRITE]*node_size, &rma_mpmc_buf_minus_one, sizeof(int));
@@ -244,7 +227,37 @@ int channel_send_rma_mpmc_buf(MPI_Channel *ch, void *data)
             ERROR("Error in MPI_Accumulate()\n");
             return -1;    
         }
-     }    
+     }
+
+    return 1;
+}
+
+int channel_send_rma_mpmc_buf(MPI_Channel *ch, void *data) 
+{
+    // Stores integer reference to local window memory usted to access read and write indices
+    int *index = ch->win_lmem;
+
+    // Lock window of all procs of communicator (lock type is shared)
+    if (MPI_Win_lock_all(0, ch->win) != MPI_SUCCESS) 
+    {
+        ERROR("Error in MPI_Win_lock_all()\n");
+        return -1;    
+    }
+
+    // Loop while node buffer is full
+    do
+    {
+        // Ensure that memory is updated
+        if (MPI_Win_sync(ch->win) != MPI_SUCCESS) 
+        {
+            ERROR("Error in MPI_Win_sync()\n");
+            return -1;          
+        }
+    } while ((index[WRITE] + 1 == index[READ]) || ((index[WRITE] == ch->capacity && (index[READ] == 0))));
+
+    // Create new node and append it to the queue
+    if (enqueue_rma_mpmc_buf(ch, data) != 1)
+        return -1;
 
     // Unlock window
     if (MPI_Win_unlock_all(ch->win) != MPI_SUCCESS)
@@ -256,23 +269,51 @@ int channel_send_rma_mpmc_buf(MPI_Channel *ch, void *data)
     return 1;
 }
 
-int channel_receive_rma_mpmc_buf(MPI_Channel *ch, void *data)
+int channel_trysend_rma_mpmc_buf(MPI_Channel *ch, void *data) 
 {
-    // Stores integer reference to local window memory used to access head and tail
-    int *lmem = ch->win_lmem;
+    // Stores integer reference to local window memory usted to access read and write indices
+    int *index = ch->win_lmem;
 
-    // Used to store adress next of a node
-    int next;
+    // Lock window of all procs of communicator (lock type is shared)
+    if (MPI_Win_lock_all(0, ch->win) != MPI_SUCCESS) 
+    {
+        ERROR("Error in MPI_Win_lock_all()\n");
+        return -1;    
+    }
 
-    // Used to store head adress
-    int head, tail;
+    // Ensure that memory is updated
+    if (MPI_Win_sync(ch->win) != MPI_SUCCESS) 
+    {
+        ERROR("Error in MPI_Win_sync()\n");
+        return -1;          
+    }
+
+    // Check if node buffer is full
+    int full = (index[WRITE] + 1 == index[READ]) || ((index[WRITE] == ch->capacity && (index[READ] == 0)));
+
+    // Create new node and append it to the queue if there is a free node slot
+    if (!full && enqueue_rma_mpmc_buf(ch, data) != 1)
+        return -1;
+
+    // Unlock window
+    if (MPI_Win_unlock_all(ch->win) != MPI_SUCCESS)
+    {
+        ERROR("Error in MPI_Win_unlock_all()\n");
+        return -1;                  
+    }
+
+    return !full;
+}
+
+// Opens an access epoch and acquires the distributed receiver lock; returns with the lock held
+static int lock_receivers_rma_mpmc_buf(MPI_Channel *ch)
+{
+    // Stores integer reference to local window memory used to access the lock variables
+    int *lmem = ch->win_lmem;
 
     // Used to fetch latest receiver rank
     int latest_recv;
 
-    // Used to signal sender that receiver is waiting to be woken up
-    int wake_up_rank = -ch->my_rank -2;
-
     // Lock window of all procs of communicator (lock type is shared)
     if (MPI_Win_lock_all(0, ch->win) != MPI_SUCCESS) 
     {
@@ -284,8 +325,6 @@ int channel_receive_rma_mpmc_buf(MPI_Channel *ch, void *data)
     lmem[SPIN] = -1;
     lmem[NEXT_RECV] = -1;
 
-    // Acquire Receiverlock
-
     // Replace latest receiver rank at intermediator receiver with rank of calling receiver
     if (MPI_Fetch_and_op(&ch->my_rank, &latest_recv, MPI_INT, ch->receiver_ranks[0], LATEST_RECV, MPI_REPLACE, ch->win) 
     != MPI_SUCCESS) 
@@ -316,66 +355,15 @@ int channel_receive_rma_mpmc_buf(MPI_Channel *ch, void *data)
             }
         } while (lmem[SPIN] == -1);
     }
-    // At this point the calling receiver has the receiver lock
-
-    // Exchange tail with negative rank if tail is -1 to signal sender that it should wake up corresponding receiver
-    if (MPI_Compare_and_swap(&wake_up_rank, &rma_mpmc_buf_minus_one, &tail, MPI_INT, ch->receiver_ranks[0], TAIL, ch->win) != MPI_SUCCESS)
-    {
-        ERROR("Error in MPI_Compare_and_swap()\n");
-        return -1;    
-    }
 
-    // Atomic load head node reference
-    if (MPI_Get_accumulate(NULL, 0, MPI_CHAR, &head, 1, MPI_INT, ch->receiver_ranks[0], HEAD, 1, MPI_INT, MPI_NO_OP, ch->win) != MPI_SUCCESS)
-    {
-        ERROR("Error in MPI_Get_accumulate()\n");
-        return -1;    
-    }
-
-    // Enforce completion of RMA calls
-    if (MPI_Win_flush(ch->receiver_ranks[0], ch->win) != MPI_SUCCESS)
-    {
-        ERROR("Error in MPI_Win_flush()\n");
-        return -1;    
-    }
-
-    // No node is inserted
-    if (head == -1)
-    {
-        // Wait until producer wakes calling process up
-        if (tail == -1)
-        {
-            // Loop until woken up
-            do
-            {
-                // Ensure that memory is updated
-                if (MPI_Win_sync(ch->win) != MPI_SUCCESS) 
-                {
-                    ERROR("Error in MPI_Win_sync()\n");
-                    return -1;          
-                }    
-            } while (lmem[SPIN] == -1);
-        }
-        do 
-        {
-            // Atomic load head at the intermediator receiver
-            if (MPI_Get_accumulate(NULL, 0, MPI_CHAR, &head, 1, MPI_INT, ch->receiver_ranks[0], HEAD, 1, MPI_INT, MPI_NO_OP, ch->win) != MPI_SUCCESS)
-            {
-                ERROR("Error in MPI_Get_accumulate()\n");
-                return -1;    
-            }
-
-            // Enforce completion of RMA calls
-            if (MPI_Win_flush(ch->receiver_ranks[0], ch->win) != MPI_SUCCESS)
-            {
-                ERROR("Error in MPI_Win_flush()\n");
-                return -1;    
-            }
-
-        } while (head == -1);
-    }
+    return 1;
+}
 
-    // At least one node is inserted; head stores the adress of the head node
+// Removes the head node of a non-empty queue and stores its data; needs the receiver lock
+static int dequeue_rma_mpmc_buf(MPI_Channel *ch, void *data, int head)
+{
+    // Used to store adress next of a node
+    int next;
 
     // Calculate rank and offset from head adress 
     int next_rank = head / (ch->capacity+1);
@@ -477,6 +465,18 @@ int channel_receive_rma_mpmc_buf(MPI_Channel *ch, void *data)
         return -1;    
     } 
 
+    return 1;
+}
+
+// Passes the distributed receiver lock on to the next receiver and closes the access epoch
+static int unlock_receivers_rma_mpmc_buf(MPI_Channel *ch)
+{
+    // Stores integer reference to local window memory used to access the lock variables
+    int *lmem = ch->win_lmem;
+
+    // Used to fetch latest receiver rank and next rank to wake up
+    int latest_recv, next_rank;
+
     // Check if another receiver registered at local next rank variable
     if (lmem[NEXT_RECV] == -1)
     {
@@ -544,6 +544,122 @@ int channel_receive_rma_mpmc_buf(MPI_Channel *ch, void *data)
     return 1;
 }
 
+int channel_receive_rma_mpmc_buf(MPI_Channel *ch, void *data)
+{
+    // Stores integer reference to local window memory used to access head and tail
+    int *lmem = ch->win_lmem;
+
+    // Used to store head adress
+    int head, tail;
+
+    // Used to signal sender that receiver is waiting to be woken up
+    int wake_up_rank = -ch->my_rank -2;
+
+    // Acquire Receiverlock
+    if (lock_receivers_rma_mpmc_buf(ch) != 1)
+        return -1;
+
+    // At this point the calling receiver has the receiver lock
+
+    // Exchange tail with negative rank if tail is -1 to signal sender that it should wake up corresponding receiver
+    if (MPI_Compare_and_swap(&wake_up_rank, &rma_mpmc_buf_minus_one, &tail, MPI_INT, ch->receiver_ranks[0], TAIL, ch->win) != MPI_SUCCESS)
+    {
+        ERROR("Error in MPI_Compare_and_swap()\n");
+        return -1;    
+    }
+
+    // Atomic load head node reference
+    if (MPI_Get_accumulate(NULL, 0, MPI_CHAR, &head, 1, MPI_INT, ch->receiver_ranks[0], HEAD, 1, MPI_INT, MPI_NO_OP, ch->win) != MPI_SUCCESS)
+    {
+        ERROR("Error in MPI_Get_accumulate()\n");
+        return -1;    
+    }
+
+    // Enforce completion of RMA calls
+    if (MPI_Win_flush(ch->receiver_ranks[0], ch->win) != MPI_SUCCESS)
+    {
+        ERROR("Error in MPI_Win_flush()\n");
+        return -1;    
+    }
+
+    // No node is inserted
+    if (head == -1)
+    {
+        // Wait until producer wakes calling process up
+        if (tail == -1)
+        {
+            // Loop until woken up
+            do
+            {
+                // Ensure that memory is updated
+                if (MPI_Win_sync(ch->win) != MPI_SUCCESS) 
+                {
+                    ERROR("Error in MPI_Win_sync()\n");
+                    return -1;          
+                }    
+            } while (lmem[SPIN] == -1);
+        }
+        do 
+        {
+            // Atomic load head at the intermediator receiver
+            if (MPI_Get_accumulate(NULL, 0, MPI_CHAR, &head, 1, MPI_INT, ch->receiver_ranks[0], HEAD, 1, MPI_INT, MPI_NO_OP, ch->win) != MPI_SUCCESS)
+            {
+                ERROR("Error in MPI_Get_accumulate()\n");
+                return -1;    
+            }
+
+            // Enforce completion of RMA calls
+            if (MPI_Win_flush(ch->receiver_ranks[0], ch->win) != MPI_SUCCESS)
+            {
+                ERROR("Error in MPI_Win_flush()\n");
+                return -1;    
+            }
+
+        } while (head == -1);
+    }
+
+    // At least one node is inserted; head stores the adress of the head node
+    if (dequeue_rma_mpmc_buf(ch, data, head) != 1)
+        return -1;
+
+    // Release Receiverlock
+    return unlock_receivers_rma_mpmc_buf(ch);
+}
+
+int channel_tryreceive_rma_mpmc_buf(MPI_Channel *ch, void *data)
+{
+    // Used to store head adress
+    int head;
+
+    // Acquire Receiverlock
+    if (lock_receivers_rma_mpmc_buf(ch) != 1)
+        return -1;
+
+    // Atomic load head node reference; no wake up is registered at the tail since the receiver does not wait
+    if (MPI_Get_accumulate(NULL, 0, MPI_CHAR, &head, 1, MPI_INT, ch->receiver_ranks[0], HEAD, 1, MPI_INT, MPI_NO_OP, ch->win) != MPI_SUCCESS)
+    {
+        ERROR("Error in MPI_Get_accumulate()\n");
+        return -1;    
+    }
+
+    // Enforce completion of RMA calls
+    if (MPI_Win_flush(ch->receiver_ranks[0], ch->win) != MPI_SUCCESS)
+    {
+        ERROR("Error in MPI_Win_flush()\n");
+        return -1;    
+    }
+
+    // Remove head node if a node is inserted; a node whose insertion is still in progress counts as not inserted
+    if (head != -1 && dequeue_rma_mpmc_buf(ch, data, head) != 1)
+        return -1;
+
+    // Release Receiverlock
+    if (unlock_receivers_rma_mpmc_buf(ch) != 1)
+        return -1;
+
+    return head != -1;
+}
+
 int channel_peek_rma_mpmc_buf(MPI_Channel *ch)
 {
     // Stores integer reference to local window memory usted to access head (if consumer calls) or read and write indices (if sender calls)
@@ -38,6 +38,16 @@ MPI_Channel *channel_alloc_rma_mpmc_buf(MPI_Channel *ch);
  */
 int channel_send_rma_mpmc_buf(MPI_Channel *ch, void *data);
 
+/**
+ * @brief Sends the element only if the channel buffer has not reached the channel capacity. Calling 
+ * channel_trysend_rma_mpmc_buf() never blocks and is used by unbounded channels to hand over staged elements.
+ * @param[in] ch Pointer to a MPI_Channel of type RMA MPMC BUF.              
+ * @param[in] data Pointer to a memory adress of which size bytes will be sent from.
+ * @return Returns 1 if the element has been sent, 0 if the channel buffer is full and -1 if an error occured.
+ * @note Returns -1 if internal problems with MPI related functions happend.
+ */
+int channel_trysend_rma_mpmc_buf(MPI_Channel *ch, void *data);
+
 /**
  * @brief Receives the numbers of bytes of a data element specified in channel_alloc() from the channel and stores them
  * starting at the adress the void pointer holds. Calling channel_receive_rma_mpmc_buf() blocks only if no element has
@@ -49,6 +59,16 @@ int channel_send_rma_mpmc_buf(MPI_Channel *ch, void *data);
  */
 int channel_receive_rma_mpmc_buf(MPI_Channel *ch, void *data);
 
+/**
+ * @brief Receives an element only if the queue stores at least one element. Calling channel_tryreceive_rma_mpmc_buf()
+ * only waits for the receiver lock and is used by channels with priority levels to poll every level.
+ * @param[in] ch Pointer to a MPI_Channel of type RMA MPMC BUF.                 
+ * @param[in] data Pointer to a memory adress of which size bytes will be received to.
+ * @return Returns 1 if an element has been received, 0 if the queue is empty and -1 if an error occured.
+ * @note Returns -1 if internal problems with MPI related functions happend.
+ */
+int channel_tryreceive_rma_mpmc_buf(MPI_Channel *ch, void *data);
+
 /**
  * @brief Peeks at the channel and signals if messages can be sent (sender process calls) or received (receiver process
  * calls).
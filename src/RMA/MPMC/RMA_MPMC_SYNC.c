@@ -34,7 +34,7 @@ MPI_Channel *channel_alloc_rma_mpmc_sync(MPI_Channel *ch)
 
     // Create shadow comm and store it
     // Should be nothrow
-    if (MPI_Comm_dup(ch->comm, &ch->comm) != MPI_SUCCESS)
+    if (channel_comm_dup(ch, &ch->comm) != MPI_SUCCESS)
     {
         ERROR("Error in MPI_Comm_dup(): Fatal Error\n");
         free(ch->receiver_ranks);
@@ -60,7 +60,7 @@ MPI_Channel *channel_alloc_rma_mpmc_sync(MPI_Channel *ch)
         }
 
         // Create window object
-        if (MPI_Win_create(ch->win_lmem, 7 * sizeof(int) + ch->data_size, 1, MPI_INFO_NULL, ch->comm, &ch->win) != MPI_SUCCESS)
+        if (MPI_Win_create(ch->win_lmem, 7 * sizeof(int) + ch->data_size, 1, ch->info, ch->comm, &ch->win) != MPI_SUCCESS)
         {
             ERROR("Error in MPI_Win_create()\n");
             MPI_Free_mem(ch->win_lmem);
@@ -88,7 +88,7 @@ MPI_Channel *channel_alloc_rma_mpmc_sync(MPI_Channel *ch)
         }
 
         // Create window object
-        if (MPI_Win_create(ch->win_lmem, 3 * sizeof(int) + ch->data_size, 1, MPI_INFO_NULL, ch->comm, &ch->win) != MPI_SUCCESS)
+        if (MPI_Win_create(ch->win_lmem, 3 * sizeof(int) + ch->data_size, 1, ch->info, ch->comm, &ch->win) != MPI_SUCCESS)
         {
             ERROR("Error in MPI_Win_create()\n");
             MPI_Free_mem(ch->win_lmem);
@@ -109,7 +109,7 @@ MPI_Channel *channel_alloc_rma_mpmc_sync(MPI_Channel *ch)
         }
 
         // Create a window for the indices
-        if (MPI_Win_create(ch->win_lmem, 3 * sizeof(int), 1, MPI_INFO_NULL, ch->comm, &ch->win) != MPI_SUCCESS)
+        if (MPI_Win_create(ch->win_lmem, 3 * sizeof(int), 1, ch->info, ch->comm, &ch->win) != MPI_SUCCESS)
         {
             ERROR("Error in MPI_Win_create()\n");
             MPI_Free_mem(ch->win_lmem);
@@ -507,6 +507,43 @@ int channel_receive_rma_mpmc_sync(MPI_Channel *ch, void *data)
     return 1;
 }
 
+int channel_peek_rma_mpmc_sync(MPI_Channel *ch)
+{
+    // Used to fetch | CURRENT_SENDER | LATEST_SENDER | CURRENT_RECEIVER | LATEST_RECEIVER | of intermediate receiver
+    int ranks[4];
+
+    // Offset to current sender of receiver 0
+    int cur_sender = 3 * sizeof(int) + ch->data_size;
+
+    // Lock window of all procs of communicator (lock type is shared)
+    if (MPI_Win_lock_all(0, ch->win) != MPI_SUCCESS)
+    {
+        ERROR("Error in MPI_Win_lock_all()\n");
+        return -1;
+    }
+
+    // Atomically read registered senders and receivers
+    if (MPI_Get_accumulate(NULL, 0, MPI_INT, ranks, 4, MPI_INT, ch->receiver_ranks[0], cur_sender, 4, MPI_INT, 
+    MPI_NO_OP, ch->win) != MPI_SUCCESS)
+    {
+        ERROR("Error in MPI_Get_accumulate()\n");
+        return -1;
+    }
+
+    // Unlock window again
+    if (MPI_Win_unlock_all(ch->win) != MPI_SUCCESS)
+    {
+        ERROR("Error in MPI_Win_unlock_all()\n");
+        return -1;
+    }
+
+    // Senders look for receivers and vice versa; latest ranks are only reset once the lock queue is empty
+    if (ch->is_receiver)
+        return ranks[0] != -1 || ranks[1] != -1 ? 1 : 0;
+
+    return ranks[2] != -1 || ranks[3] != -1 ? 1 : 0;
+}
+
 int channel_free_rma_mpmc_sync(MPI_Channel *ch) 
 {
     // Free allocated memory used for storing ranks
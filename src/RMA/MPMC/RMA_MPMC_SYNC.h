@@ -48,6 +48,17 @@ int channel_send_rma_mpmc_sync(MPI_Channel *ch, void *data);
  */
 int channel_receive_rma_mpmc_sync(MPI_Channel *ch, void *data);
 
+/**
+ * @brief Peeks at the channel and signals if a matching partner is waiting. The calling process reads the registered
+ * senders and receivers at the intermediate receiver. Since several processes might compete for the same partner a
+ * following channel_send_rma_mpmc_sync() or channel_receive_rma_mpmc_sync() might still block.
+ * @param[in] ch Pointer to a MPI_Channel of type RMA MPMC SYNC
+ * @return Returns 1 if a receiver is registered (sender process calls) or a sender is registered (receiver process
+ * calls), 0 otherwise and -1 if an error occured
+ * @note Returns -1 if internal problems with MPI related functions happend
+ */
+int channel_peek_rma_mpmc_sync(MPI_Channel *ch);
+
 /**
  * @brief Deallocates the channel and all allocated members
  * @param[in, out] ch Pointer to a MPI_Channel of type RMA MPMC SYNC                 
@@ -37,7 +37,7 @@ MPI_Channel *channel_alloc_rma_mpsc_buf(MPI_Channel *ch)
 
     // Create shadow comm and store it
     // Should be nothrow
-    if (MPI_Comm_dup(ch->comm, &ch->comm) != MPI_SUCCESS)
+    if (channel_comm_dup(ch, &ch->comm) != MPI_SUCCESS)
     {
         ERROR("Error in MPI_Comm_dup(): Fatal Error\n");
         free(ch->receiver_ranks);
@@ -59,7 +59,7 @@ MPI_Channel *channel_alloc_rma_mpsc_buf(MPI_Channel *ch)
             return NULL;
         }
         // Create window object
-        if (MPI_Win_create(ch->win_lmem, 2 * sizeof(int), sizeof(int), MPI_INFO_NULL, ch->comm, &ch->win) != MPI_SUCCESS)
+        if (MPI_Win_create(ch->win_lmem, 2 * sizeof(int), sizeof(int), ch->info, ch->comm, &ch->win) != MPI_SUCCESS)
         {
             ERROR("Error in MPI_Win_create()\n");
             MPI_Free_mem(ch->win_lmem);
@@ -86,7 +86,7 @@ MPI_Channel *channel_alloc_rma_mpsc_buf(MPI_Channel *ch)
         }
 
         // Create a window
-        if (MPI_Win_create(ch->win_lmem, INDICES_SIZE + (ch->capacity+1)*(ch->data_size + sizeof(int)), 1, MPI_INFO_NULL, 
+        if (MPI_Win_create(ch->win_lmem, INDICES_SIZE + (ch->capacity+1)*(ch->data_size + sizeof(int)), 1, ch->info, 
         ch->comm, &ch->win) != MPI_SUCCESS)
         {
             ERROR("Error in MPI_Win_create()\n");
@@ -118,10 +118,19 @@ MPI_Channel *channel_alloc_rma_mpsc_buf(MPI_Channel *ch)
     return ch;
 }
 
-int channel_send_rma_mpsc_buf(MPI_Channel *ch, void *data) 
+// Checks if the sender has used up its quota of nodes; without quota this is the case if the node buffer is full
+static inline int full_rma_mpsc_buf(MPI_Channel *ch, int *index)
+{
+    int used = index[WRITE] - index[READ];
+
+    return (used >= 0 ? used : ch->capacity + 1 + used) >= ch->quota;
+}
+
+// Appends the element as new node to the queue; needs a free node slot and an open access epoch
+static int enqueue_rma_mpsc_buf(MPI_Channel *ch, void *data)
 {
     // Stores size of one node in byte
-    char node_size = ch->data_size + sizeof(int);
+    int node_size = ch->data_size + sizeof(int);
 
     // Stores integer reference to local window memory usted to access read and write indices
     int *index = ch->win_lmem;
@@ -133,24 +142,6 @@ int channel_send_rma_mpsc_buf(MPI_Channel *ch, void *data)
     // Used to store tail adress
     int tail;
 
-    // Lock window of all procs of communicator (lock type is shared)
-    if (MPI_Win_lock_all(0, ch->win) != MPI_SUCCESS) 
-    {
-        ERROR("Error in MPI_Win_lock_all()\n");
-        return -1;    
-    }
-
-    // Loop while node buffer is full
-    do
-    {
-        // Ensure that memory is updated
-        if (MPI_Win_sync(ch->win) != MPI_SUCCESS) 
-        {
-            ERROR("Error in MPI_Win_sync()\n");
-            return -1;          
-        }
-    } while ((index[WRITE] + 1 == index[READ]) || ((index[WRITE] == ch->capacity && (index[READ] == 0))));
-
     // Create new node at current write index
     // Node consists of an integer next storing rank + write index and the data 
     memcpy(ptr_first_node + index[WRITE]*node_size, &rma_mpsc_buf_minus_one, sizeof(int));
@@ -196,7 +187,37 @@ int channel_send_rma_mpsc_buf(MPI_Channel *ch, void *data)
             ERROR("Error in MPI_Accumulate()\n");
             return -1;    
         }
-     }    
+     }
+
+    return 1;
+}
+
+int channel_send_rma_mpsc_buf(MPI_Channel *ch, void *data) 
+{
+    // Stores integer reference to local window memory usted to access read and write indices
+    int *index = ch->win_lmem;
+
+    // Lock window of all procs of communicator (lock type is shared)
+    if (MPI_Win_lock_all(0, ch->win) != MPI_SUCCESS) 
+    {
+        ERROR("Error in MPI_Win_lock_all()\n");
+        return -1;    
+    }
+
+    // Loop while node buffer is full
+    do
+    {
+        // Ensure that memory is updated
+        if (MPI_Win_sync(ch->win) != MPI_SUCCESS) 
+        {
+            ERROR("Error in MPI_Win_sync()\n");
+            return -1;          
+        }
+    } while (full_rma_mpsc_buf(ch, index));
+
+    // Create new node and append it to the queue
+    if (enqueue_rma_mpsc_buf(ch, data) != 1)
+        return -1;
 
     // Unlock window
     if (MPI_Win_unlock_all(ch->win) != MPI_SUCCESS)
@@ -208,6 +229,42 @@ int channel_send_rma_mpsc_buf(MPI_Channel *ch, void *data)
     return 1;
 }
 
+int channel_trysend_rma_mpsc_buf(MPI_Channel *ch, void *data) 
+{
+    // Stores integer reference to local window memory usted to access read and write indices
+    int *index = ch->win_lmem;
+
+    // Lock window of all procs of communicator (lock type is shared)
+    if (MPI_Win_lock_all(0, ch->win) != MPI_SUCCESS) 
+    {
+        ERROR("Error in MPI_Win_lock_all()\n");
+        return -1;    
+    }
+
+    // Ensure that memory is updated
+    if (MPI_Win_sync(ch->win) != MPI_SUCCESS) 
+    {
+        ERROR("Error in MPI_Win_sync()\n");
+        return -1;          
+    }
+
+    // Check if node buffer is full
+    int full = full_rma_mpsc_buf(ch, index);
+
+    // Create new node and append it to the queue if there is a free node slot
+    if (!full && enqueue_rma_mpsc_buf(ch, data) != 1)
+        return -1;
+
+    // Unlock window
+    if (MPI_Win_unlock_all(ch->win) != MPI_SUCCESS)
+    {
+        ERROR("Error in MPI_Win_unlock_all()\n");
+        return -1;                  
+    }
+
+    return !full;
+}
+
 int channel_receive_rma_mpsc_buf(MPI_Channel *ch, void *data)
 {
     // Stores integer reference to local window memory used to access head and tail
@@ -430,7 +487,7 @@ int channel_peek_rma_mpsc_buf(MPI_Channel *ch)
             return -1;
         }
 
-        return dif >= 0 ? ch->capacity - dif :  ch->capacity - (ch->capacity + 1 + dif);  
+        return dif >= 0 ? ch->quota - dif :  ch->quota - (ch->capacity + 1 + dif);  
     }
 }
 
@@ -473,7 +530,7 @@ MPI_Channel *channel_alloc_rma_mpsc_buf(MPI_Channel *ch)
 
     // Create shadow comm and store it
     // Should be nothrow
-    if (MPI_Comm_dup(ch->comm, &ch->comm) != MPI_SUCCESS)
+    if (channel_comm_dup(ch, &ch->comm) != MPI_SUCCESS)
     {
         ERROR("Error in MPI_Comm_dup(): Fatal Error\n");
         free(ch->receiver_ranks);
@@ -499,7 +556,7 @@ MPI_Channel *channel_alloc_rma_mpsc_buf(MPI_Channel *ch)
         // Create a window. Set the displacement unit to sizeof(int) to simplify
         // the addressing at the originator processes
         // Needs 2 * sizeof(int) extra space for storing the indices
-        if (MPI_Win_create(ch->win_lmem, 3 * sizeof(int) + (ch->capacity+1) * ch->data_size, 1, MPI_INFO_NULL, ch->comm, &ch->win) != MPI_SUCCESS)
+        if (MPI_Win_create(ch->win_lmem, 3 * sizeof(int) + (ch->capacity+1) * ch->data_size, 1, ch->info, ch->comm, &ch->win) != MPI_SUCCESS)
         {
             ERROR("Error in MPI_Win_create()\n");
             MPI_Free_mem(ch->win_lmem);
@@ -525,7 +582,7 @@ MPI_Channel *channel_alloc_rma_mpsc_buf(MPI_Channel *ch)
         }
 
         // Create a window
-        if (MPI_Win_create(ch->win_lmem, 2 * sizeof(int), 1, MPI_INFO_NULL, ch->comm, &ch->win) != MPI_SUCCESS)
+        if (MPI_Win_create(ch->win_lmem, 2 * sizeof(int), 1, ch->info, ch->comm, &ch->win) != MPI_SUCCESS)
         {
             ERROR("Error in MPI_Win_create()\n");
             MPI_Free_mem(ch->win_lmem);
@@ -840,7 +897,7 @@ MPI_Channel *channel_alloc_rma_mpsc_buf(MPI_Channel *ch)
 
     // Create shadow comm and store it
     // Should be nothrow
-    if (MPI_Comm_dup(ch->comm, &ch->comm) != MPI_SUCCESS)
+    if (channel_comm_dup(ch, &ch->comm) != MPI_SUCCESS)
     {
         ERROR("Error in MPI_Comm_dup(): Fatal Error\n");
         free(ch->receiver_ranks);
@@ -866,7 +923,7 @@ MPI_Channel *channel_alloc_rma_mpsc_buf(MPI_Channel *ch)
         // Create a window. Set the displacement unit to sizeof(int) to simplify
         // the addressing at the originator processes
         // Needs 2 * sizeof(int) extra space for storing the indices
-        if (MPI_Win_create(ch->win_lmem, 2 * sizeof(int) + (ch->capacity+1) * ch->data_size, 1, MPI_INFO_NULL, ch->comm, &ch->win) != MPI_SUCCESS)
+        if (MPI_Win_create(ch->win_lmem, 2 * sizeof(int) + (ch->capacity+1) * ch->data_size, 1, ch->info, ch->comm, &ch->win) != MPI_SUCCESS)
         {
             ERROR("Error in MPI_Win_create()\n");
             MPI_Free_mem(ch->win_lmem);
@@ -882,7 +939,7 @@ MPI_Channel *channel_alloc_rma_mpsc_buf(MPI_Channel *ch)
     else
     {
         // Create a window with no local memory attached
-        if (MPI_Win_create(NULL, 0, 1, MPI_INFO_NULL, ch->comm, &ch->win) != MPI_SUCCESS)
+        if (MPI_Win_create(NULL, 0, 1, ch->info, ch->comm, &ch->win) != MPI_SUCCESS)
         {
             ERROR("Error in MPI_Win_create()\n");
             free(ch);
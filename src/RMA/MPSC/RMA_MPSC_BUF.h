@@ -67,6 +67,16 @@ MPI_Channel *channel_alloc_rma_mpsc_buf(MPI_Channel *ch);
  */
 int channel_send_rma_mpsc_buf(MPI_Channel *ch, void *data);
 
+/**
+ * @brief Sends the element only if the channel buffer has not reached the channel capacity. Calling 
+ * channel_trysend_rma_mpsc_buf() never blocks and is used by unbounded channels to hand over staged elements.
+ * @param[in] ch Pointer to a MPI_Channel of type RMA MPSC BUF.              
+ * @param[in] data Pointer to a memory adress of which size bytes will be sent from.
+ * @return Returns 1 if the element has been sent, 0 if the channel buffer is full and -1 if an error occured.
+ * @note Returns -1 if internal problems with MPI related functions happend.
+ */
+int channel_trysend_rma_mpsc_buf(MPI_Channel *ch, void *data);
+
 /**
  * @brief Receives the numbers of bytes of a data element specified in channel_alloc() from the channel and stores them
  * starting at the adress the void pointer holds. Calling channel_receive_rma_mpsc_buf() blocks only if no element has
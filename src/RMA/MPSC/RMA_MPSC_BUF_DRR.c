@@ -0,0 +1,375 @@
+/**
+ * @file RMA_MPSC_BUF_DRR.c
+ * @author Toni Hollfelder (Toni.Hollfelder@uni-bayreuth.de)
+ * @brief Implementation of RMA MPSC Buffered Channel with deficit round robin scheduling
+ * @version 1.0
+ * @date 2021-05-25
+ * @copyright CC BY 4.0 (https://creativecommons.org/licenses/by/4.0/)
+ *
+ */
+
+#include "RMA_MPSC_BUF_DRR.h"
+
+#define READ 0
+#define WRITE 1
+
+// Displacement of the write index and the circular buffer of sender i at the receiver
+#define WRITE_DISP(i) ((i) * sizeof(int))
+#define RING_DISP(ch, i) ((ch)->sender_count * sizeof(int) + (i) * ((ch)->capacity + 1) * (ch)->data_size)
+
+MPI_Channel *channel_alloc_rma_mpsc_buf_drr(MPI_Channel *ch)
+{
+    // Store internal channel type
+    ch->chan_type = MPSC;
+
+    // Receiver starts the first round with the first sender
+    ch->idx_last_rank = 0;
+
+    // Create backup in case of failing MPI_Comm_dup
+    MPI_Comm comm = ch->comm;
+
+    // Create shadow comm and store it
+    // Should be nothrow
+    if (channel_comm_dup(ch, &ch->comm) != MPI_SUCCESS)
+    {
+        ERROR("Error in MPI_Comm_dup(): Fatal Error\n");
+        free(ch->receiver_ranks);
+        free(ch->sender_ranks);
+        free(ch->weights);
+        free(ch->deficits);
+        channel_alloc_assert_success(comm, 1);
+        free(ch);
+        return NULL;
+    }
+
+    // Size of the local window memory
+    MPI_Aint win_size = ch->is_receiver ? (MPI_Aint) RING_DISP(ch, ch->sender_count) : (MPI_Aint) (2 * sizeof(int));
+
+    // Allocate memory for the write index and circular buffer of every sender (receiver) or read and write index
+    // (sender)
+    if (MPI_Alloc_mem(win_size, MPI_INFO_NULL, &ch->win_lmem) != MPI_SUCCESS)
+    {
+        ERROR("Error in MPI_Alloc_mem()\n");
+        free(ch->receiver_ranks);
+        free(ch->sender_ranks);
+        free(ch->weights);
+        free(ch->deficits);
+        MPI_Comm_free(&ch->comm);
+        channel_alloc_assert_success(comm, 1);
+        free(ch);
+        return NULL;
+    }
+
+    // Create window object with allocated window memory
+    if (MPI_Win_create(ch->win_lmem, win_size, 1, ch->info, ch->comm, &ch->win) != MPI_SUCCESS)
+    {
+        ERROR("Error in MPI_Win_create()\n");
+        free(ch->receiver_ranks);
+        free(ch->sender_ranks);
+        free(ch->weights);
+        free(ch->deficits);
+        MPI_Free_mem(ch->win_lmem);
+        MPI_Comm_free(&ch->comm);
+        channel_alloc_assert_success(comm, 1);
+        free(ch);
+        return NULL;
+    }
+
+    if (ch->is_receiver)
+    {
+        // Set write indices of every sender to 0
+        memset(ch->win_lmem, 0, ch->sender_count * sizeof(int));
+
+        // Read indices of every sender are stored locally
+        ch->local_indices = calloc(ch->sender_count, sizeof(*ch->local_indices));
+    }
+    else
+    {
+        // Set read and write index to 0
+        int *ptr = ch->win_lmem;
+        *ptr = *(ptr + 1) = 0;
+
+        // Store index of the calling sender; determines its circular buffer at the receiver
+        for (ch->sender_idx = 0; ch->sender_ranks[ch->sender_idx] != ch->my_rank; ch->sender_idx++);
+    }
+
+    // Final call to assure that every process was successfull
+    // Use initial communicator since duplicated communicater has a new context
+    if (channel_alloc_assert_success(comm, ch->is_receiver && ch->local_indices == NULL) != 1)
+    {
+        ERROR("Error in finalizing channel allocation: At least one process failed\n");
+        free(ch->receiver_ranks);
+        free(ch->sender_ranks);
+        free(ch->weights);
+        free(ch->deficits);
+        if (ch->is_receiver)
+            free(ch->local_indices);
+        MPI_Win_free(&ch->win);
+        MPI_Free_mem(ch->win_lmem);
+        MPI_Comm_free(&ch->comm);
+        free(ch);
+        return NULL;
+    }
+
+    DEBUG("RMA MPSC BUF DRR finished allocation\n");
+
+    return ch;
+}
+
+// Checks if the sender has used up its quota of slots in its circular buffer
+static inline int full_rma_mpsc_buf_drr(MPI_Channel *ch, int *index)
+{
+    int used = index[WRITE] - index[READ];
+
+    return (used >= 0 ? used : ch->capacity + 1 + used) >= ch->quota;
+}
+
+// Puts the element into the circular buffer of the sender at the receiver; needs a free slot and an open access epoch
+static int put_rma_mpsc_buf_drr(MPI_Channel *ch, void *data)
+{
+    // Store pointer to local indices
+    int *index = ch->win_lmem;
+
+    // Send data to the circular buffer of the calling sender at the write position
+    if (MPI_Put(data, ch->data_size, MPI_BYTE, ch->receiver_ranks[0], RING_DISP(ch, ch->sender_idx) + index[WRITE] *
+    ch->data_size, ch->data_size, MPI_BYTE, ch->win) != MPI_SUCCESS)
+    {
+        ERROR("Error in MPI_Put()\n");
+        return -1;
+    }
+
+    // Ensure completion of data transfer with MPI_Put
+    // Needs to be done before the write index is updated
+    if (MPI_Win_flush(ch->receiver_ranks[0], ch->win) != MPI_SUCCESS)
+    {
+        ERROR("Error in MPI_Win_flush()\n");
+        return -1;
+    }
+
+    // Update write index depending on its position (0 if end of queue, +1 otherwise)
+    index[WRITE] == ch->capacity ? index[WRITE] = 0 : index[WRITE]++;
+
+    // Send updated write index with atomic put
+    if (MPI_Accumulate(&index[WRITE], 1, MPI_INT, ch->receiver_ranks[0], WRITE_DISP(ch->sender_idx), 1, MPI_INT,
+    MPI_REPLACE, ch->win) != MPI_SUCCESS)
+    {
+        ERROR("Error in MPI_Accumulate()\n");
+        return -1;
+    }
+
+    return 1;
+}
+
+int channel_send_rma_mpsc_buf_drr(MPI_Channel *ch, void *data)
+{
+    // Stores integer reference to local window memory used to access read and write indices
+    int *index = ch->win_lmem;
+
+    // Lock window of all procs of communicator (lock type is shared)
+    if (MPI_Win_lock_all(0, ch->win) != MPI_SUCCESS)
+    {
+        ERROR("Error in MPI_Win_lock_all()\n");
+        return -1;
+    }
+
+    // Loop while the quota is used up
+    do
+    {
+        // Ensure that memory is updated
+        if (MPI_Win_sync(ch->win) != MPI_SUCCESS)
+        {
+            ERROR("Error in MPI_Win_sync()\n");
+            return -1;
+        }
+    } while (full_rma_mpsc_buf_drr(ch, index));
+
+    // Put data into the circular buffer and update write index
+    if (put_rma_mpsc_buf_drr(ch, data) != 1)
+        return -1;
+
+    // Unlock window
+    if (MPI_Win_unlock_all(ch->win) != MPI_SUCCESS)
+    {
+        ERROR("Error in MPI_Win_unlock_all()\n");
+        return -1;
+    }
+
+    return 1;
+}
+
+int channel_trysend_rma_mpsc_buf_drr(MPI_Channel *ch, void *data)
+{
+    // Stores integer reference to local window memory used to access read and write indices
+    int *index = ch->win_lmem;
+
+    // Lock window of all procs of communicator (lock type is shared)
+    if (MPI_Win_lock_all(0, ch->win) != MPI_SUCCESS)
+    {
+        ERROR("Error in MPI_Win_lock_all()\n");
+        return -1;
+    }
+
+    // Ensure that memory is updated
+    if (MPI_Win_sync(ch->win) != MPI_SUCCESS)
+    {
+        ERROR("Error in MPI_Win_sync()\n");
+        return -1;
+    }
+
+    // Check if the quota is used up
+    int full = full_rma_mpsc_buf_drr(ch, index);
+
+    // Put data into the circular buffer and update write index if there is a free slot
+    if (!full && put_rma_mpsc_buf_drr(ch, data) != 1)
+        return -1;
+
+    // Unlock window
+    if (MPI_Win_unlock_all(ch->win) != MPI_SUCCESS)
+    {
+        ERROR("Error in MPI_Win_unlock_all()\n");
+        return -1;
+    }
+
+    return !full;
+}
+
+int channel_receive_rma_mpsc_buf_drr(MPI_Channel *ch, void *data)
+{
+    // Stores integer reference to the write indices of every sender
+    int *write = ch->win_lmem;
+
+    // Lock window of all procs of communicator (lock type is shared)
+    if (MPI_Win_lock_all(0, ch->win) != MPI_SUCCESS)
+    {
+        ERROR("Error in MPI_Win_lock_all()\n");
+        return -1;
+    }
+
+    // Loop over all senders until an element can be received
+    while (1)
+    {
+        // If current sender index is equal to count of sender reset to 0
+        if (ch->idx_last_rank >= ch->sender_count)
+            ch->idx_last_rank = 0;
+
+        int s = ch->idx_last_rank;
+
+        // Grant the weight of the sender as deficit once its turn starts
+        if (ch->deficits[s] == 0)
+            ch->deficits[s] = ch->weights[s];
+
+        // Ensure that memory is updated
+        if (MPI_Win_sync(ch->win) != MPI_SUCCESS)
+        {
+            ERROR("Error in MPI_Win_sync()\n");
+            return -1;
+        }
+
+        // Circular buffer of the sender stores at least one element
+        if (ch->local_indices[s] != write[s])
+        {
+            // Copy data to user buffer
+            memcpy(data, (char *) ch->win_lmem + RING_DISP(ch, s) + ch->local_indices[s] * ch->data_size,
+            ch->data_size);
+
+            // Update read index depending on its position (0 if end of queue, +1 otherwise)
+            ch->local_indices[s] == ch->capacity ? ch->local_indices[s] = 0 : ch->local_indices[s]++;
+
+            // Send updated read index to the sender
+            if (MPI_Accumulate(&ch->local_indices[s], 1, MPI_INT, ch->sender_ranks[s], READ, 1, MPI_INT, MPI_REPLACE,
+            ch->win) != MPI_SUCCESS)
+            {
+                ERROR("Error in MPI_Accumulate()\n");
+                return -1;
+            }
+
+            // Sender keeps its turn until its deficit is used up
+            if (--ch->deficits[s] == 0)
+                ch->idx_last_rank++;
+
+            // Unlock window
+            if (MPI_Win_unlock_all(ch->win) != MPI_SUCCESS)
+            {
+                ERROR("Error in MPI_Win_unlock_all()\n");
+                return -1;
+            }
+
+            return 1;
+        }
+
+        // A sender without pending elements loses the rest of its deficit
+        ch->deficits[s] = 0;
+        ch->idx_last_rank++;
+    }
+}
+
+int channel_peek_rma_mpsc_buf_drr(MPI_Channel *ch)
+{
+    // Stores integer reference to local window memory used to access the write indices (if receiver calls) or read and
+    // write index (if sender calls)
+    int *lmem = ch->win_lmem;
+
+    // Used to store the number of buffered elements
+    int buffered = 0;
+
+    // Lock local window with shared lock
+    if (MPI_Win_lock(MPI_LOCK_SHARED, ch->my_rank, 0, ch->win) != MPI_SUCCESS)
+    {
+        ERROR("Error in MPI_Win_lock()\n");
+        return -1;
+    }
+
+    // If calling process is receiver sum up the buffered elements of every sender
+    if (ch->is_receiver)
+    {
+        for (int s = 0; s < ch->sender_count; s++)
+        {
+            int dif = lmem[s] - ch->local_indices[s];
+            buffered += dif >= 0 ? dif : ch->capacity + 1 + dif;
+        }
+    }
+    // Calling process is sender
+    else
+    {
+        int dif = lmem[WRITE] - lmem[READ];
+        buffered = dif >= 0 ? dif : ch->capacity + 1 + dif;
+    }
+
+    // Unlock window
+    if (MPI_Win_unlock(ch->my_rank, ch->win) != MPI_SUCCESS)
+    {
+        ERROR("Error in MPI_Win_unlock(): Channel might be broken\n");
+        return -1;
+    }
+
+    return ch->is_receiver ? buffered : ch->quota - buffered;
+}
+
+int channel_free_rma_mpsc_buf_drr(MPI_Channel *ch)
+{
+    // Free allocated memory used for storing ranks, weights and read indices
+    free(ch->receiver_ranks);
+    free(ch->sender_ranks);
+    free(ch->weights);
+    free(ch->deficits);
+    if (ch->is_receiver)
+        free(ch->local_indices);
+
+    // Frees window
+    // Should be nothrow since window object was created successfully
+    MPI_Win_free(&ch->win);
+
+    // Frees window memory
+    // Should be nothrow since window memory was allcoated successfully
+    MPI_Free_mem(ch->win_lmem);
+
+    // Frees shadow communicator
+    // Should be nothrow since shadow comm duplication was successful
+    MPI_Comm_free(&ch->comm);
+
+    // Free the allocated memory ch points to
+    free(ch);
+    ch = NULL;
+
+    return 1;
+}
@@ -0,0 +1,91 @@
+/**
+ * @file RMA_MPSC_BUF_DRR.h
+ * @author Toni Hollfelder (Toni.Hollfelder@uni-bayreuth.de)
+ * @brief Header of RMA MPSC BUF Channel with deficit round robin scheduling
+ * @version 1.0
+ * @date 2021-05-25
+ * @copyright CC BY 4.0 (https://creativecommons.org/licenses/by/4.0/)
+ *
+ * This RMA MPSC BUF channel implementation is used if the senders of a channel allocated with channel_alloc_weighted()
+ * have different weights. The M&S queue of the RMA MPSC BUF channel serves the senders in global enqueue order and
+ * therefore cannot prefer a sender. Instead every sender has a circular buffer of its own at the receiver process,
+ * which works like the circular buffer of the RMA SPSC BUF channel, and the receiver serves the buffers by deficit
+ * round robin: once the turn of a sender starts it gets its weight as deficit and is served until the deficit is used
+ * up or its buffer is empty.
+ *
+ * Layout of local window memory of each process depending on sender or receiver process:
+ * Sender:      | READ | WRITE |
+ * Receiver:    | WRITE_0 | ... | WRITE_N | RING_0 | ... | RING_N |    where RING_i stores capacity + 1 elements of
+ * sender i
+ *
+ * The sender puts the element into its circular buffer at the receiver process and updates its write index there.
+ * The receiver keeps the read indices locally and writes them back to the sender process after each element. A
+ * sender can have at most quota elements in its buffer.
+ *
+ * Regarding progress guarantees this implementation is wait-free for the sender process as long as its buffer is not
+ * full.
+ */
+
+#ifndef RMA_MPSC_BUF_DRR_H
+#define RMA_MPSC_BUF_DRR_H
+
+#include "../../MPI_Channel_Struct.h"
+
+/**
+ * @brief Updates the properties of a passed MPI_Channel of type RMA MPSC BUF DRR and returns it.
+ * @param[in, out] ch Pointer to a MPI_Channel allocated with channel_alloc_weighted().
+ * @return Returns a pointer to a valid MPI_Channel with updated properties if updating was successful and NULL otherwise
+ * @note Returns NULL if MPI related functions or allocation memory failure happend.
+ */
+MPI_Channel *channel_alloc_rma_mpsc_buf_drr(MPI_Channel *ch);
+
+/**
+ * @brief Sends the numbers of bytes of a data element specified in channel_alloc_weighted() starting at the adress
+ * the void pointer holds into the channel. Calling channel_send_rma_mpsc_buf_drr() blocks only if the sender has
+ * reached its quota.
+ * @param[in] ch Pointer to a MPI_Channel of type RMA MPSC BUF DRR.
+ * @param[in] data Pointer to a memory adress of which size bytes will be sent from.
+ * @return Returns 1 if sending was successful, -1 otherwise.
+ * @note Returns -1 if internal problems with MPI related functions happend.
+ */
+int channel_send_rma_mpsc_buf_drr(MPI_Channel *ch, void *data);
+
+/**
+ * @brief Sends the element only if the sender has not reached its quota. Calling channel_trysend_rma_mpsc_buf_drr()
+ * never blocks and is used by unbounded channels to hand over staged elements.
+ * @param[in] ch Pointer to a MPI_Channel of type RMA MPSC BUF DRR.
+ * @param[in] data Pointer to a memory adress of which size bytes will be sent from.
+ * @return Returns 1 if the element has been sent, 0 if the buffer of the sender is full and -1 if an error occured.
+ * @note Returns -1 if internal problems with MPI related functions happend.
+ */
+int channel_trysend_rma_mpsc_buf_drr(MPI_Channel *ch, void *data);
+
+/**
+ * @brief Receives the numbers of bytes of a data element specified in channel_alloc_weighted() from the channel and
+ * stores them starting at the adress the void pointer holds. The sender is chosen by deficit round robin. Calling
+ * channel_receive_rma_mpsc_buf_drr() blocks only if the buffers of every sender are empty.
+ * @param[in] ch Pointer to a MPI_Channel of type RMA MPSC BUF DRR.
+ * @param[in] data Pointer to a memory adress of which size bytes will be received to.
+ * @return Returns 1 if receiving was successful, -1 otherwise.
+ * @note Returns -1 if internal problems with MPI related functions happend.
+ */
+int channel_receive_rma_mpsc_buf_drr(MPI_Channel *ch, void *data);
+
+/**
+ * @brief Peeks at the channel and signals if messages can be sent (sender process calls) or received (receiver process
+ * calls).
+ * @param[in] ch Pointer to a MPI_Channel of type RMA MPSC BUF DRR.
+ * @return Returns the current number of elements which can be sent if the sender process calls and the number of
+ * buffered elements of every sender if the receiver process calls.
+ * @note Returns -1 if internal problems with MPI related functions happen.
+ */
+int channel_peek_rma_mpsc_buf_drr(MPI_Channel *ch);
+
+/**
+ * @brief Deallocates the channel and all allocated members.
+ * @param[in] ch Pointer to a MPI_Channel of type RMA MPSC BUF DRR.
+ * @return Returns 1 since deallocation is always successfull
+ */
+int channel_free_rma_mpsc_buf_drr(MPI_Channel *ch);
+
+#endif // RMA_MPSC_BUF_DRR_H
@@ -0,0 +1,327 @@
+/**
+ * @file RMA_MPSC_REDUCE.c
+ * @author Toni Hollfelder (Toni.Hollfelder@uni-bayreuth.de)
+ * @brief Implementation of RMA MPSC REDUCE Channel
+ * @version 1.0
+ * @date 2021-05-26
+ * @copyright CC BY 4.0 (https://creativecommons.org/licenses/by/4.0/)
+ *
+ */
+
+#include "RMA_MPSC_REDUCE.h"
+
+// Displacements of the counters and slots at the receiver; the first slot starts and every slot is padded to a multiple
+// of 16 bytes, so the accumulated elements of every slot are aligned for any predefined datatype
+#define ALIGN16(n) (((n) + 15) / 16 * 16)
+#define CONSUMED_DISP 0
+#define ARRIVED_DISP(s) ((1 + (s)) * sizeof(int))
+#define DONE_DISP(ch, s) ((1 + (ch)->capacity + (s)) * sizeof(int))
+#define SLOT_DISP(ch, s) (ALIGN16((1 + 2 * (ch)->capacity) * sizeof(int)) + (s) * ALIGN16((ch)->data_size))
+
+// Used for MPI calls
+static const int rma_mpsc_reduce_one = 1;
+static const int rma_mpsc_reduce_zero = 0;
+
+MPI_Channel *channel_alloc_rma_mpsc_reduce(MPI_Channel *ch)
+{
+    // Store internal channel type
+    ch->chan_type = MPSC;
+
+    // Create backup in case of failing MPI_Comm_dup
+    MPI_Comm comm = ch->comm;
+
+    // Create shadow comm and store it
+    // Should be nothrow
+    if (channel_comm_dup(ch, &ch->comm) != MPI_SUCCESS)
+    {
+        ERROR("Error in MPI_Comm_dup(): Fatal Error\n");
+        free(ch->receiver_ranks);
+        free(ch->sender_ranks);
+        channel_alloc_assert_success(comm, 1);
+        free(ch);
+        return NULL;
+    }
+
+    // Only the receiver exposes counters and slots
+    MPI_Aint win_size = ch->is_receiver ? (MPI_Aint) SLOT_DISP(ch, ch->capacity) : 0;
+
+    // Allocate memory for counters and slots (receiver)
+    if (MPI_Alloc_mem(win_size, MPI_INFO_NULL, &ch->win_lmem) != MPI_SUCCESS)
+    {
+        ERROR("Error in MPI_Alloc_mem()\n");
+        free(ch->receiver_ranks);
+        free(ch->sender_ranks);
+        MPI_Comm_free(&ch->comm);
+        channel_alloc_assert_success(comm, 1);
+        free(ch);
+        return NULL;
+    }
+
+    // Create window object with allocated window memory
+    if (MPI_Win_create(ch->win_lmem, win_size, 1, ch->info, ch->comm, &ch->win) != MPI_SUCCESS)
+    {
+        ERROR("Error in MPI_Win_create()\n");
+        free(ch->receiver_ranks);
+        free(ch->sender_ranks);
+        MPI_Free_mem(ch->win_lmem);
+        MPI_Comm_free(&ch->comm);
+        channel_alloc_assert_success(comm, 1);
+        free(ch);
+        return NULL;
+    }
+
+    // No epoch has been received and no sender has arrived yet
+    memset(ch->win_lmem, 0, win_size);
+
+    // Final call to assure that every process was successfull
+    // Use initial communicator since duplicated communicater has a new context
+    if (channel_alloc_assert_success(comm, 0) != 1)
+    {
+        ERROR("Error in finalizing channel allocation: At least one process failed\n");
+        free(ch->receiver_ranks);
+        free(ch->sender_ranks);
+        MPI_Win_free(&ch->win);
+        MPI_Free_mem(ch->win_lmem);
+        MPI_Comm_free(&ch->comm);
+        free(ch);
+        return NULL;
+    }
+
+    DEBUG("RMA MPSC REDUCE finished allocation\n");
+
+    return ch;
+}
+
+int channel_send_rma_mpsc_reduce(MPI_Channel *ch, void *data)
+{
+    // Slot of the current epoch
+    int slot = ch->epoch % ch->capacity;
+
+    // Used to fetch the number of senders which arrived or finished before
+    int arrived, done = 0;
+
+    // Lock window of all procs of communicator (lock type is shared)
+    if (MPI_Win_lock_all(0, ch->win) != MPI_SUCCESS)
+    {
+        ERROR("Error in MPI_Win_lock_all()\n");
+        return -1;
+    }
+
+    // Wait until the receiver has received the epoch which used the slot before
+    while (ch->consumed <= ch->epoch - ch->capacity)
+    {
+        if (MPI_Get_accumulate(NULL, 0, MPI_INT, &ch->consumed, 1, MPI_INT, ch->receiver_ranks[0], CONSUMED_DISP, 1, 
+        MPI_INT, MPI_NO_OP, ch->win) != MPI_SUCCESS || MPI_Win_flush(ch->receiver_ranks[0], ch->win) != MPI_SUCCESS)
+        {
+            ERROR("Error in MPI_Get_accumulate()\n");
+            return -1;
+        }
+    }
+
+    // Register as sender of the epoch
+    if (MPI_Fetch_and_op(&rma_mpsc_reduce_one, &arrived, MPI_INT, ch->receiver_ranks[0], ARRIVED_DISP(slot), MPI_SUM, 
+    ch->win) != MPI_SUCCESS || MPI_Win_flush(ch->receiver_ranks[0], ch->win) != MPI_SUCCESS)
+    {
+        ERROR("Error in MPI_Fetch_and_op()\n");
+        return -1;
+    }
+
+    // The first sender overwrites what is left of the epoch which used the slot before
+    if (arrived == 0)
+    {
+        if (MPI_Accumulate(data, ch->reduce_count, ch->reduce_type, ch->receiver_ranks[0], SLOT_DISP(ch, slot), 
+        ch->reduce_count, ch->reduce_type, MPI_REPLACE, ch->win) != MPI_SUCCESS)
+        {
+            ERROR("Error in MPI_Accumulate()\n");
+            return -1;
+        }
+    }
+    // Every further sender combines its element once the element of the first sender is complete
+    else
+    {
+        while (done == 0)
+        {
+            if (MPI_Get_accumulate(NULL, 0, MPI_INT, &done, 1, MPI_INT, ch->receiver_ranks[0], DONE_DISP(ch, slot), 1, 
+            MPI_INT, MPI_NO_OP, ch->win) != MPI_SUCCESS || MPI_Win_flush(ch->receiver_ranks[0], ch->win) != 
+            MPI_SUCCESS)
+            {
+                ERROR("Error in MPI_Get_accumulate()\n");
+                return -1;
+            }
+        }
+
+        if (MPI_Accumulate(data, ch->reduce_count, ch->reduce_type, ch->receiver_ranks[0], SLOT_DISP(ch, slot), 
+        ch->reduce_count, ch->reduce_type, ch->reduce_op, ch->win) != MPI_SUCCESS)
+        {
+            ERROR("Error in MPI_Accumulate()\n");
+            return -1;
+        }
+    }
+
+    // Element needs to be complete at the receiver before it is counted
+    if (MPI_Win_flush(ch->receiver_ranks[0], ch->win) != MPI_SUCCESS)
+    {
+        ERROR("Error in MPI_Win_flush()\n");
+        return -1;
+    }
+
+    // Signal that the element of the calling sender is complete
+    if (MPI_Accumulate(&rma_mpsc_reduce_one, 1, MPI_INT, ch->receiver_ranks[0], DONE_DISP(ch, slot), 1, MPI_INT, 
+    MPI_SUM, ch->win) != MPI_SUCCESS)
+    {
+        ERROR("Error in MPI_Accumulate()\n");
+        return -1;
+    }
+
+    // Unlock window again
+    if (MPI_Win_unlock_all(ch->win) != MPI_SUCCESS)
+    {
+        ERROR("Error in MPI_Win_unlock_all()\n");
+        return -1;
+    }
+
+    // Next contribution belongs to the next epoch
+    ch->epoch++;
+
+    return 1;
+}
+
+int channel_receive_rma_mpsc_reduce(MPI_Channel *ch, void *data)
+{
+    // Slot of the current epoch
+    int slot = ch->epoch % ch->capacity;
+
+    // Used to index counters in local window memory
+    int *lmem = ch->win_lmem;
+
+    // Lock window of all procs of communicator (lock type is shared)
+    if (MPI_Win_lock_all(0, ch->win) != MPI_SUCCESS)
+    {
+        ERROR("Error in MPI_Win_lock_all()\n");
+        return -1;
+    }
+
+    // Spin until every sender has completed its element
+    do
+    {
+        if (MPI_Win_sync(ch->win) != MPI_SUCCESS) // Update memory
+        {
+            ERROR("Error in MPI_Win_sync()\n");
+            return -1;
+        }
+    } while (lmem[DONE_DISP(ch, slot) / sizeof(int)] != ch->sender_count);
+
+    // Copy combined element to data buffer
+    memcpy(data, (char *) ch->win_lmem + SLOT_DISP(ch, slot), ch->data_size);
+
+    // Reset counters of the slot; no sender accesses the slot until the epoch is marked as received
+    if (MPI_Accumulate(&rma_mpsc_reduce_zero, 1, MPI_INT, ch->my_rank, ARRIVED_DISP(slot), 1, MPI_INT, MPI_REPLACE, 
+    ch->win) != MPI_SUCCESS || MPI_Accumulate(&rma_mpsc_reduce_zero, 1, MPI_INT, ch->my_rank, DONE_DISP(ch, slot), 1, 
+    MPI_INT, MPI_REPLACE, ch->win) != MPI_SUCCESS)
+    {
+        ERROR("Error in MPI_Accumulate()\n");
+        return -1;
+    }
+
+    // Counters need to be reset before senders may use the slot again
+    if (MPI_Win_flush(ch->my_rank, ch->win) != MPI_SUCCESS)
+    {
+        ERROR("Error in MPI_Win_flush()\n");
+        return -1;
+    }
+
+    // Mark epoch as received
+    if (MPI_Accumulate(&rma_mpsc_reduce_one, 1, MPI_INT, ch->my_rank, CONSUMED_DISP, 1, MPI_INT, MPI_SUM, ch->win) != 
+    MPI_SUCCESS)
+    {
+        ERROR("Error in MPI_Accumulate()\n");
+        return -1;
+    }
+
+    // Unlock window again
+    if (MPI_Win_unlock_all(ch->win) != MPI_SUCCESS)
+    {
+        ERROR("Error in MPI_Win_unlock_all()\n");
+        return -1;
+    }
+
+    ch->epoch++;
+
+    return 1;
+}
+
+int channel_peek_rma_mpsc_reduce(MPI_Channel *ch)
+{
+    // Used to count complete epochs
+    int count = 0;
+
+    // Used to index counters in local window memory
+    int *lmem = ch->win_lmem;
+
+    // Lock window of all procs of communicator (lock type is shared)
+    if (MPI_Win_lock_all(0, ch->win) != MPI_SUCCESS)
+    {
+        ERROR("Error in MPI_Win_lock_all()\n");
+        return -1;
+    }
+
+    if (ch->is_receiver)
+    {
+        // Update memory
+        if (MPI_Win_sync(ch->win) != MPI_SUCCESS)
+        {
+            ERROR("Error in MPI_Win_sync()\n");
+            return -1;
+        }
+
+        // Count complete epochs in the order they will be received
+        while (count < ch->capacity && lmem[DONE_DISP(ch, (ch->epoch + count) % ch->capacity) / sizeof(int)] == 
+        ch->sender_count)
+            count++;
+    }
+    else
+    {
+        // Fetch number of received epochs
+        if (MPI_Get_accumulate(NULL, 0, MPI_INT, &ch->consumed, 1, MPI_INT, ch->receiver_ranks[0], CONSUMED_DISP, 1, 
+        MPI_INT, MPI_NO_OP, ch->win) != MPI_SUCCESS)
+        {
+            ERROR("Error in MPI_Get_accumulate()\n");
+            return -1;
+        }
+    }
+
+    // Unlock window again
+    if (MPI_Win_unlock_all(ch->win) != MPI_SUCCESS)
+    {
+        ERROR("Error in MPI_Win_unlock_all()\n");
+        return -1;
+    }
+
+    // A sender can contribute up to epoch consumed + capacity - 1
+    return ch->is_receiver ? count : ch->consumed + ch->capacity - ch->epoch;
+}
+
+int channel_free_rma_mpsc_reduce(MPI_Channel *ch)
+{
+    // Free allocated memory used for storing ranks
+    free(ch->receiver_ranks);
+    free(ch->sender_ranks);
+
+    // Frees window
+    // Should be nothrow since window object was created successfully
+    MPI_Win_free(&ch->win);
+
+    // Frees window memory
+    // Should be nothrow since window memory was allcoated successfully
+    MPI_Free_mem(ch->win_lmem);
+
+    // Frees shadow communicator
+    // Should be nothrow since shadow comm duplication was successful
+    MPI_Comm_free(&ch->comm);
+
+    // Free the allocated memory ch points to
+    free(ch);
+    ch = NULL;
+
+    return 1;
+}
@@ -0,0 +1,78 @@
+/**
+ * @file RMA_MPSC_REDUCE.h
+ * @author Toni Hollfelder (Toni.Hollfelder@uni-bayreuth.de)
+ * @brief Header of RMA MPSC REDUCE Channel
+ * @version 1.0
+ * @date 2021-05-26
+ * @copyright CC BY 4.0 (https://creativecommons.org/licenses/by/4.0/)
+ *
+ * This RMA MPSC REDUCE channel implementation combines one element of every sender per epoch into a single element
+ * at the receiver. Instead of enqueueing every element the senders apply MPI_Accumulate() with the operation of the
+ * channel directly to the slot of the epoch in the receiver window, so the receiver only copies the combined element.
+ *
+ * Layout of local window memory of the receiver process:
+ * Receiver:    | CONSUMED | ARRIVED_0 | ... | ARRIVED_N | DONE_0 | ... | DONE_N | SLOT_0 | ... | SLOT_N |
+ * where N + 1 is the capacity and epoch e uses the slot e % capacity. Senders do not expose window memory.
+ *
+ * A sender contributes to epoch e only after the receiver has received epoch e - capacity, which it reads from
+ * CONSUMED. It then increments ARRIVED of the slot atomically. Since reduction operations have no identity element in
+ * general the first sender of an epoch replaces the slot with its element and every further sender waits until the
+ * first one has finished (DONE > 0) before it accumulates its element. After its element is complete at the receiver
+ * every sender increments DONE. Once DONE equals the number of senders the receiver copies the slot, resets ARRIVED
+ * and DONE and increments CONSUMED.
+ *
+ * Apart from waiting for the first sender of an epoch a sender never blocks as long as the receiver has received epoch
+ * e - capacity. Only the predefined operations of MPI can be used.
+ */
+
+#ifndef RMA_MPSC_REDUCE_H
+#define RMA_MPSC_REDUCE_H
+
+#include "../../MPI_Channel_Struct.h"
+
+/**
+ * @brief Updates the properties of a passed MPI_Channel of type RMA MPSC REDUCE and returns it.
+ * @param[in, out] ch Pointer to a MPI_Channel allocated with channel_alloc_reduce().
+ * @return Returns a pointer to a valid MPI_Channel with updated properties if updating was successful and NULL otherwise
+ * @note Returns NULL if MPI related functions or allocation memory failure happend.
+ */
+MPI_Channel *channel_alloc_rma_mpsc_reduce(MPI_Channel *ch);
+
+/**
+ * @brief Accumulates the element the void pointer points to into the current epoch of the sender at the receiver.
+ * Calling channel_send_rma_mpsc_reduce() blocks only if the receiver has not yet received the epoch capacity epochs
+ * ago.
+ * @param[in] ch Pointer to a MPI_Channel of type RMA MPSC REDUCE
+ * @param[in] data Pointer to count elements of the datatype passed to channel_alloc_reduce()
+ * @return Returns 1 if sending was successful, -1 otherwise
+ * @note Returns -1 if internal problems with MPI related functions happend
+ */
+int channel_send_rma_mpsc_reduce(MPI_Channel *ch, void *data);
+
+/**
+ * @brief Receives the combined element of the current epoch and stores it starting at the adress the void pointer
+ * holds. Calling channel_receive_rma_mpsc_reduce() blocks until every sender has contributed to the epoch.
+ * @param[in] ch Pointer to a MPI_Channel of type RMA MPSC REDUCE
+ * @param[out] data Pointer to memory for count elements of the datatype passed to channel_alloc_reduce()
+ * @return Returns 1 if receiving was successful, -1 otherwise
+ * @note Returns -1 if internal problems with MPI related functions happend
+ */
+int channel_receive_rma_mpsc_reduce(MPI_Channel *ch, void *data);
+
+/**
+ * @brief Peeks at the channel and signals how many epochs can be contributed to (sender process calls) or received
+ * (receiver process calls) without blocking.
+ * @param[in] ch Pointer to a MPI_Channel of type RMA MPSC REDUCE
+ * @return Returns the number of epochs the sender can contribute to or the number of complete epochs at the receiver.
+ * Returns -1 if an error occured
+ */
+int channel_peek_rma_mpsc_reduce(MPI_Channel *ch);
+
+/**
+ * @brief Deallocates the channel and all allocated members.
+ * @param[in] ch Pointer to a MPI_Channel of type RMA MPSC REDUCE
+ * @return Returns 1 since deallocation is always successfull
+ */
+int channel_free_rma_mpsc_reduce(MPI_Channel *ch);
+
+#endif // RMA_MPSC_REDUCE_H
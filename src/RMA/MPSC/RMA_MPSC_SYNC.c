@@ -41,7 +41,7 @@ MPI_Channel *channel_alloc_rma_mpsc_sync(MPI_Channel *ch)
         }
 
         // Create window object
-        if (MPI_Win_create(ch->win_lmem, 2 * sizeof(int) + ch->data_size, 1, MPI_INFO_NULL, ch->comm, &ch->win) != MPI_SUCCESS)
+        if (MPI_Win_create(ch->win_lmem, 2 * sizeof(int) + ch->data_size, 1, ch->info, ch->comm, &ch->win) != MPI_SUCCESS)
         {
             ERROR("Error in MPI_Win_create()\n");
             MPI_Free_mem(ch->win_lmem);
@@ -66,7 +66,7 @@ MPI_Channel *channel_alloc_rma_mpsc_sync(MPI_Channel *ch)
         }
 
         // Create window object
-        if (MPI_Win_create(ch->win_lmem, 3 * sizeof(int), 1, MPI_INFO_NULL, ch->comm, &ch->win) != MPI_SUCCESS)
+        if (MPI_Win_create(ch->win_lmem, 3 * sizeof(int), 1, ch->info, ch->comm, &ch->win) != MPI_SUCCESS)
         {
             ERROR("Error in MPI_Win_create()\n");
             MPI_Free_mem(ch->win_lmem);
@@ -80,7 +80,7 @@ MPI_Channel *channel_alloc_rma_mpsc_sync(MPI_Channel *ch)
     MPI_Comm comm = ch->comm;
 
     // Create shadow comm and store it; should be nothrow
-    if (MPI_Comm_dup(ch->comm, &ch->comm) != MPI_SUCCESS)
+    if (channel_comm_dup(ch, &ch->comm) != MPI_SUCCESS)
     {
         ERROR("Error in MPI_Comm_dup(): Fatal Error\n");
         free(ch->receiver_ranks);
@@ -306,6 +306,40 @@ int channel_receive_rma_mpsc_sync(MPI_Channel *ch, void *data)
     return 1;
 }
 
+int channel_peek_rma_mpsc_sync(MPI_Channel *ch)
+{
+    // The receiver only spins locally in channel_receive(), so a sender cannot observe it
+    if (!ch->is_receiver)
+        return 1;
+
+    // Used to fetch current and latest sender rank
+    int senders[2];
+
+    // Lock window of all procs of communicator (lock type is shared)
+    if (MPI_Win_lock_all(0, ch->win) != MPI_SUCCESS)
+    {
+        ERROR("Error in MPI_Win_lock_all()\n");
+        return -1;
+    }
+
+    // Atomically read current and latest sender rank; a sender registers itself in latest sender before sending
+    if (MPI_Get_accumulate(NULL, 0, MPI_INT, senders, 2, MPI_INT, ch->receiver_ranks[0], 0, 2, MPI_INT, MPI_NO_OP, 
+    ch->win) != MPI_SUCCESS)
+    {
+        ERROR("Error in MPI_Get_accumulate()\n");
+        return -1;
+    }
+
+    // Unlock window again
+    if (MPI_Win_unlock_all(ch->win) != MPI_SUCCESS)
+    {
+        ERROR("Error in MPI_Win_unlock_all()\n");
+        return -1;
+    }
+
+    return senders[CURRENT_SENDER] != -1 || senders[LATEST_SENDER] != -1 ? 1 : 0;
+}
+
 int channel_free_rma_mpsc_sync(MPI_Channel *ch) 
 {
     // Free allocated memory used for storing ranks
@@ -71,6 +71,16 @@ int channel_send_rma_mpsc_sync(MPI_Channel *ch, void *data);
  */
 int channel_receive_rma_mpsc_sync(MPI_Channel *ch, void *data);
 
+/**
+ * @brief Peeks at the channel and signals if a matching sender is waiting. The receiver process reads the current and
+ * latest sender rank of its window. Since the receiver does not announce itself a sender process always gets 1.
+ * @param[in] ch Pointer to a MPI_Channel of type RMA MPSC SYNC
+ * @return Returns 1 if a sender holds or waits for the sender lock (receiver process calls) or a sender process calls,
+ * 0 otherwise and -1 if an error occured
+ * @note Returns -1 if internal problems with MPI related functions happend
+ */
+int channel_peek_rma_mpsc_sync(MPI_Channel *ch);
+
 /**
  * @brief Deallocates the channel and all allocated members
  * @param[in, out] ch Pointer to a MPI_Channel of type RMA MPSC SYNC                 
@@ -22,7 +22,7 @@ MPI_Channel *channel_alloc_rma_spsc_buf(MPI_Channel *ch)
 
     // Create shadow comm and store it
     // Should be nothrow
-    if (MPI_Comm_dup(ch->comm, &ch->comm) != MPI_SUCCESS)
+    if (channel_comm_dup(ch, &ch->comm) != MPI_SUCCESS)
     {
         ERROR("Error in MPI_Comm_dup(): Fatal Error\n");
         free(ch->receiver_ranks);
@@ -47,7 +47,7 @@ MPI_Channel *channel_alloc_rma_spsc_buf(MPI_Channel *ch)
         }
 
         // Create window object with allocated window memory
-        if (MPI_Win_create(ch->win_lmem, 2 * sizeof(int) + (ch->capacity+1) * ch->data_size, 1, MPI_INFO_NULL, ch->comm,
+        if (MPI_Win_create(ch->win_lmem, 2 * sizeof(int) + (ch->capacity+1) * ch->data_size, 1, ch->info, ch->comm,
          &ch->win) != MPI_SUCCESS)
         {
             ERROR("Error in MPI_Win_create()\n");
@@ -73,7 +73,7 @@ MPI_Channel *channel_alloc_rma_spsc_buf(MPI_Channel *ch)
         }
 
         // Create a window for the indices
-        if (MPI_Win_create(ch->win_lmem, 2 * sizeof(int), 1, MPI_INFO_NULL, ch->comm, &ch->win) != MPI_SUCCESS)
+        if (MPI_Win_create(ch->win_lmem, 2 * sizeof(int), 1, ch->info, ch->comm, &ch->win) != MPI_SUCCESS)
         {
             ERROR("Error in MPI_Win_create()\n");
             MPI_Free_mem(ch->win_lmem);
@@ -104,6 +104,43 @@ MPI_Channel *channel_alloc_rma_spsc_buf(MPI_Channel *ch)
     return ch;
 }
 
+// Puts the element into the ring buffer of the receiver; needs a free slot and an open access epoch
+static int put_rma_spsc_buf(MPI_Channel *ch, void *data)
+{
+    // Store pointer to local indices
+    int *index = ch->win_lmem;
+
+    // Send data to the target window at the base address + write position times data size
+    if (MPI_Put(data, ch->data_size, MPI_BYTE, ch->receiver_ranks[0], DATA_DISP + index[1] * ch->data_size, ch->data_size, 
+    MPI_BYTE, ch->win) != MPI_SUCCESS)
+    {
+        ERROR("Error in MPI_Put()\n");
+        return -1;
+    }
+
+    // Ensure completion of data transfer with MPI_Put
+    // Needs to be done before the write index is updated
+    if (MPI_Win_flush(ch->receiver_ranks[0], ch->win) != MPI_SUCCESS)
+    {
+        ERROR("Error in MPI_Win_flush()\n");
+        return -1;
+    }
+
+    // Increment index to let it point to the write index
+    // Then update write index depending on its position (0 if end of queue, +1 otherwise)
+    *++index == ch->capacity ? *index = 0 : (*index)++;
+
+    // Send updated write index with atomic put
+    if (MPI_Accumulate(index, sizeof(int), MPI_BYTE, ch->receiver_ranks[0], sizeof(int), sizeof(int), MPI_BYTE, MPI_REPLACE,
+     ch->win) != MPI_SUCCESS)
+    {
+        ERROR("Error in MPI_Accumulate()\n");
+        return -1;
+    }
+
+    return 1;
+}
+
 int channel_send_rma_spsc_buf(MPI_Channel *ch, void *data)
 {
     // Store pointer to local indices
@@ -128,34 +165,46 @@ int channel_send_rma_spsc_buf(MPI_Channel *ch, void *data)
         }
     }
 
-    // Send data to the target window at the base address + write position times data size
-    if (MPI_Put(data, ch->data_size, MPI_BYTE, ch->receiver_ranks[0], DATA_DISP + index[1] * ch->data_size, ch->data_size, 
-    MPI_BYTE, ch->win) != MPI_SUCCESS)
+    // Put data into the ring buffer and update write index
+    if (put_rma_spsc_buf(ch, data) != 1)
+        return -1;
+
+    // Returns when MPI_Puts completed
+    if (MPI_Win_unlock_all(ch->win) != MPI_SUCCESS)
     {
-        ERROR("Error in MPI_Put()\n");
+        ERROR("Error in MPI_Win_unlock_all(): Channel might be broken\n");
         return -1;
     }
 
-    // Ensure completion of data transfer with MPI_Put
-    // Needs to be done before the write index is updated
-    if (MPI_Win_flush(ch->receiver_ranks[0], ch->win) != MPI_SUCCESS)
+    return 1;
+}
+
+int channel_trysend_rma_spsc_buf(MPI_Channel *ch, void *data)
+{
+    // Store pointer to local indices
+    int *index = ch->win_lmem;
+
+    // Register with the windows, locktype is shared
+    if (MPI_Win_lock_all(0, ch->win) != MPI_SUCCESS)
     {
-        ERROR("Error in MPI_Win_flush()\n");
+        ERROR("Error in MPI_Win_lock_all()\n");
         return -1;
     }
 
-    // Increment index to let it point to the write index
-    // Then update write index depending on its position (0 if end of queue, +1 otherwise)
-    *++index == ch->capacity ? *index = 0 : (*index)++;
-
-    // Send updated write index with atomic put
-    if (MPI_Accumulate(index, sizeof(int), MPI_BYTE, ch->receiver_ranks[0], sizeof(int), sizeof(int), MPI_BYTE, MPI_REPLACE,
-     ch->win) != MPI_SUCCESS)
+    // Ensure that memory is updated
+    if (MPI_Win_sync(ch->win)!= MPI_SUCCESS)
     {
-        ERROR("Error in MPI_Accumulate()\n");
+        ERROR("Error in MPI_Win_sync()\n");
         return -1;
     }
 
+    // Check if buffer is full
+    int full = (index[1] + 1 == index[0]) || ((index[1] == ch->capacity && (index[0] == 0)));
+
+    // Put data into the ring buffer and update write index if there is a free slot
+    if (!full && put_rma_spsc_buf(ch, data) != 1)
+        return -1;
+
     // Returns when MPI_Puts completed
     if (MPI_Win_unlock_all(ch->win) != MPI_SUCCESS)
     {
@@ -163,7 +212,7 @@ int channel_send_rma_spsc_buf(MPI_Channel *ch, void *data)
         return -1;
     }
 
-    return 1;
+    return !full;
 }
 
 int channel_receive_rma_spsc_buf(MPI_Channel *ch, void *data)
@@ -29,7 +29,7 @@ MPI_Channel *channel_alloc_rma_spsc_sync(MPI_Channel *ch)
         }
 
         // Initiate win object with allocated memory, capacity, displacement of 1 and communicator
-        if (MPI_Win_create(ch->win_lmem, ch->data_size, 1, MPI_INFO_NULL, ch->comm, &ch->win) != MPI_SUCCESS)
+        if (MPI_Win_create(ch->win_lmem, ch->data_size, 1, ch->info, ch->comm, &ch->win) != MPI_SUCCESS)
         {
             ERROR("Error in MPI_Win_create()\n");
             free(ch->receiver_ranks);
@@ -44,7 +44,7 @@ MPI_Channel *channel_alloc_rma_spsc_sync(MPI_Channel *ch)
     else
     {
         // Producer does not expose memory to the window
-        if (MPI_Win_create(NULL, 0, 1, MPI_INFO_NULL, ch->comm, &ch->win) != MPI_SUCCESS)
+        if (MPI_Win_create(NULL, 0, 1, ch->info, ch->comm, &ch->win) != MPI_SUCCESS)
         {
             ERROR("Error in MPI_Win_create()\n");
             free(ch->receiver_ranks);
@@ -63,7 +63,7 @@ MPI_Channel *channel_alloc_rma_spsc_sync(MPI_Channel *ch)
 
     // Create shadow comm and store it
     // Should be nothrow
-    if (MPI_Comm_dup(ch->comm, &ch->comm) != MPI_SUCCESS)
+    if (channel_comm_dup(ch, &ch->comm) != MPI_SUCCESS)
     {
         ERROR("Error in MPI_Comm_dup(): Fatal Error\n");
         free(ch->receiver_ranks);
@@ -0,0 +1,395 @@
+/**
+ * @file MPI_Taskpool.c
+ * @author Toni Hollfelder (Toni.Hollfelder@uni-bayreuth.de)
+ * @brief Implementation of a distributed work-stealing task pool
+ * @version 1.0
+ * @date 2021-05-29
+ * @copyright CC BY 4.0 (https://creativecommons.org/licenses/by/4.0/)
+ *
+ */
+
+#include <stdio.h>
+
+#include "MPI_Taskpool.h"
+#include "../MPI_Channel_Struct.h"
+
+#define TOP 0
+#define BOTTOM 1
+#define OUTSTANDING 2
+
+// Displacement of the counters and the slot of task index i; the slots follow the 16 bytes of counters back to back
+#define COUNTER_DISP(c) ((c) * sizeof(int))
+#define TASK_DISP(tp, i) (4 * sizeof(int) + (size_t) ((i) % (tp)->capacity) * (tp)->task_size)
+
+struct MPI_Taskpool {
+    size_t      task_size;              /** Size of each task */
+    int         capacity;               /** Number of tasks the deque of every process can hold */
+    MPI_Comm    comm;                   /** Shadow comm of the task pool */
+    int         comm_size;              /** Size of the communicator */
+    int         my_rank;                /** Rank of the calling process */
+    MPI_Win     win;                    /** Window exposing the deque of every process */
+    void        *win_lmem;              /** Local window memory */
+    int         bottom;                 /** Bottom index of the own deque; only the owner changes it */
+    int         credits;                /** Credits left for pushing tasks */
+    int         finished;               /** Number of finished tasks not yet returned to OUTSTANDING */
+    int         has_task;               /** Flag which signals that the last popped task is being processed */
+    int         started;                /** Flag which signals that taskpool_pop() has been called before */
+    unsigned    seed;                   /** State for choosing random victims */
+};
+
+// Reads a counter of the deque of rank atomically
+static int taskpool_get(MPI_Taskpool *tp, int rank, int counter, int *value)
+{
+    if (MPI_Get_accumulate(NULL, 0, MPI_INT, value, 1, MPI_INT, rank, COUNTER_DISP(counter), 1, MPI_INT, MPI_NO_OP, 
+    tp->win) != MPI_SUCCESS || MPI_Win_flush(rank, tp->win) != MPI_SUCCESS)
+    {
+        ERROR("Error in MPI_Get_accumulate()\n");
+        return -1;
+    }
+
+    return 1;
+}
+
+// Writes a counter of the own deque atomically
+static int taskpool_set(MPI_Taskpool *tp, int counter, int value)
+{
+    if (MPI_Accumulate(&value, 1, MPI_INT, tp->my_rank, COUNTER_DISP(counter), 1, MPI_INT, MPI_REPLACE, tp->win) != 
+    MPI_SUCCESS || MPI_Win_flush(tp->my_rank, tp->win) != MPI_SUCCESS)
+    {
+        ERROR("Error in MPI_Accumulate()\n");
+        return -1;
+    }
+
+    return 1;
+}
+
+// Advances the top index of the deque of rank from top to top + 1; returns 1 if this process has taken the task
+static int taskpool_take(MPI_Taskpool *tp, int rank, int top)
+{
+    int next = top + 1, result;
+
+    if (MPI_Compare_and_swap(&next, &top, &result, MPI_INT, rank, COUNTER_DISP(TOP), tp->win) != MPI_SUCCESS || 
+    MPI_Win_flush(rank, tp->win) != MPI_SUCCESS)
+    {
+        ERROR("Error in MPI_Compare_and_swap()\n");
+        return -1;
+    }
+
+    return result == top;
+}
+
+MPI_Taskpool *taskpool_alloc(size_t size, int capacity, MPI_Comm comm)
+{
+    // Check if MPI has been initialized, nothrow
+    int flag;
+    MPI_Initialized(&flag);
+
+    if (!flag) {
+        ERROR("MPI has not been initialized\n");
+        return NULL;
+    }
+
+    MPI_Taskpool *tp;
+    if ((tp = malloc(sizeof(*tp))) == NULL)
+    {
+        ERROR("Error in malloc(): Memory for MPI_Taskpool could not be allocated\n");
+        channel_alloc_assert_success(comm, 1);
+        return NULL;
+    }
+
+    // Store size of the communicator and rank, first function call with a commumincator might fail (MPI_ERR_COMM)
+    if (MPI_Comm_size(comm, &tp->comm_size) != MPI_SUCCESS || MPI_Comm_rank(comm, &tp->my_rank) != MPI_SUCCESS)
+    {
+        ERROR("Error in MPI_Comm_size(): Communicator might be invalid\n");
+        free(tp);
+        channel_alloc_assert_success(comm, 1);
+        return NULL;
+    }
+
+    if (size == 0 || capacity < 1)
+    {
+        ERROR("Task pools need a positive size and capacity\n");
+        free(tp);
+        channel_alloc_assert_success(comm, 1);
+        return NULL;
+    }
+
+    tp->task_size = size;
+    tp->capacity = capacity;
+    tp->bottom = 0;
+    tp->credits = tp->finished = 0;
+    tp->has_task = tp->started = 0;
+    tp->seed = 2654435761u * (tp->my_rank + 1);
+
+    // Create shadow comm and store it
+    // Should be nothrow
+    if (MPI_Comm_dup(comm, &tp->comm) != MPI_SUCCESS)
+    {
+        ERROR("Error in MPI_Comm_dup(): Fatal Error\n");
+        free(tp);
+        channel_alloc_assert_success(comm, 1);
+        return NULL;
+    }
+
+    MPI_Aint win_size = TASK_DISP(tp, capacity - 1) + size;
+
+    // Allocate memory for the counters and the deque
+    if (MPI_Alloc_mem(win_size, MPI_INFO_NULL, &tp->win_lmem) != MPI_SUCCESS)
+    {
+        ERROR("Error in MPI_Alloc_mem()\n");
+        MPI_Comm_free(&tp->comm);
+        free(tp);
+        channel_alloc_assert_success(comm, 1);
+        return NULL;
+    }
+
+    // Top, bottom and outstanding tasks start at 0
+    memset(tp->win_lmem, 0, 4 * sizeof(int));
+
+    // Create window object with allocated window memory
+    if (MPI_Win_create(tp->win_lmem, win_size, 1, MPI_INFO_NULL, tp->comm, &tp->win) != MPI_SUCCESS)
+    {
+        ERROR("Error in MPI_Win_create()\n");
+        MPI_Free_mem(tp->win_lmem);
+        MPI_Comm_free(&tp->comm);
+        free(tp);
+        channel_alloc_assert_success(comm, 1);
+        return NULL;
+    }
+
+    // Lock window of all procs of communicator (lock type is shared) for the lifetime of the task pool
+    if (MPI_Win_lock_all(0, tp->win) != MPI_SUCCESS)
+    {
+        ERROR("Error in MPI_Win_lock_all()\n");
+        MPI_Win_free(&tp->win);
+        MPI_Free_mem(tp->win_lmem);
+        MPI_Comm_free(&tp->comm);
+        free(tp);
+        channel_alloc_assert_success(comm, 1);
+        return NULL;
+    }
+
+    // Final call to assure that every process was successfull
+    if (channel_alloc_assert_success(comm, 0) != 1)
+    {
+        ERROR("Error in finalizing task pool allocation: At least one process failed\n");
+        MPI_Win_unlock_all(tp->win);
+        MPI_Win_free(&tp->win);
+        MPI_Free_mem(tp->win_lmem);
+        MPI_Comm_free(&tp->comm);
+        free(tp);
+        return NULL;
+    }
+
+    DEBUG("Task pool finished allocation\n");
+
+    return tp;
+}
+
+int taskpool_push(MPI_Taskpool *tp, void *task)
+{
+    int top;
+
+    // Assert that task pool and task are not NULL
+    if (tp == NULL || task == NULL)
+    {
+        WARNING("Task pool or task is NULL\n");
+        return -1;
+    }
+
+    // Check for a free slot; thieves only increase top, so the deque can only get emptier
+    if (taskpool_get(tp, tp->my_rank, TOP, &top) == -1)
+        return -1;
+
+    if (tp->bottom - top >= tp->capacity)
+        return 0;
+
+    // Every task needs a credit before it can be stolen
+    if (tp->credits == 0)
+    {
+        int credits = TASKPOOL_CREDITS, outstanding;
+
+        if (MPI_Fetch_and_op(&credits, &outstanding, MPI_INT, 0, COUNTER_DISP(OUTSTANDING), MPI_SUM, tp->win) != 
+        MPI_SUCCESS || MPI_Win_flush(0, tp->win) != MPI_SUCCESS)
+        {
+            ERROR("Error in MPI_Fetch_and_op()\n");
+            return -1;
+        }
+
+        tp->credits = credits;
+    }
+
+    // Store task in its slot and make it visible to thieves before publishing the new bottom
+    memcpy((char *) tp->win_lmem + TASK_DISP(tp, tp->bottom), task, tp->task_size);
+
+    if (MPI_Win_sync(tp->win) != MPI_SUCCESS)
+    {
+        ERROR("Error in MPI_Win_sync()\n");
+        return -1;
+    }
+
+    if (taskpool_set(tp, BOTTOM, tp->bottom + 1) == -1)
+        return -1;
+
+    tp->bottom++;
+    tp->credits--;
+
+    return 1;
+}
+
+// Pops a task from the bottom of the own deque; returns 1 if a task has been popped and 0 if the deque is empty
+static int taskpool_pop_local(MPI_Taskpool *tp, void *task)
+{
+    int top, bottom = tp->bottom - 1;
+
+    // Reserve the bottom task before reading top; thieves which read the old bottom afterwards compete for top
+    if (taskpool_set(tp, BOTTOM, bottom) == -1 || taskpool_get(tp, tp->my_rank, TOP, &top) == -1)
+        return -1;
+
+    // Deque is empty; restore bottom
+    if (top > bottom)
+        return taskpool_set(tp, BOTTOM, tp->bottom) == -1 ? -1 : 0;
+
+    memcpy(task, (char *) tp->win_lmem + TASK_DISP(tp, bottom), tp->task_size);
+
+    // More than one task left, no thief can reach the bottom task
+    if (top < bottom)
+    {
+        tp->bottom = bottom;
+        return 1;
+    }
+
+    // Last task; compete with thieves for it and leave an empty deque either way
+    int taken = taskpool_take(tp, tp->my_rank, top);
+
+    if (taken == -1 || taskpool_set(tp, BOTTOM, top + 1) == -1)
+        return -1;
+
+    tp->bottom = top + 1;
+
+    return taken;
+}
+
+// Steals a task from the top of the deque of victim; returns 1 if a task has been stolen and 0 otherwise
+static int taskpool_steal(MPI_Taskpool *tp, int victim, void *task)
+{
+    int top, bottom;
+
+    if (taskpool_get(tp, victim, TOP, &top) == -1 || taskpool_get(tp, victim, BOTTOM, &bottom) == -1)
+        return -1;
+
+    // Deque of the victim is empty
+    if (top >= bottom)
+        return 0;
+
+    // Read task before taking it; the slot is not reused as long as top has not moved
+    if (MPI_Get(task, tp->task_size, MPI_BYTE, victim, TASK_DISP(tp, top), tp->task_size, MPI_BYTE, tp->win) != 
+    MPI_SUCCESS || MPI_Win_flush(victim, tp->win) != MPI_SUCCESS)
+    {
+        ERROR("Error in MPI_Get()\n");
+        return -1;
+    }
+
+    return taskpool_take(tp, victim, top);
+}
+
+int taskpool_pop(MPI_Taskpool *tp, void *task)
+{
+    int result;
+
+    // Assert that task pool and task are not NULL
+    if (tp == NULL || task == NULL)
+    {
+        WARNING("Task pool or task is NULL\n");
+        return -1;
+    }
+
+    // Every process pushes its initial tasks before the first process might find the task pool empty
+    if (!tp->started)
+    {
+        if (MPI_Barrier(tp->comm) != MPI_SUCCESS)
+        {
+            ERROR("Error in MPI_Barrier()\n");
+            return -1;
+        }
+        tp->started = 1;
+    }
+
+    // Tasks spawned by the previous task have been pushed by now
+    if (tp->has_task)
+    {
+        tp->finished++;
+        tp->has_task = 0;
+    }
+
+    // Prefer tasks of the own deque
+    if ((result = taskpool_pop_local(tp, task)) != 0)
+    {
+        tp->has_task = result == 1;
+        return result;
+    }
+
+    while (1)
+    {
+        // Try a random victim for every other process
+        for (int i = 1; i < tp->comm_size; i++)
+        {
+            tp->seed = tp->seed * 1103515245u + 12345u;
+            int victim = (tp->my_rank + 1 + (tp->seed >> 8) % (tp->comm_size - 1)) % tp->comm_size;
+
+            if ((result = taskpool_steal(tp, victim, task)) != 0)
+            {
+                tp->has_task = result == 1;
+                return result;
+            }
+        }
+
+        // Return unused credits and finished tasks and check if any task is left
+        int returned = -(tp->credits + tp->finished), outstanding;
+
+        if (MPI_Fetch_and_op(&returned, &outstanding, MPI_INT, 0, COUNTER_DISP(OUTSTANDING), MPI_SUM, tp->win) != 
+        MPI_SUCCESS || MPI_Win_flush(0, tp->win) != MPI_SUCCESS)
+        {
+            ERROR("Error in MPI_Fetch_and_op()\n");
+            return -1;
+        }
+
+        tp->credits = tp->finished = 0;
+
+        if (outstanding + returned == 0)
+            return 0;
+    }
+}
+
+int taskpool_free(MPI_Taskpool *tp)
+{
+    // Assert that task pool is not NULL
+    if (tp == NULL)
+    {
+        WARNING("Task pool is NULL\n");
+        return -1;
+    }
+
+    // Unlock window again
+    if (MPI_Win_unlock_all(tp->win) != MPI_SUCCESS)
+    {
+        ERROR("Error in MPI_Win_unlock_all()\n");
+        return -1;
+    }
+
+    // Frees window
+    // Should be nothrow since window object was created successfully
+    MPI_Win_free(&tp->win);
+
+    // Frees window memory
+    // Should be nothrow since window memory was allcoated successfully
+    MPI_Free_mem(tp->win_lmem);
+
+    // Frees shadow communicator
+    // Should be nothrow since shadow comm duplication was successful
+    MPI_Comm_free(&tp->comm);
+
+    free(tp);
+
+    return 1;
+}
@@ -0,0 +1,82 @@
+/**
+ * @file MPI_Taskpool.h
+ * @author Toni Hollfelder (Toni.Hollfelder@uni-bayreuth.de)
+ * @brief Header of a distributed work-stealing task pool
+ * @version 1.0
+ * @date 2021-05-29
+ * @copyright CC BY 4.0 (https://creativecommons.org/licenses/by/4.0/)
+ *
+ * Using a RMA MPMC BUF channel as global task queue serialises every dequeue through the receiver lock and the queue
+ * at the first receiver. Instead every process of a task pool owns a deque of tasks in its window (Chase-Lev deque).
+ * The owner pushes and pops tasks at the bottom of its deque with atomic operations on its own window only. A process
+ * whose deque is empty steals a task from the top of the deque of a random victim with MPI_Compare_and_swap().
+ *
+ * Layout of local window memory of every process:
+ * Process:     | TOP | BOTTOM | OUTSTANDING | TASK_0 | ... | TASK_N |      where N + 1 is the capacity
+ * OUTSTANDING is only used at the first process.
+ *
+ * Termination is detected by credits: a process takes TASKPOOL_CREDITS credits from OUTSTANDING at the first process
+ * once it has used up its credits and every pushed task uses up a credit. A process which can neither pop nor steal a
+ * task returns its unused credits and the number of tasks it has finished. Once OUTSTANDING is 0 no task is left in
+ * any deque or being processed and taskpool_pop() returns 0 on every process.
+ *
+ * The window is locked for the whole lifetime of the task pool, every operation only flushes.
+ */
+
+#ifndef MPI_TASKPOOL_H
+#define MPI_TASKPOOL_H
+
+#include "../MPI_Channel.h"
+
+// Number of credits a process takes from the first process at once
+#define TASKPOOL_CREDITS 64
+
+typedef struct MPI_Taskpool MPI_Taskpool;
+
+/**
+ * @brief Allocates and returns a task pool. Every process of the communicator needs to call this function
+ *
+ * @param size The size of each task
+ * @param capacity The number of tasks the deque of every process can hold; needs to be positive
+ * @param comm The communicator of the processes sharing the task pool
+ *
+ * @return Returns a pointer to a MPI_Taskpool if allocation was successfull, NULL otherwise
+ */
+MPI_Taskpool *taskpool_alloc(size_t size, int capacity, MPI_Comm comm);
+
+/**
+ * @brief Pushes a task to the bottom of the deque of the calling process. Calling taskpool_push() never blocks
+ *
+ * @param[in] tp Pointer to a MPI_Taskpool allocated with taskpool_alloc()
+ * @param[in] task Pointer to a memory adress of which size bytes will be pushed from
+ *
+ * @return Returns 1 if the task has been pushed, 0 if the deque is full and -1 if an error occures
+ *
+ * @note Tasks may be pushed before the first call of taskpool_pop() and while processing a popped task
+ */
+int taskpool_push(MPI_Taskpool *tp, void *task);
+
+/**
+ * @brief Pops a task from the bottom of the deque of the calling process or steals one from a random victim if the
+ * deque is empty. Calling taskpool_pop() blocks until a task is available or every task has been processed. The
+ * previously popped task counts as finished, so tasks spawned while processing it need to be pushed before
+ *
+ * @param[in] tp Pointer to a MPI_Taskpool allocated with taskpool_alloc()
+ * @param[out] task Pointer to a memory adress of which size bytes will be popped to
+ *
+ * @return Returns 1 if a task has been popped, 0 if every task has been processed and -1 if an error occures
+ *
+ * @warning The first call of taskpool_pop() is collective, so every process can push its initial tasks before
+ */
+int taskpool_pop(MPI_Taskpool *tp, void *task);
+
+/**
+ * @brief Deallocates the task pool. Every process of the communicator needs to call this function
+ *
+ * @param[in, out] tp Pointer to a MPI_Taskpool allocated with taskpool_alloc()
+ *
+ * @return Returns 1 if deallocation was successfull and -1 if an error occures
+ */
+int taskpool_free(MPI_Taskpool *tp);
+
+#endif // MPI_TASKPOOL_H
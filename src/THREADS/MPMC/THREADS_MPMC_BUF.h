@@ -0,0 +1,67 @@
+/**
+ * @file THREADS_MPMC_BUF.h
+ * @author Toni Hollfelder (Toni.Hollfelder@uni-bayreuth.de)
+ * @brief Header of THREADS MPMC BUF Channel
+ * @version 1.0
+ * @date 2021-05-30
+ * @copyright CC BY 4.0 (https://creativecommons.org/licenses/by/4.0/)
+ * 
+ * This THREADS MPMC BUF channel implementation connects multiple sender and receiver threads of the same process with 
+ * a bounded ring in the memory of the process (Vyukov). No MPI function is called. Every slot starts with a sequence 
+ * number which tells the position the slot can be used for next: a slot is free for the sender of position pos if its 
+ * sequence number is 2 * pos and holds the element of position pos if it is 2 * pos + 1, which keeps both states
+ * apart even for a ring with a single slot. Senders claim a position with a 
+ * compare-and-swap on the tail and receivers with a compare-and-swap on the head; afterwards every thread accesses its
+ * slot without contention and hands the slot over by storing the next sequence number. Senders and receivers only 
+ * contend on their own index.
+ * 
+ * Regarding progress guarantees this implementation is lock-free as long as the ring is neither empty nor full.
+ */
+
+#ifndef THREADS_MPMC_BUF_H
+#define THREADS_MPMC_BUF_H
+
+#include "../../MPI_Channel_Struct.h"
+
+/**
+ * @brief Updates the properties of a passed MPI_Channel of type THREADS MPMC BUF and returns it.
+ * @param[in, out] ch Pointer to a MPI_Channel allocated with channel_alloc_threads(). 
+ * @return Returns a pointer to a valid MPI_Channel with updated properties if updating was successful and NULL otherwise
+ * @note Returns NULL if memory allocation failed.
+ */
+MPI_Channel *channel_alloc_threads_mpmc_buf(MPI_Channel *ch);
+
+/**
+ * @brief Sends the numbers of bytes of a data element specified in channel_alloc_threads() starting at the adress the 
+ * void pointer holds into the channel. Calling channel_send_threads_mpmc_buf() blocks only if the ring is full.
+ * @param[in] ch Pointer to a MPI_Channel of type THREADS MPMC BUF.              
+ * @param[in] data Pointer to a memory adress of which size bytes will be sent from.
+ * @return Returns 1 since sending cannot fail.
+ */
+int channel_send_threads_mpmc_buf(MPI_Channel *ch, void *data);
+
+/**
+ * @brief Receives the numbers of bytes of a data element specified in channel_alloc_threads() from the channel and 
+ * stores them starting at the adress the void pointer holds. Calling channel_receive_threads_mpmc_buf() blocks only if 
+ * the ring is empty.
+ * @param[in] ch Pointer to a MPI_Channel of type THREADS MPMC BUF.              
+ * @param[in] data Pointer to a memory adress of which size bytes will be received to.
+ * @return Returns 1 since receiving cannot fail.
+ */
+int channel_receive_threads_mpmc_buf(MPI_Channel *ch, void *data);
+
+/**
+ * @brief Peeks at the channel and returns the number of published elements.
+ * @param[in] ch Pointer to a MPI_Channel of type THREADS MPMC BUF.
+ * @return Returns the number of published elements a receiver can take in order without blocking.
+ */
+int channel_peek_threads_mpmc_buf(MPI_Channel *ch);
+
+/**
+ * @brief Deallocates the channel and all allocated members.
+ * @param[in] ch Pointer to a MPI_Channel of type THREADS MPMC BUF.
+ * @return Returns 1 since deallocation is always successfull
+ */
+int channel_free_threads_mpmc_buf(MPI_Channel *ch);
+
+#endif // THREADS_MPMC_BUF_H
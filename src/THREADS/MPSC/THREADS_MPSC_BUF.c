@@ -0,0 +1,135 @@
+/**
+ * @file THREADS_MPSC_BUF.c
+ * @author Toni Hollfelder (Toni.Hollfelder@uni-bayreuth.de)
+ * @brief Implementation of THREADS MPSC BUF Channel
+ * @version 1.0
+ * @date 2021-05-30
+ * @copyright CC BY 4.0 (https://creativecommons.org/licenses/by/4.0/)
+ */
+
+#include <sched.h> /* sched_yield */
+#include <stdint.h> /* intptr_t */
+#include <stdio.h>
+#include <stdlib.h> /* aligned_alloc */
+
+#include "THREADS_MPSC_BUF.h"
+
+#define SLOT(ring, pos, capacity) ((ring)->slots + ((pos) % (size_t) (capacity)) * (ring)->slot_size)
+#define SEQ(slot) ((atomic_size_t *) (slot))
+
+// Sequence numbers of a slot which is free for the sender of position pos or holds the element of position pos; they
+// differ from each other for every capacity including 1
+#define FREE(pos) (2 * (pos))
+#define FULL(pos) (2 * (pos) + 1)
+
+MPI_Channel *channel_alloc_threads_mpsc_buf(MPI_Channel *ch)
+{
+    // Store type of channel
+    ch->chan_type = MPSC;
+
+    // Slots hold the sequence number followed by the element; the size of the ring is rounded up to a multiple of the 
+    // alignment
+    size_t slot_size = (sizeof(atomic_size_t) + ch->data_size + alignof(atomic_size_t) - 1) / alignof(atomic_size_t) 
+    * alignof(atomic_size_t);
+    size_t ring_size = (sizeof(MPI_Channel_ring) + ch->capacity * slot_size + 63) / 64 * 64;
+
+    if ((ch->ring = aligned_alloc(64, ring_size)) == NULL)
+    {
+        ERROR("Error in aligned_alloc(): Memory for ring could not be allocated\n");
+        free(ch);
+        return NULL;
+    }
+
+    atomic_init(&ch->ring->head, 0);
+    atomic_init(&ch->ring->tail, 0);
+    ch->ring->cached_head = ch->ring->cached_tail = 0;
+    ch->ring->slot_size = slot_size;
+
+    // The slot of position i is free for the sender of position i
+    for (int i = 0; i < ch->capacity; i++)
+        atomic_init(SEQ(SLOT(ch->ring, i, ch->capacity)), FREE((size_t) i));
+
+    DEBUG("THREADS MPSC BUF finished allocation\n");
+
+    return ch;
+}
+
+int channel_send_threads_mpsc_buf(MPI_Channel *ch, void *data)
+{
+    MPI_Channel_ring *ring = ch->ring;
+    size_t pos = atomic_load_explicit(&ring->tail, memory_order_relaxed);
+    char *slot;
+
+    // Claim a free position
+    while (1)
+    {
+        slot = SLOT(ring, pos, ch->capacity);
+        intptr_t diff = (intptr_t) atomic_load_explicit(SEQ(slot), memory_order_acquire) - (intptr_t) FREE(pos);
+
+        // Slot is free; claim the position unless another sender was faster
+        if (diff == 0)
+        {
+            if (atomic_compare_exchange_weak_explicit(&ring->tail, &pos, pos + 1, memory_order_relaxed, 
+            memory_order_relaxed))
+                break;
+        }
+        // Ring is full; wait for a receiver
+        else if (diff < 0)
+        {
+            sched_yield();
+            pos = atomic_load_explicit(&ring->tail, memory_order_relaxed);
+        }
+        // Another sender claimed the position
+        else
+            pos = atomic_load_explicit(&ring->tail, memory_order_relaxed);
+    }
+
+    memcpy(slot + sizeof(atomic_size_t), data, ch->data_size);
+
+    // Publish element
+    atomic_store_explicit(SEQ(slot), FULL(pos), memory_order_release);
+
+    return 1;
+}
+
+int channel_receive_threads_mpsc_buf(MPI_Channel *ch, void *data)
+{
+    MPI_Channel_ring *ring = ch->ring;
+    size_t pos = atomic_load_explicit(&ring->head, memory_order_relaxed);
+    char *slot = SLOT(ring, pos, ch->capacity);
+
+    // Wait until the element of the head position has been published
+    while (atomic_load_explicit(SEQ(slot), memory_order_acquire) != FULL(pos))
+        sched_yield();
+
+    memcpy(data, slot + sizeof(atomic_size_t), ch->data_size);
+
+    // Free slot for the sender of the position in the next round and advance head
+    atomic_store_explicit(SEQ(slot), FREE(pos + ch->capacity), memory_order_release);
+    atomic_store_explicit(&ring->head, pos + 1, memory_order_release);
+
+    return 1;
+}
+
+int channel_peek_threads_mpsc_buf(MPI_Channel *ch)
+{
+    size_t head = atomic_load_explicit(&ch->ring->head, memory_order_acquire);
+    int published = 0;
+
+    // Count the published elements from the head position on; a claimed position whose element has not been published
+    // yet blocks the receiver of the position, so counting stops there
+    while (published < ch->capacity && atomic_load_explicit(SEQ(SLOT(ch->ring, head + published, ch->capacity)), 
+    memory_order_acquire) == FULL(head + published))
+        published++;
+
+    return published;
+}
+
+int channel_free_threads_mpsc_buf(MPI_Channel *ch)
+{
+    free(ch->ring);
+    free(ch);
+    ch = NULL;
+
+    return 1;
+}
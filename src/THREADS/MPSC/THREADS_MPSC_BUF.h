@@ -0,0 +1,69 @@
+/**
+ * @file THREADS_MPSC_BUF.h
+ * @author Toni Hollfelder (Toni.Hollfelder@uni-bayreuth.de)
+ * @brief Header of THREADS MPSC BUF Channel
+ * @version 1.0
+ * @date 2021-05-30
+ * @copyright CC BY 4.0 (https://creativecommons.org/licenses/by/4.0/)
+ * 
+ * This THREADS MPSC BUF channel implementation connects multiple sender threads and a single receiver thread of the 
+ * same process with a bounded ring in the memory of the process (Vyukov). No MPI function is called. Every slot starts
+ * with a sequence number which tells the position the slot can be used for next: a slot is free for the sender of 
+ * position pos if its sequence number is 2 * pos and holds the element of position pos if it is 2 * pos + 1, which
+ * keeps both states apart even for a ring with a single slot. Senders claim a 
+ * position with a compare-and-swap on the tail, copy the element into the slot and publish it by storing 2 * pos + 1 
+ * as sequence number. The only receiver needs no compare-and-swap: it waits for the sequence number 2 * pos + 1 of the
+ * head position, copies the element and frees the slot for the position pos + capacity by storing 
+ * 2 * (pos + capacity).
+ * 
+ * Regarding progress guarantees the receiver is wait-free as long as the ring is not empty, senders are lock-free as 
+ * long as the ring is not full.
+ */
+
+#ifndef THREADS_MPSC_BUF_H
+#define THREADS_MPSC_BUF_H
+
+#include "../../MPI_Channel_Struct.h"
+
+/**
+ * @brief Updates the properties of a passed MPI_Channel of type THREADS MPSC BUF and returns it.
+ * @param[in, out] ch Pointer to a MPI_Channel allocated with channel_alloc_threads(). 
+ * @return Returns a pointer to a valid MPI_Channel with updated properties if updating was successful and NULL otherwise
+ * @note Returns NULL if memory allocation failed.
+ */
+MPI_Channel *channel_alloc_threads_mpsc_buf(MPI_Channel *ch);
+
+/**
+ * @brief Sends the numbers of bytes of a data element specified in channel_alloc_threads() starting at the adress the 
+ * void pointer holds into the channel. Calling channel_send_threads_mpsc_buf() blocks only if the ring is full.
+ * @param[in] ch Pointer to a MPI_Channel of type THREADS MPSC BUF.              
+ * @param[in] data Pointer to a memory adress of which size bytes will be sent from.
+ * @return Returns 1 since sending cannot fail.
+ */
+int channel_send_threads_mpsc_buf(MPI_Channel *ch, void *data);
+
+/**
+ * @brief Receives the numbers of bytes of a data element specified in channel_alloc_threads() from the channel and 
+ * stores them starting at the adress the void pointer holds. Calling channel_receive_threads_mpsc_buf() blocks only if 
+ * the ring is empty.
+ * @param[in] ch Pointer to a MPI_Channel of type THREADS MPSC BUF.              
+ * @param[in] data Pointer to a memory adress of which size bytes will be received to.
+ * @return Returns 1 since receiving cannot fail.
+ */
+int channel_receive_threads_mpsc_buf(MPI_Channel *ch, void *data);
+
+/**
+ * @brief Peeks at the channel and returns the number of published elements.
+ * @param[in] ch Pointer to a MPI_Channel of type THREADS MPSC BUF.
+ * @return Returns the number of published elements a receiver can take in order without blocking.
+ */
+int channel_peek_threads_mpsc_buf(MPI_Channel *ch);
+
+/**
+ * @brief Deallocates the channel and all allocated members.
+ * @param[in] ch Pointer to a MPI_Channel of type THREADS MPSC BUF.
+ * @return Returns 1 since deallocation is always successfull
+ */
+int channel_free_threads_mpsc_buf(MPI_Channel *ch);
+
+#endif // THREADS_MPSC_BUF_H
@@ -0,0 +1,107 @@
+/**
+ * @file THREADS_SPSC_BUF.c
+ * @author Toni Hollfelder (Toni.Hollfelder@uni-bayreuth.de)
+ * @brief Implementation of THREADS SPSC BUF Channel
+ * @version 1.0
+ * @date 2021-05-30
+ * @copyright CC BY 4.0 (https://creativecommons.org/licenses/by/4.0/)
+ */
+
+#include <sched.h> /* sched_yield */
+#include <stdio.h>
+#include <stdlib.h> /* aligned_alloc */
+
+#include "THREADS_SPSC_BUF.h"
+
+#define SLOT(ring, pos, capacity) ((ring)->slots + ((pos) % (size_t) (capacity)) * (ring)->slot_size)
+
+MPI_Channel *channel_alloc_threads_spsc_buf(MPI_Channel *ch)
+{
+    // Store type of channel
+    ch->chan_type = SPSC;
+
+    // Slots only hold the element; the size of the ring is rounded up to a multiple of the alignment
+    size_t slot_size = ch->data_size;
+    size_t ring_size = (sizeof(MPI_Channel_ring) + ch->capacity * slot_size + 63) / 64 * 64;
+
+    if ((ch->ring = aligned_alloc(64, ring_size)) == NULL)
+    {
+        ERROR("Error in aligned_alloc(): Memory for ring could not be allocated\n");
+        free(ch);
+        return NULL;
+    }
+
+    atomic_init(&ch->ring->head, 0);
+    atomic_init(&ch->ring->tail, 0);
+    ch->ring->cached_head = ch->ring->cached_tail = 0;
+    ch->ring->slot_size = slot_size;
+
+    DEBUG("THREADS SPSC BUF finished allocation\n");
+
+    return ch;
+}
+
+int channel_send_threads_spsc_buf(MPI_Channel *ch, void *data)
+{
+    MPI_Channel_ring *ring = ch->ring;
+    size_t tail = atomic_load_explicit(&ring->tail, memory_order_relaxed);
+
+    // Reload head only if the ring appears to be full
+    while (tail - ring->cached_head == (size_t) ch->capacity)
+    {
+        ring->cached_head = atomic_load_explicit(&ring->head, memory_order_acquire);
+
+        if (tail - ring->cached_head == (size_t) ch->capacity)
+            sched_yield();
+    }
+
+    memcpy(SLOT(ring, tail, ch->capacity), data, ch->data_size);
+
+    // Publish element
+    atomic_store_explicit(&ring->tail, tail + 1, memory_order_release);
+
+    return 1;
+}
+
+int channel_receive_threads_spsc_buf(MPI_Channel *ch, void *data)
+{
+    MPI_Channel_ring *ring = ch->ring;
+    size_t head = atomic_load_explicit(&ring->head, memory_order_relaxed);
+
+    // Reload tail only if the ring appears to be empty
+    while (head == ring->cached_tail)
+    {
+        ring->cached_tail = atomic_load_explicit(&ring->tail, memory_order_acquire);
+
+        if (head == ring->cached_tail)
+            sched_yield();
+    }
+
+    memcpy(data, SLOT(ring, head, ch->capacity), ch->data_size);
+
+    // Release slot
+    atomic_store_explicit(&ring->head, head + 1, memory_order_release);
+
+    return 1;
+}
+
+int channel_peek_threads_spsc_buf(MPI_Channel *ch)
+{
+    size_t head = atomic_load_explicit(&ch->ring->head, memory_order_acquire);
+    size_t tail = atomic_load_explicit(&ch->ring->tail, memory_order_acquire);
+
+    // Elements might have been received and sent in between
+    if (tail <= head)
+        return 0;
+
+    return tail - head > (size_t) ch->capacity ? ch->capacity : (int) (tail - head);
+}
+
+int channel_free_threads_spsc_buf(MPI_Channel *ch)
+{
+    free(ch->ring);
+    free(ch);
+    ch = NULL;
+
+    return 1;
+}
@@ -0,0 +1,67 @@
+/**
+ * @file THREADS_SPSC_BUF.h
+ * @author Toni Hollfelder (Toni.Hollfelder@uni-bayreuth.de)
+ * @brief Header of THREADS SPSC BUF Channel
+ * @version 1.0
+ * @date 2021-05-30
+ * @copyright CC BY 4.0 (https://creativecommons.org/licenses/by/4.0/)
+ * 
+ * This THREADS SPSC BUF channel implementation connects a single sender and a single receiver thread of the same 
+ * process with a circular buffer in the memory of the process. No MPI function is called. The sender only writes the 
+ * tail index and the receiver only writes the head index, so neither needs an atomic read-modify-write operation: an 
+ * element is published by storing the tail with release semantics after copying the element into its slot and a slot 
+ * is released by storing the head with release semantics after copying the element out of it. Each side keeps the last
+ * seen index of the other side and only reloads it if the ring appears to be full (sender) or empty (receiver), which 
+ * keeps the cache line of the other side untouched in the common case.
+ * 
+ * Regarding progress guarantees this implementation is wait-free under the requirement that the ring is neither empty 
+ * nor full.
+ */
+
+#ifndef THREADS_SPSC_BUF_H
+#define THREADS_SPSC_BUF_H
+
+#include "../../MPI_Channel_Struct.h"
+
+/**
+ * @brief Updates the properties of a passed MPI_Channel of type THREADS SPSC BUF and returns it.
+ * @param[in, out] ch Pointer to a MPI_Channel allocated with channel_alloc_threads(). 
+ * @return Returns a pointer to a valid MPI_Channel with updated properties if updating was successful and NULL otherwise
+ * @note Returns NULL if memory allocation failed.
+ */
+MPI_Channel *channel_alloc_threads_spsc_buf(MPI_Channel *ch);
+
+/**
+ * @brief Sends the numbers of bytes of a data element specified in channel_alloc_threads() starting at the adress the 
+ * void pointer holds into the channel. Calling channel_send_threads_spsc_buf() blocks only if the ring is full.
+ * @param[in] ch Pointer to a MPI_Channel of type THREADS SPSC BUF.              
+ * @param[in] data Pointer to a memory adress of which size bytes will be sent from.
+ * @return Returns 1 since sending cannot fail.
+ */
+int channel_send_threads_spsc_buf(MPI_Channel *ch, void *data);
+
+/**
+ * @brief Receives the numbers of bytes of a data element specified in channel_alloc_threads() from the channel and 
+ * stores them starting at the adress the void pointer holds. Calling channel_receive_threads_spsc_buf() blocks only if 
+ * the ring is empty.
+ * @param[in] ch Pointer to a MPI_Channel of type THREADS SPSC BUF.              
+ * @param[in] data Pointer to a memory adress of which size bytes will be received to.
+ * @return Returns 1 since receiving cannot fail.
+ */
+int channel_receive_threads_spsc_buf(MPI_Channel *ch, void *data);
+
+/**
+ * @brief Peeks at the channel and returns the number of buffered elements.
+ * @param[in] ch Pointer to a MPI_Channel of type THREADS SPSC BUF.
+ * @return Returns the number of elements in the ring.
+ */
+int channel_peek_threads_spsc_buf(MPI_Channel *ch);
+
+/**
+ * @brief Deallocates the channel and all allocated members.
+ * @param[in] ch Pointer to a MPI_Channel of type THREADS SPSC BUF.
+ * @return Returns 1 since deallocation is always successfull
+ */
+int channel_free_threads_spsc_buf(MPI_Channel *ch);
+
+#endif // THREADS_SPSC_BUF_H